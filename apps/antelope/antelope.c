@@ -41,6 +41,7 @@
 #include <stdio.h>
 
 #include "antelope.h"
+#include "storage.h"
 
 static db_output_function_t output = printf;
 
@@ -153,6 +154,44 @@ db_print_tuple(db_handle_t *handle)
   return DB_OK;
 }
 
+db_result_t
+db_print_plan(db_handle_t *handle)
+{
+  db_plan_t *plan;
+  index_t *index;
+
+  plan = &handle->plan;
+
+  switch(plan->method) {
+  case DB_PLAN_SCAN:
+    output("[plan = scan %s", handle->rel->name);
+    break;
+  case DB_PLAN_INDEX:
+  case DB_PLAN_INDEX_JOIN:
+    index = plan->attr->index;
+    output("[plan = %s %s.%s (%s)",
+           plan->method == DB_PLAN_INDEX ? "index" : "index join",
+           index->rel->name, plan->attr->name, index_get_name(index->type));
+    break;
+  case DB_PLAN_NESTED_LOOP_JOIN:
+    output("[plan = nested loop join %s.%s",
+           handle->right_rel->name, plan->attr->name);
+    break;
+  default:
+    output("[plan = none]\n");
+    return DB_OK;
+  }
+
+  output(", cost = %lu, rows = %lu]\n", plan->cost, (unsigned long)plan->rows);
+  return DB_OK;
+}
+
+db_result_t
+db_flush(void)
+{
+  return storage_flush(NULL);
+}
+
 int
 db_processing(db_handle_t *handle)
 {
@@ -147,3 +147,21 @@ aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
   return DB_OK;
 }
+
+db_result_t
+aql_set_group(aql_adt_t *adt, char *name)
+{
+  int i;
+
+  for(i = 0; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
+    if(adt->aggregators[i] == AQL_NONE &&
+       !(adt->attributes[i].flags & ATTRIBUTE_FLAG_NO_STORE) &&
+       strcmp(adt->attributes[i].name, name) == 0) {
+      adt->attributes[i].flags |= ATTRIBUTE_FLAG_GROUP;
+      AQL_SET_FLAG(adt, AQL_FLAG_AGGREGATE);
+      return DB_OK;
+    }
+  }
+
+  return DB_NAME_ERROR;
+}
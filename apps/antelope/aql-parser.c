@@ -494,6 +494,11 @@ PARSER(select)
   }
 
   NEXT;
+  if(TOKEN != WHERE && TOKEN != GROUP) {
+    REWIND;
+    RETURN(OK);
+  }
+
   if(TOKEN == WHERE) {
     lvm_reset(&p, vmcode, sizeof(vmcode));
 
@@ -502,12 +507,23 @@ PARSER(select)
     }
 
     AQL_SET_CONDITION(adt, &p);
-  } else {
-    REWIND;
-    RETURN(OK);
+    NEXT;
   }
 
-  CONSUME(END);
+  if(TOKEN == GROUP) {
+    CONSUME(BY);
+    CONSUME(IDENTIFIER);
+
+    /* The grouping attribute must be among the projected ones. */
+    if(DB_ERROR(AQL_SET_GROUP(adt, VALUE))) {
+      RETURN(SYNTAX_ERROR);
+    }
+    NEXT;
+  }
+
+  if(TOKEN != END) {
+    RETURN(SYNTAX_ERROR);
+  }
 
   return OK;
 }
@@ -645,6 +661,9 @@ PARSER_TOKEN(index_type)
   case MEMHASH:
     type = INDEX_MEMHASH;
     break;
+  case TIMESERIES:
+    type = INDEX_TIMESERIES;
+    break;
   default:
     return NONE;
   };
@@ -104,6 +104,9 @@ enum token {
   MEMHASH = 46,
   RELATION = 47,
   ATTRIBUTE = 48,
+  GROUP = 49,
+  BY = 50,
+  TIMESERIES = 51,
 
   INTEGER_VALUE = 251,
   FLOAT_VALUE = 252,
@@ -202,6 +205,7 @@ typedef struct aql_adt aql_adt_t;
   } while(0)  
 #define AQL_ATTRIBUTE_COUNT(adt)	((adt)->attribute_count)
 #define AQL_SET_CONDITION(adt, cond)	((adt)->lvm_instance = (cond))
+#define AQL_SET_GROUP(adt, attr)	aql_set_group((adt), (attr))
 #define AQL_ADD_VALUE(adt, domain, value)				\
     aql_add_value((adt), (domain), (value))
 
@@ -215,6 +219,7 @@ db_result_t aql_add_attribute(aql_adt_t *adt, char *name,
                                domain_t domain, unsigned element_size,
                                int processed_only);
 db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value);
+db_result_t aql_set_group(aql_adt_t *adt, char *name);
 db_result_t db_query(db_handle_t *handle, const char *format, ...);
 db_result_t db_process(db_handle_t *handle);
 
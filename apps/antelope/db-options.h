@@ -104,6 +104,28 @@
 #endif /* DB_MAX_ELEMENT_SIZE */
 
 
+/* The size of the read-ahead buffer used when reading tuples
+   sequentially. Preferably a multiple of the flash page size.
+   Set to 0 to read one tuple at a time. */
+#ifndef DB_STORAGE_READ_BUFFER_SIZE
+#define DB_STORAGE_READ_BUFFER_SIZE	128
+#endif /* DB_STORAGE_READ_BUFFER_SIZE */
+
+/* The size of the buffer in which inserted tuples are collected before
+   they are written to storage. Buffered tuples are written when the
+   buffer is full, when tuples are inserted into another relation, and
+   when calling db_flush(). Until then, they are lost if the node
+   reboots. Tuples of indexed relations are always written immediately.
+   Set to 0 to write each tuple immediately. */
+#ifndef DB_STORAGE_WRITE_BUFFER_SIZE
+#define DB_STORAGE_WRITE_BUFFER_SIZE	0
+#endif /* DB_STORAGE_WRITE_BUFFER_SIZE */
+
+/* The maximum number of groups in an aggregation query with GROUP BY. */
+#ifndef DB_GROUP_LIMIT
+#define DB_GROUP_LIMIT			8
+#endif /* DB_GROUP_LIMIT */
+
 /* The maximum size of the LVM bytecode compiled from a
    single database query. */
 #ifndef DB_VM_BYTECODE_SIZE
@@ -186,6 +208,23 @@
 #define DB_INDEX_COST			64
 #endif /* DB_INDEX_COST */
 
+/* The cost of reading a tuple out of order relative to reading the
+   next tuple in a sequential scan. Used by the query planner. */
+#ifndef DB_PLAN_RANDOM_ACCESS_COST
+#define DB_PLAN_RANDOM_ACCESS_COST	2
+#endif /* DB_PLAN_RANDOM_ACCESS_COST */
+
+/* The number of consecutive tuples summarized by each block of a
+   time-series index. A range search skips whole blocks. */
+#ifndef DB_TIMESERIES_BLOCK_SIZE
+#define DB_TIMESERIES_BLOCK_SIZE	32
+#endif /* DB_TIMESERIES_BLOCK_SIZE */
+
+/* The maximum number of time-series indexes. */
+#ifndef DB_TIMESERIES_INDEX_LIMIT
+#define DB_TIMESERIES_INDEX_LIMIT	1
+#endif /* DB_TIMESERIES_INDEX_LIMIT */
+
 /* The maximum number of hash table indexes. */
 #ifndef DB_MEMHASH_INDEX_LIMIT
 #define DB_MEMHASH_INDEX_LIMIT  	1
@@ -227,5 +266,22 @@
 #define LVM_USE_FLOATS			DB_FEATURE_FLOATS
 #endif /* LVM_USE_FLOATS */
 
+/* Compile predicates into a flat stack program that reads attribute
+   values directly from the tuples, instead of interpreting the
+   bytecode tree for each tuple. */
+#ifndef LVM_USE_COMPILER
+#define LVM_USE_COMPILER		1
+#endif /* LVM_USE_COMPILER */
+
+/* The maximum number of instructions in a compiled predicate. */
+#ifndef LVM_MAX_PROGRAM_LENGTH
+#define LVM_MAX_PROGRAM_LENGTH		24
+#endif /* LVM_MAX_PROGRAM_LENGTH */
+
+/* The maximum evaluation stack depth of a compiled predicate. */
+#ifndef LVM_MAX_STACK_DEPTH
+#define LVM_MAX_STACK_DEPTH		8
+#endif /* LVM_MAX_STACK_DEPTH */
+
 
 #endif /* !DB_OPTIONS_H */
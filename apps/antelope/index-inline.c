@@ -135,6 +135,10 @@ binary_search(index_iterator_t *index_iterator,
     if(db_value_to_long(target_value) > db_value_to_long(cmp_value)) {
       min = center + 1;
     } else {
+      if(center == 0) {
+        /* Avoid wrapping around the unsigned tuple ID. */
+        break;
+      }
       max = center - 1;
     }
   } while(min <= max &&
@@ -40,6 +40,7 @@
 
 #include "db-options.h"
 #include "index.h"
+#include "result.h"
 
 #define DEBUG DEBUG_NONE
 #include "net/ip/uip-debug.h"
@@ -66,26 +67,36 @@ index_api_t index_memhash = {
 
 struct hash_item {
   tuple_id_t tuple_id;
-  attribute_value_t value;
+  long key;
 };
 typedef struct hash_item hash_item_t;
 
 typedef hash_item_t hash_map_t[DB_MEMHASH_TABLE_SIZE];
 
+/*
+ * Collisions and duplicate keys are resolved by linear probing. An empty
+ * slot ends a probe sequence, whereas a slot whose item has been deleted
+ * is skipped by lookups but may be reused by later insertions.
+ */
+#define DELETED_TUPLE	(INVALID_TUPLE - 1)
+
 MEMB(hash_map_memb, hash_map_t, DB_MEMHASH_INDEX_LIMIT);
 
+/*
+ * Values are hashed by their numeric representation rather than by
+ * their in-memory layout, because the same key may arrive as an INT
+ * from a tuple and as a LONG from a query.
+ */
 static unsigned
-calculate_hash(attribute_value_t *value)
+calculate_hash(long key)
 {
-  unsigned char *cp, *end;
-  unsigned hash_value;
+  unsigned long hash_value;
+  int i;
 
-  cp = (unsigned char *)value;
-  end = cp + sizeof(*value);
   hash_value = 0;
-
-  while(cp < end) {
-    hash_value = hash_value * 33 + *cp++;
+  for(i = 0; i < sizeof(key); i++) {
+    hash_value = hash_value * 33 + ((unsigned long)key & 0xff);
+    key >>= 8;
   }
 
   return hash_value % DB_MEMHASH_TABLE_SIZE;
@@ -105,7 +116,7 @@ create(index_t *index)
   }
 
   for(i = 0; i < DB_MEMHASH_TABLE_SIZE; i++) {
-    hash_map[i]->tuple_id = INVALID_TUPLE;
+    (*hash_map)[i].tuple_id = INVALID_TUPLE;
   }
 
   index->opaque_data = hash_map;
@@ -137,15 +148,33 @@ static db_result_t
 insert(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
 {
   hash_map_t *hash_map;
+  hash_item_t *item;
   uint16_t hash_value;
+  uint16_t i;
+  long key;
 
   hash_map = index->opaque_data;
+  key = db_value_to_long(value);
+  hash_value = calculate_hash(key);
 
-  hash_value = calculate_hash(value);
-  hash_map[hash_value]->tuple_id = tuple_id;
-  hash_map[hash_value]->value = *value;
+  for(i = 0; i < DB_MEMHASH_TABLE_SIZE; i++) {
+    item = &(*hash_map)[(hash_value + i) % DB_MEMHASH_TABLE_SIZE];
+    if(item->tuple_id == INVALID_TUPLE || item->tuple_id == DELETED_TUPLE) {
+      item->tuple_id = tuple_id;
+      item->key = key;
+      PRINTF("DB: Inserted value %ld into the hash table\n", key);
+      return DB_OK;
+    }
+  }
 
-  PRINTF("DB: Inserted value %ld into the hash table\n", VALUE_LONG(value));
+  /*
+   * The table is full. Rather than refusing the tuple, we stop using the
+   * index: it no longer covers every tuple of the relation, so a lookup
+   * in it could miss matching rows.
+   */
+  PRINTF("DB: The hash table is full; disabling the index for %s.%s\n",
+         index->rel->name, index->attr->name);
+  index->flags |= INDEX_INCOMPLETE;
 
   return DB_OK;
 }
@@ -154,41 +183,59 @@ static db_result_t
 delete(index_t *index, attribute_value_t *value)
 {
   hash_map_t *hash_map;
+  hash_item_t *item;
   uint16_t hash_value;
+  uint16_t i;
+  long key;
 
   hash_map = index->opaque_data;
+  key = db_value_to_long(value);
+  hash_value = calculate_hash(key);
 
-  hash_value = calculate_hash(value);
-  if(memcmp(&hash_map[hash_value]->value, value, sizeof(*value)) != 0) {
-    return DB_INDEX_ERROR;
+  for(i = 0; i < DB_MEMHASH_TABLE_SIZE; i++) {
+    item = &(*hash_map)[(hash_value + i) % DB_MEMHASH_TABLE_SIZE];
+    if(item->tuple_id == INVALID_TUPLE) {
+      break;
+    }
+    if(item->tuple_id != DELETED_TUPLE && item->key == key) {
+      item->tuple_id = DELETED_TUPLE;
+      return DB_OK;
+    }
   }
 
-  hash_map[hash_value]->tuple_id = INVALID_TUPLE;
-  return DB_OK;
+  return DB_INDEX_ERROR;
 }
 
+/*
+ * Return the next tuple with the key of the iterator. The iterator's
+ * item number holds the number of slots probed so far, so the probe
+ * continues where the previous call found a matching item.
+ */
 static tuple_id_t
 get_next(index_iterator_t *iterator)
 {
   hash_map_t *hash_map;
+  hash_item_t *item;
   uint16_t hash_value;
-
-  if(iterator->next_item_no == 1) {
-    /* The memhash supports only unique values at the moment. */
-    return INVALID_TUPLE;
-  }
+  long key;
 
   hash_map = iterator->index->opaque_data;
-
-  hash_value = calculate_hash(&iterator->min_value);
-  if(memcmp(&hash_map[hash_value]->value, &iterator->min_value, sizeof(iterator->min_value)) != 0) {
-    return INVALID_TUPLE;
+  key = db_value_to_long(&iterator->min_value);
+  hash_value = calculate_hash(key);
+
+  while(iterator->next_item_no < DB_MEMHASH_TABLE_SIZE) {
+    item = &(*hash_map)[(hash_value + iterator->next_item_no) %
+                        DB_MEMHASH_TABLE_SIZE];
+    iterator->next_item_no++;
+
+    if(item->tuple_id == INVALID_TUPLE) {
+      break;
+    }
+    if(item->tuple_id != DELETED_TUPLE && item->key == key) {
+      PRINTF("DB: Found value %ld in the hash table\n", key);
+      return item->tuple_id;
+    }
   }
 
-  iterator->next_item_no++;
-
-  PRINTF("DB: Found value %ld in the hash table\n", 
-	VALUE_LONG(&iterator->min_value));
-
-  return hash_map[hash_value]->tuple_id;
+  return INVALID_TUPLE;
 }
@@ -0,0 +1,458 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *	A block summary index for time-series relations, in which the
+ *      indexed attribute is a timestamp that never decreases between
+ *      consecutive inserts. The tuples are thus stored in key order,
+ *      and the relation can only be appended to with newer keys.
+ *
+ *      The tuples are grouped into blocks of DB_TIMESERIES_BLOCK_SIZE
+ *      consecutive tuples. For each full block, the index appends a
+ *      summary record with the smallest key, stored in full, and the
+ *      span to the largest key, stored as a 16-bit delta. A range
+ *      search locates the first block that may contain the lower end
+ *      of the range by a binary search over the summaries, skipping
+ *      all blocks before it, and scans the tuples from there until
+ *      it passes the upper end of the range.
+ *
+ *      Inserting a tuple costs no storage access until its block is
+ *      full. The summary of the last, partial block is kept in memory
+ *      and is reconstructed from the tuples after a restart.
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "lib/memb.h"
+
+#include "db-options.h"
+#include "index.h"
+#include "relation.h"
+#include "result.h"
+#include "storage.h"
+
+#define DEBUG DEBUG_NONE
+#include "net/ip/uip-debug.h"
+
+/* A stored block summary: a 32-bit minimum key followed by
+   a 16-bit span. */
+#define RECORD_SIZE	6
+/* The span is saturated at this value, in which case the next
+   block's minimum is used as an upper bound instead. */
+#define SPAN_LIMIT	0xffff
+
+#define SERIES_SYNCED	0x01
+
+struct series {
+  db_storage_id_t storage;
+  tuple_id_t blocks;
+  tuple_id_t tail;
+  long min;
+  long max;
+  uint8_t flags;
+};
+
+MEMB(series_memb, struct series, DB_TIMESERIES_INDEX_LIMIT);
+
+static db_result_t create(index_t *);
+static db_result_t destroy(index_t *);
+static db_result_t load(index_t *);
+static db_result_t release(index_t *);
+static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
+static db_result_t delete(index_t *, attribute_value_t *);
+static tuple_id_t get_next(index_iterator_t *);
+
+/*
+ * The index is derived from the tuples of the relation, and it
+ * brings itself up to date with them when first used. It therefore
+ * does not need to be loaded by the indexer process when created for
+ * a relation that already has tuples.
+ */
+index_api_t index_timeseries = {
+  INDEX_TIMESERIES,
+  INDEX_API_INLINE | INDEX_API_RANGE_QUERIES,
+  create,
+  destroy,
+  load,
+  release,
+  insert,
+  delete,
+  get_next
+};
+
+static db_result_t
+get_key(index_t *index, tuple_id_t tuple_id, long *key)
+{
+  unsigned char row[index->rel->row_length];
+  attribute_value_t value;
+
+  if(storage_get_row(index->rel, &tuple_id, row) != DB_OK ||
+     DB_ERROR(relation_get_value(index->rel, index->attr, row, &value))) {
+    PRINTF("DB: Unable to retrieve the key of tuple %ld\n", (long)tuple_id);
+    return DB_STORAGE_ERROR;
+  }
+
+  *key = db_value_to_long(&value);
+  return DB_OK;
+}
+
+static db_result_t
+read_block(struct series *series, tuple_id_t block, long *min, long *max)
+{
+  unsigned char record[RECORD_SIZE];
+  unsigned span;
+  long next_max;
+
+  if(DB_ERROR(storage_read(series->storage, record,
+                           (unsigned long)block * RECORD_SIZE,
+                           sizeof(record)))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  *min = (long)((uint32_t)record[0] << 24 | (uint32_t)record[1] << 16 |
+                (uint32_t)record[2] << 8 | record[3]);
+  span = (unsigned)record[4] << 8 | record[5];
+
+  if(span < SPAN_LIMIT) {
+    *max = *min + span;
+  } else if(block + 1 < series->blocks) {
+    /* The keys never decrease, so the next block starts at or
+       above the largest key of this block. */
+    return read_block(series, block + 1, max, &next_max);
+  } else {
+    *max = series->tail > 0 ? series->min : LONG_MAX;
+  }
+
+  return DB_OK;
+}
+
+static db_result_t
+write_block(struct series *series)
+{
+  unsigned char record[RECORD_SIZE];
+  unsigned long span;
+
+  span = (unsigned long)series->max - series->min;
+  if(span > SPAN_LIMIT) {
+    span = SPAN_LIMIT;
+  }
+
+  record[0] = (uint32_t)series->min >> 24;
+  record[1] = (uint32_t)series->min >> 16;
+  record[2] = (uint32_t)series->min >> 8;
+  record[3] = series->min;
+  record[4] = span >> 8;
+  record[5] = span;
+
+  return storage_write(series->storage, record,
+                       (unsigned long)series->blocks * RECORD_SIZE,
+                       sizeof(record));
+}
+
+static db_result_t
+append_key(struct series *series, long key)
+{
+  if(series->tail > 0 && key < series->max) {
+    PRINTF("DB: Key %ld is older than the latest key %ld\n",
+           key, series->max);
+    return DB_INDEX_ERROR;
+  }
+
+  if(series->tail == 0) {
+    series->min = key;
+  }
+  series->max = key;
+
+  if(++series->tail == DB_TIMESERIES_BLOCK_SIZE) {
+    if(DB_ERROR(write_block(series))) {
+      return DB_STORAGE_ERROR;
+    }
+    series->blocks++;
+    series->tail = 0;
+  }
+
+  return DB_OK;
+}
+
+static db_result_t
+open_storage(index_t *index, int truncate)
+{
+  struct series *series;
+
+  series = index->opaque_data;
+
+  if(truncate) {
+    storage_close(series->storage);
+    cfs_remove(index->descriptor_file);
+#if DB_FEATURE_COFFEE
+    cfs_coffee_reserve(index->descriptor_file,
+                       DB_COFFEE_RESERVE_SIZE / DB_TIMESERIES_BLOCK_SIZE);
+#endif
+  }
+
+  series->storage = storage_open(index->descriptor_file);
+  return series->storage < 0 ? DB_STORAGE_ERROR : DB_OK;
+}
+
+/*
+ * Bring the summaries up to date with the tuples in the relation.
+ * The summaries are rebuilt if the relation has fewer tuples than
+ * they cover, which happens after tuples have been removed.
+ */
+static db_result_t
+synchronize(index_t *index)
+{
+  struct series *series;
+  tuple_id_t cardinality;
+  tuple_id_t tuple_id;
+  cfs_offset_t size;
+  long key;
+
+  series = index->opaque_data;
+  if(series->flags & SERIES_SYNCED) {
+    return DB_OK;
+  }
+
+  cardinality = relation_cardinality(index->rel);
+  if(cardinality == INVALID_TUPLE) {
+    return DB_STORAGE_ERROR;
+  }
+
+  size = cfs_seek(series->storage, 0, CFS_SEEK_END);
+  if(size == (cfs_offset_t)-1) {
+    return DB_STORAGE_ERROR;
+  }
+
+  series->blocks = size / RECORD_SIZE;
+  series->tail = 0;
+
+  if(series->blocks * DB_TIMESERIES_BLOCK_SIZE > cardinality) {
+    PRINTF("DB: Rebuilding the time-series index of %s.%s\n",
+           index->rel->name, index->attr->name);
+    if(DB_ERROR(open_storage(index, 1))) {
+      return DB_STORAGE_ERROR;
+    }
+    series->blocks = 0;
+  }
+
+  for(tuple_id = series->blocks * DB_TIMESERIES_BLOCK_SIZE;
+      tuple_id < cardinality;
+      tuple_id++) {
+    if(DB_ERROR(get_key(index, tuple_id, &key)) ||
+       DB_ERROR(append_key(series, key))) {
+      return DB_INDEX_ERROR;
+    }
+  }
+
+  series->flags |= SERIES_SYNCED;
+  return DB_OK;
+}
+
+static db_result_t
+create(index_t *index)
+{
+  char *filename;
+
+  filename = storage_generate_file("series",
+                                   DB_COFFEE_RESERVE_SIZE /
+                                   DB_TIMESERIES_BLOCK_SIZE);
+  if(filename == NULL) {
+    PRINTF("DB: Failed to generate a time-series index file\n");
+    return DB_INDEX_ERROR;
+  }
+
+  memcpy(index->descriptor_file, filename, sizeof(index->descriptor_file));
+
+  if(DB_ERROR(load(index))) {
+    cfs_remove(index->descriptor_file);
+    index->descriptor_file[0] = '\0';
+    return DB_INDEX_ERROR;
+  }
+
+  return DB_OK;
+}
+
+static db_result_t
+destroy(index_t *index)
+{
+  /* The index has already been released. */
+  cfs_remove(index->descriptor_file);
+  return DB_OK;
+}
+
+static db_result_t
+load(index_t *index)
+{
+  struct series *series;
+
+  index->opaque_data = series = memb_alloc(&series_memb);
+  if(series == NULL) {
+    PRINTF("DB: Failed to allocate a time series\n");
+    return DB_ALLOCATION_ERROR;
+  }
+
+  series->flags = 0;
+  series->blocks = 0;
+  series->tail = 0;
+
+  if(DB_ERROR(open_storage(index, 0))) {
+    memb_free(&series_memb, series);
+    return DB_STORAGE_ERROR;
+  }
+
+  PRINTF("DB: Loaded a time-series index from file %s\n",
+         index->descriptor_file);
+
+  return DB_OK;
+}
+
+static db_result_t
+release(index_t *index)
+{
+  struct series *series;
+
+  series = index->opaque_data;
+  storage_close(series->storage);
+  memb_free(&series_memb, series);
+  return DB_OK;
+}
+
+static db_result_t
+insert(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
+{
+  if(DB_ERROR(synchronize(index))) {
+    return DB_INDEX_ERROR;
+  }
+
+  return append_key(index->opaque_data, db_value_to_long(value));
+}
+
+static db_result_t
+delete(index_t *index, attribute_value_t *value)
+{
+  /* Time series are append-only. */
+  return DB_INDEX_ERROR;
+}
+
+/* Find the first block whose largest key is at least the given key. */
+static tuple_id_t
+find_block(struct series *series, long key)
+{
+  tuple_id_t low;
+  tuple_id_t high;
+  tuple_id_t center;
+  long min;
+  long max;
+
+  low = 0;
+  high = series->blocks;
+  while(low < high) {
+    center = low + (high - low) / 2;
+    if(DB_ERROR(read_block(series, center, &min, &max))) {
+      return INVALID_TUPLE;
+    }
+    if(max < key) {
+      low = center + 1;
+    } else {
+      high = center;
+    }
+  }
+
+  return low;
+}
+
+static tuple_id_t
+get_next(index_iterator_t *iterator)
+{
+  static struct {
+    index_iterator_t *iterator;
+    tuple_id_t next_tuple;
+  } cursor;
+  index_t *index;
+  struct series *series;
+  tuple_id_t cardinality;
+  tuple_id_t block;
+  long key;
+
+  index = iterator->index;
+  series = index->opaque_data;
+
+  if(cursor.iterator != iterator || iterator->next_item_no == 0) {
+    if(DB_ERROR(synchronize(index))) {
+      return INVALID_TUPLE;
+    }
+
+    block = find_block(series, db_value_to_long(&iterator->min_value));
+    if(block == INVALID_TUPLE) {
+      return INVALID_TUPLE;
+    }
+
+    PRINTF("DB: Skipped %lu blocks of the time series\n",
+           (unsigned long)block);
+
+    cursor.iterator = iterator;
+    cursor.next_tuple = block * DB_TIMESERIES_BLOCK_SIZE;
+  }
+
+  cardinality = relation_cardinality(index->rel);
+
+  /* Scan forward from the first block that may hold the lower end of
+     the range, and stop at the first key beyond its upper end. */
+  while(cursor.next_tuple < cardinality) {
+    if(DB_ERROR(get_key(index, cursor.next_tuple, &key))) {
+      cursor.next_tuple = cardinality;
+      return INVALID_TUPLE;
+    }
+    if(key > db_value_to_long(&iterator->max_value)) {
+      break;
+    }
+
+    if(key >= db_value_to_long(&iterator->min_value)) {
+      iterator->next_item_no++;
+      return cursor.next_tuple++;
+    }
+    cursor.next_tuple++;
+  }
+
+  /* The range has been searched successfully. An iterator that has not
+     yielded any item is taken for a failed search, so count the end of
+     an empty range as an item to report an empty result instead. */
+  if(iterator->next_item_no == 0) {
+    iterator->next_item_no = 1;
+  }
+  cursor.next_tuple = cardinality;
+  return INVALID_TUPLE;
+}
@@ -35,6 +35,8 @@
  * 	Nicolas Tsiftes <nvt@sics.se>
  */
 
+#include <limits.h>
+
 #include "contiki.h"
 #include "lib/memb.h"
 #include "lib/list.h"
@@ -49,7 +51,7 @@
 #include "storage.h"
 
 static index_api_t *index_components[] = {&index_inline,
-	&index_maxheap};
+	&index_maxheap, &index_memhash, &index_timeseries};
 
 LIST(indices);
 MEMB(index_memb, index_t, DB_INDEX_POOL_SIZE);
@@ -342,6 +344,192 @@ index_exists(attribute_t *attr)
   return 1;
 }
 
+static unsigned long
+cost_add(unsigned long a, unsigned long b)
+{
+  return a > ULONG_MAX - b ? ULONG_MAX : a + b;
+}
+
+static unsigned long
+cost_mul(unsigned long a, unsigned long b)
+{
+  if(a != 0 && b > ULONG_MAX / a) {
+    return ULONG_MAX;
+  }
+  return a * b;
+}
+
+static int
+get_boundary_value(relation_t *rel, attribute_t *attr, tuple_id_t tuple_id,
+                   long *value)
+{
+  unsigned char row[rel->row_length];
+  attribute_value_t av;
+
+  if(storage_get_row(rel, &tuple_id, row) != DB_OK ||
+     DB_ERROR(relation_get_value(rel, attr, row, &av))) {
+    return 0;
+  }
+
+  *value = db_value_to_long(&av);
+  return 1;
+}
+
+/*
+ * Estimate the number of tuples that have a value in the range
+ * (min,max) in an inline-indexed attribute. Because the values are
+ * sorted, the first and last tuples give the span of the key space,
+ * and we assume that the keys are evenly distributed within it.
+ */
+static tuple_id_t
+estimate_inline_rows(index_t *index, tuple_id_t cardinality,
+                     long min, long max)
+{
+  long first;
+  long last;
+  unsigned long span;
+  unsigned long range;
+
+  if(!get_boundary_value(index->rel, index->attr, 0, &first) ||
+     !get_boundary_value(index->rel, index->attr, cardinality - 1, &last) ||
+     last < first) {
+    return cardinality;
+  }
+
+  span = (unsigned long)last - first + 1;
+
+  if(min == max) {
+    return span >= cardinality ? 1 : cardinality / span;
+  }
+
+  if(min < first) {
+    min = first;
+  }
+  if(max > last) {
+    max = last;
+  }
+  if(max < min) {
+    return 0;
+  }
+
+  range = (unsigned long)max - min + 1;
+  if(range >= span) {
+    return cardinality;
+  }
+
+  /* Divide before multiplying to stay within the range of
+     unsigned long on 16-bit platforms. */
+  return 1 + cardinality / (span / range);
+}
+
+static unsigned long
+log2_ceil(unsigned long value)
+{
+  unsigned long steps;
+
+  for(steps = 0; value > 1; steps++) {
+    value = (value + 1) >> 1;
+  }
+
+  return steps;
+}
+
+/*
+ * Estimate the cost of retrieving the tuples whose value of the indexed
+ * attribute is within (min,max). The cost is expressed in the number
+ * of sequential tuple reads that would take the same time; a full scan
+ * of the relation thus costs as much as its cardinality. The function
+ * returns ULONG_MAX if the index cannot be used for the given range.
+ */
+unsigned long
+index_get_cost(index_t *index, long min, long max, tuple_id_t *rows)
+{
+  tuple_id_t cardinality;
+  tuple_id_t matches;
+  unsigned long keys;
+  unsigned long cost;
+
+  cardinality = relation_cardinality(index->rel);
+  if(cardinality == INVALID_TUPLE || index->flags != INDEX_READY ||
+     max < min) {
+    return ULONG_MAX;
+  }
+
+  if(cardinality == 0) {
+    *rows = 0;
+    return 0;
+  }
+
+  keys = (unsigned long)max - min + 1;
+  if(keys == 0) {
+    /* The range covers the whole key space. */
+    keys = ULONG_MAX;
+  }
+
+  switch(index->type) {
+  case INDEX_INLINE:
+    /* Two binary searches to find the end points of the range, followed
+       by a sequential read of all tuples in between. */
+    matches = estimate_inline_rows(index, cardinality, min, max);
+    cost = cost_mul(2 * log2_ceil(cardinality), DB_PLAN_RANDOM_ACCESS_COST);
+    cost = cost_add(cost, matches);
+    break;
+  case INDEX_MAXHEAP:
+    /* The MaxHeap emulates range searches by looking up each key
+       separately. The keys are assumed to be mostly distinct. */
+    matches = keys < cardinality ? keys : cardinality;
+    cost = cost_add(cost_mul(keys, DB_INDEX_COST),
+                    cost_mul(matches, DB_PLAN_RANDOM_ACCESS_COST));
+    break;
+  case INDEX_TIMESERIES:
+    /* A binary search over the block summaries, followed by a sequential
+       read from the start of the first block that overlaps the range. */
+    matches = estimate_inline_rows(index, cardinality, min, max);
+    cost = cost_mul(log2_ceil(cardinality / DB_TIMESERIES_BLOCK_SIZE + 1),
+                    DB_PLAN_RANDOM_ACCESS_COST);
+    cost = cost_add(cost, matches);
+    cost = cost_add(cost, DB_TIMESERIES_BLOCK_SIZE);
+    break;
+  case INDEX_MEMHASH:
+    /* The hash map supports only lookups. Like for the MaxHeap, the
+       keys are assumed to be mostly distinct. An index that ran out of
+       space has the INDEX_INCOMPLETE flag set and is rejected above. */
+    if(min != max) {
+      return ULONG_MAX;
+    }
+    matches = 1;
+    cost = 1 + DB_PLAN_RANDOM_ACCESS_COST;
+    break;
+  default:
+    return ULONG_MAX;
+  }
+
+  *rows = matches;
+
+  PRINTF("DB: Index cost of %s.%s over (%ld,%ld): %lu for %lu rows\n",
+         index->rel->name, index->attr->name, min, max,
+         cost, (unsigned long)matches);
+
+  return cost;
+}
+
+const char *
+index_get_name(index_type_t index_type)
+{
+  switch(index_type) {
+  case INDEX_INLINE:
+    return "inline";
+  case INDEX_MAXHEAP:
+    return "maxheap";
+  case INDEX_MEMHASH:
+    return "memhash";
+  case INDEX_TIMESERIES:
+    return "timeseries";
+  default:
+    return "none";
+  }
+}
+
 static index_t *
 get_next_index_to_load(void)
 {
@@ -388,7 +576,7 @@ PROCESS_THREAD(db_indexer, ev, data)
       continue;
     }
 
-    for(;; row++) {
+    for(row = 0;; row++) {
       PROCESS_PAUSE();
 
       result = db_process(&handle);
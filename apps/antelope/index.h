@@ -43,12 +43,14 @@ typedef enum {
   INDEX_NONE = 0,
   INDEX_INLINE = 1,
   INDEX_MEMHASH = 2,
-  INDEX_MAXHEAP = 3
+  INDEX_MAXHEAP = 3,
+  INDEX_TIMESERIES = 4
 } index_type_t;
 
 #define INDEX_READY		0x00
 #define INDEX_LOAD_NEEDED	0x01
 #define INDEX_LOAD_ERROR	0x02
+#define INDEX_INCOMPLETE	0x04
 
 #define INDEX_API_INTERNAL	0x01
 #define INDEX_API_EXTERNAL	0x02
@@ -97,6 +99,7 @@ typedef struct index_api index_api_t;
 extern index_api_t index_inline;
 extern index_api_t index_maxheap;
 extern index_api_t index_memhash;
+extern index_api_t index_timeseries;
 
 void index_init(void);
 db_result_t index_create(index_type_t, relation_t *, attribute_t *);
@@ -109,5 +112,7 @@ db_result_t index_get_iterator(index_iterator_t *, index_t *,
                                attribute_value_t *, attribute_value_t *);
 tuple_id_t index_get_next(index_iterator_t *);
 int index_exists(attribute_t *);
+unsigned long index_get_cost(index_t *, long, long, tuple_id_t *);
+const char *index_get_name(index_type_t);
 
 #endif /* !INDEX_H */
@@ -70,6 +70,10 @@ struct variable {
   operand_type_t type;
   operand_value_t value;
   char name[LVM_MAX_NAME_LENGTH + 1];
+  /* The location of the variable's value in a tuple, which is used
+     by compiled programs. A size of zero means that it is unknown. */
+  uint8_t offset;
+  uint8_t size;
 };
 typedef struct variable variable_t;
 
@@ -82,10 +86,10 @@ typedef struct derivation derivation_t;
 
 /* Registered variables for a LVM expression. Their values may be 
    changed between executions of the expression. */
-static variable_t variables[LVM_MAX_VARIABLE_ID - 1];
+static variable_t variables[LVM_MAX_VARIABLE_ID];
 
 /* Range derivations of variables that are used for index searches. */
-static derivation_t derivations[LVM_MAX_VARIABLE_ID - 1];
+static derivation_t derivations[LVM_MAX_VARIABLE_ID];
 
 #if DEBUG
 static void
@@ -487,6 +491,292 @@ lvm_set_variable(lvm_instance_t *p, char *name)
   }
 }
 
+lvm_status_t
+lvm_set_variable_location(char *name, unsigned offset, unsigned size)
+{
+  variable_id_t id;
+
+  id = lookup(name);
+  if(id == LVM_MAX_VARIABLE_ID || variables[id].name[0] == '\0' ||
+     offset > UINT8_MAX || (size != 2 && size != 4)) {
+    return INVALID_IDENTIFIER;
+  }
+  variables[id].offset = offset;
+  variables[id].size = size;
+  return TRUE;
+}
+
+#if LVM_USE_COMPILER
+/*
+ * The compiler translates the prefix-notation bytecode into a flat
+ * program in postfix notation, in which variable references have been
+ * replaced by loads from fixed offsets in the tuple. Subexpressions
+ * that consist only of constants are folded at compile time.
+ */
+static int
+is_constant(lvm_program_t *program, int distance)
+{
+  return program->length >= distance &&
+         program->code[program->length - distance].opcode == LVM_OP_CONST;
+}
+
+static lvm_status_t
+emit(lvm_program_t *program, uint8_t opcode, long value)
+{
+  struct lvm_instruction *insn;
+  long l1, l2;
+
+  if(opcode >= LVM_OP_ADD && opcode != LVM_OP_NOT &&
+     is_constant(program, 1) && is_constant(program, 2)) {
+    l1 = program->code[program->length - 2].value;
+    l2 = program->code[program->length - 1].value;
+    switch(opcode) {
+    case LVM_OP_ADD: value = l1 + l2; break;
+    case LVM_OP_SUB: value = l1 - l2; break;
+    case LVM_OP_MUL: value = l1 * l2; break;
+    case LVM_OP_DIV:
+      if(l2 == 0) {
+        /* Leave the division to be reported at run time. */
+        goto append;
+      }
+      value = l1 / l2;
+      break;
+    case LVM_OP_EQ: value = l1 == l2; break;
+    case LVM_OP_NEQ: value = l1 != l2; break;
+    case LVM_OP_GE: value = l1 > l2; break;
+    case LVM_OP_GEQ: value = l1 >= l2; break;
+    case LVM_OP_LE: value = l1 < l2; break;
+    case LVM_OP_LEQ: value = l1 <= l2; break;
+    case LVM_OP_AND: value = l1 && l2; break;
+    case LVM_OP_OR: value = l1 || l2; break;
+    default:
+      return EXECUTION_ERROR;
+    }
+    program->length -= 2;
+    opcode = LVM_OP_CONST;
+  } else if(opcode == LVM_OP_NOT && is_constant(program, 1)) {
+    program->code[program->length - 1].value =
+      !program->code[program->length - 1].value;
+    return TRUE;
+  } else if((opcode == LVM_OP_AND || opcode == LVM_OP_OR) &&
+            is_constant(program, 1) &&
+            (program->code[program->length - 1].value != 0) ==
+            (opcode == LVM_OP_AND)) {
+    /* "x AND true" and "x OR false" are both equal to x. */
+    program->length--;
+    return TRUE;
+  }
+
+append:
+  if(program->length >= LVM_MAX_PROGRAM_LENGTH) {
+    return STACK_OVERFLOW;
+  }
+  insn = &program->code[program->length++];
+  insn->opcode = opcode;
+  insn->value = value;
+  return TRUE;
+}
+
+static lvm_status_t
+compile_expr(lvm_instance_t *p, lvm_program_t *program)
+{
+  operator_t *operator;
+  operand_t operand;
+  variable_t *var;
+  lvm_status_t r;
+  int i;
+
+  switch(get_type(p)) {
+  case LVM_ARITH_OP:
+    operator = get_operator(p);
+    for(i = 0; i < 2; i++) {
+      r = compile_expr(p, program);
+      if(LVM_ERROR(r)) {
+        return r;
+      }
+    }
+    switch(*operator) {
+    case LVM_ADD:
+      return emit(program, LVM_OP_ADD, 0);
+    case LVM_SUB:
+      return emit(program, LVM_OP_SUB, 0);
+    case LVM_MUL:
+      return emit(program, LVM_OP_MUL, 0);
+    case LVM_DIV:
+      return emit(program, LVM_OP_DIV, 0);
+    default:
+      return EXECUTION_ERROR;
+    }
+  case LVM_OPERAND:
+    get_operand(p, &operand);
+    switch(operand.type) {
+    case LVM_LONG:
+      return emit(program, LVM_OP_CONST, operand.value.l);
+    case LVM_VARIABLE:
+      if(operand.value.id >= LVM_MAX_VARIABLE_ID) {
+        return INVALID_IDENTIFIER;
+      }
+      var = &variables[operand.value.id];
+      if(var->size == 0) {
+        return INVALID_IDENTIFIER;
+      }
+      return emit(program, var->size == 2 ? LVM_OP_LOAD_INT : LVM_OP_LOAD_LONG,
+                  var->offset);
+    default:
+      return TYPE_ERROR;
+    }
+  default:
+    return SEMANTIC_ERROR;
+  }
+}
+
+static lvm_status_t
+compile_logic(lvm_instance_t *p, lvm_program_t *program)
+{
+  operator_t operator;
+  lvm_status_t r;
+  unsigned arguments;
+  int i;
+
+  if(get_type(p) != LVM_CMP_OP) {
+    return SEMANTIC_ERROR;
+  }
+  operator = *get_operator(p);
+
+  if(IS_CONNECTIVE(operator)) {
+    arguments = operator == LVM_NOT ? 1 : 2;
+    for(i = 0; i < arguments; i++) {
+      r = compile_logic(p, program);
+      if(LVM_ERROR(r)) {
+        return r;
+      }
+    }
+  } else {
+    for(i = 0; i < 2; i++) {
+      r = compile_expr(p, program);
+      if(LVM_ERROR(r)) {
+        return r;
+      }
+    }
+  }
+
+  switch(operator) {
+  case LVM_EQ:
+    return emit(program, LVM_OP_EQ, 0);
+  case LVM_NEQ:
+    return emit(program, LVM_OP_NEQ, 0);
+  case LVM_GE:
+    return emit(program, LVM_OP_GE, 0);
+  case LVM_GEQ:
+    return emit(program, LVM_OP_GEQ, 0);
+  case LVM_LE:
+    return emit(program, LVM_OP_LE, 0);
+  case LVM_LEQ:
+    return emit(program, LVM_OP_LEQ, 0);
+  case LVM_AND:
+    return emit(program, LVM_OP_AND, 0);
+  case LVM_OR:
+    return emit(program, LVM_OP_OR, 0);
+  case LVM_NOT:
+    return emit(program, LVM_OP_NOT, 0);
+  default:
+    return EXECUTION_ERROR;
+  }
+}
+
+lvm_status_t
+lvm_compile(lvm_instance_t *p, lvm_program_t *program)
+{
+  lvm_status_t r;
+  int depth;
+  int i;
+
+  program->length = 0;
+  p->ip = 0;
+  r = compile_logic(p, program);
+  p->ip = 0;
+  if(LVM_ERROR(r)) {
+    PRINTF("LVM: Unable to compile the predicate: %d\n", (int)r);
+    return r;
+  }
+
+  /* Verify that the program fits in the evaluation stack. */
+  for(depth = 0, i = 0; i < program->length; i++) {
+    if(program->code[i].opcode <= LVM_OP_LOAD_LONG) {
+      if(++depth > LVM_MAX_STACK_DEPTH) {
+        return STACK_OVERFLOW;
+      }
+    } else if(program->code[i].opcode != LVM_OP_NOT) {
+      depth--;
+    }
+  }
+
+  PRINTF("LVM: Compiled the predicate into %d instructions\n",
+         (int)program->length);
+  return TRUE;
+}
+
+lvm_status_t
+lvm_run(lvm_program_t *program, const unsigned char *tuple)
+{
+  long stack[LVM_MAX_STACK_DEPTH];
+  long *sp;
+  const struct lvm_instruction *insn;
+  const struct lvm_instruction *end;
+  const unsigned char *ptr;
+
+  sp = stack;
+  end = program->code + program->length;
+  for(insn = program->code; insn < end; insn++) {
+    switch(insn->opcode) {
+    case LVM_OP_CONST:
+      *sp++ = insn->value;
+      continue;
+    case LVM_OP_LOAD_INT:
+      ptr = tuple + insn->value;
+      *sp++ = ptr[0] << 8 | ptr[1];
+      continue;
+    case LVM_OP_LOAD_LONG:
+      ptr = tuple + insn->value;
+      *sp++ = (long)((uint32_t)ptr[0] << 24 | (uint32_t)ptr[1] << 16 |
+                     (uint32_t)ptr[2] << 8 | ptr[3]);
+      continue;
+    case LVM_OP_NOT:
+      sp[-1] = !sp[-1];
+      continue;
+    default:
+      break;
+    }
+
+    /* Binary operators. */
+    sp--;
+    switch(insn->opcode) {
+    case LVM_OP_ADD: sp[-1] += sp[0]; break;
+    case LVM_OP_SUB: sp[-1] -= sp[0]; break;
+    case LVM_OP_MUL: sp[-1] *= sp[0]; break;
+    case LVM_OP_DIV:
+      if(sp[0] == 0) {
+        return MATH_ERROR;
+      }
+      sp[-1] /= sp[0];
+      break;
+    case LVM_OP_EQ: sp[-1] = sp[-1] == sp[0]; break;
+    case LVM_OP_NEQ: sp[-1] = sp[-1] != sp[0]; break;
+    case LVM_OP_GE: sp[-1] = sp[-1] > sp[0]; break;
+    case LVM_OP_GEQ: sp[-1] = sp[-1] >= sp[0]; break;
+    case LVM_OP_LE: sp[-1] = sp[-1] < sp[0]; break;
+    case LVM_OP_LEQ: sp[-1] = sp[-1] <= sp[0]; break;
+    case LVM_OP_AND: sp[-1] = sp[-1] && sp[0]; break;
+    case LVM_OP_OR: sp[-1] = sp[-1] || sp[0]; break;
+    default:
+      return EXECUTION_ERROR;
+    }
+  }
+
+  return stack[0] ? TRUE : FALSE;
+}
+#endif /* LVM_USE_COMPILER */
+
 void
 lvm_clone(lvm_instance_t *dst, lvm_instance_t *src)
 {
@@ -40,6 +40,7 @@
 #ifndef LVM_H
 #define LVM_H
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "db-options.h"
@@ -120,6 +121,39 @@ struct operand {
 };
 typedef struct operand operand_t;
 
+/* Instructions of compiled predicates. */
+enum lvm_opcode {
+  LVM_OP_CONST,
+  LVM_OP_LOAD_INT,
+  LVM_OP_LOAD_LONG,
+  LVM_OP_ADD,
+  LVM_OP_SUB,
+  LVM_OP_MUL,
+  LVM_OP_DIV,
+  LVM_OP_EQ,
+  LVM_OP_NEQ,
+  LVM_OP_GE,
+  LVM_OP_GEQ,
+  LVM_OP_LE,
+  LVM_OP_LEQ,
+  LVM_OP_AND,
+  LVM_OP_OR,
+  LVM_OP_NOT
+};
+
+/* The value is a constant for LVM_OP_CONST, and a byte offset
+   into the tuple for the load instructions. */
+struct lvm_instruction {
+  long value;
+  uint8_t opcode;
+};
+
+struct lvm_program {
+  struct lvm_instruction code[LVM_MAX_PROGRAM_LENGTH];
+  uint8_t length;
+};
+typedef struct lvm_program lvm_program_t;
+
 void lvm_reset(lvm_instance_t *p, unsigned char *code, lvm_ip_t size);
 void lvm_clone(lvm_instance_t *dst, lvm_instance_t *src);
 lvm_status_t lvm_derive(lvm_instance_t *p);
@@ -140,5 +174,9 @@ void lvm_set_relation(lvm_instance_t *p, operator_t op);
 void lvm_set_operand(lvm_instance_t *p, operand_t *op);
 void lvm_set_long(lvm_instance_t *p, long l);
 void lvm_set_variable(lvm_instance_t *p, char *name);
+lvm_status_t lvm_set_variable_location(char *name, unsigned offset,
+                                       unsigned size);
+lvm_status_t lvm_compile(lvm_instance_t *p, lvm_program_t *program);
+lvm_status_t lvm_run(lvm_program_t *program, const unsigned char *tuple);
 
 #endif /* LVM_H */
@@ -68,6 +68,23 @@ struct source_dest_map {
 
 static struct source_dest_map attr_map[AQL_ATTRIBUTE_LIMIT];
 
+/*
+ * Aggregates are computed in a single pass over the selected tuples.
+ * Each group holds the running values of the aggregated attributes
+ * for one value of the GROUP BY attribute. Queries without GROUP BY
+ * use a single group.
+ */
+struct aggregation_group {
+  long key;
+  tuple_id_t count;
+  long values[AQL_ATTRIBUTE_LIMIT];
+};
+
+static struct aggregation_group groups[DB_GROUP_LIMIT];
+static uint8_t group_count;
+static uint8_t next_group;
+static struct source_dest_map *group_key;
+
 #if DB_FEATURE_JOIN
 /*
  * The source_map structure is used for mapping attributes to
@@ -82,11 +99,19 @@ static struct source_map source_map[AQL_ATTRIBUTE_LIMIT];
 #endif /* DB_FEATURE_JOIN */
 
 static unsigned char row[DB_MAX_ATTRIBUTES_PER_RELATION * DB_MAX_ELEMENT_SIZE];
-static unsigned char extra_row[DB_MAX_ATTRIBUTES_PER_RELATION * DB_MAX_ELEMENT_SIZE];
 static unsigned char result_row[AQL_ATTRIBUTE_LIMIT * DB_MAX_ELEMENT_SIZE];
+#if DB_FEATURE_JOIN
+static unsigned char extra_row[DB_MAX_ATTRIBUTES_PER_RELATION * DB_MAX_ELEMENT_SIZE];
 static unsigned char * const left_row = row;
 static unsigned char * const right_row = extra_row;
 static unsigned char * const join_row = result_row;
+#endif /* DB_FEATURE_JOIN */
+
+#if LVM_USE_COMPILER
+/* The predicate of the selection in progress, compiled for
+   evaluation directly on the rows read from storage. */
+static lvm_program_t predicate;
+#endif /* LVM_USE_COMPILER */
 
 LIST(relations);
 MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
@@ -99,7 +124,7 @@ static void attribute_free(relation_t *, attribute_t *);
 static void purge_relations(void);
 static void relation_clear(relation_t *);
 static relation_t *relation_allocate(void);
-static void relation_free(relation_t *);
+static db_result_t relation_free(relation_t *);
 
 static relation_t *
 relation_find(char *name)
@@ -200,17 +225,23 @@ relation_allocate(void)
   return rel;
 }
 
-static void
+static db_result_t
 relation_free(relation_t *rel)
 {
   attribute_t *attr;
 
+  /* The buffered tuples of the relation must be written first. */
+  if(DB_ERROR(storage_release(rel))) {
+    return DB_STORAGE_ERROR;
+  }
+
   while((attr = list_pop(rel->attributes)) != NULL) {
     attribute_free(rel, attr);
   }
 
   list_remove(relations, rel);
   memb_free(&relations_memb, rel);
+  return DB_OK;
 }
 
 db_result_t
@@ -468,7 +499,11 @@ relation_remove(char *name, int remove_tuples)
   }
 
   result = storage_drop_relation(rel, remove_tuples);
-  relation_free(rel);
+  if(DB_ERROR(relation_free(rel))) {
+    /* Keep the relation until its buffered tuples are written. */
+    relation_release(rel);
+    return DB_STORAGE_ERROR;
+  }
   return result;
 }
 
@@ -480,8 +515,10 @@ relation_insert(relation_t *rel, attribute_value_t *values)
   unsigned char *ptr;
   attribute_value_t *value;
   db_result_t result;
+  int indexed;
 
   value = values;
+  indexed = 0;
 
   PRINTF("DB: Relation %s has a record size of %u bytes\n",
 	 rel->name, (unsigned)rel->row_length);
@@ -537,6 +574,7 @@ relation_insert(relation_t *rel, attribute_value_t *values)
       if(DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
         return DB_INDEX_ERROR;
       }
+      indexed = 1;
     }
   }
 
@@ -544,49 +582,170 @@ relation_insert(relation_t *rel, attribute_value_t *values)
 
   rel->cardinality++;
   rel->next_row++;
-  return storage_put_row(rel, record);
+  result = storage_put_row(rel, record);
+  if(!DB_ERROR(result) && indexed) {
+    /* An index may already have stored the tuple ID, so the tuple
+       must not stay in the write buffer. */
+    result = storage_flush(rel);
+  }
+  return result;
 }
 
-static void
-aggregate(attribute_t *attr, attribute_value_t *value)
+static struct aggregation_group *
+get_group(long key, unsigned attribute_count)
+{
+  struct aggregation_group *group;
+  struct source_dest_map *attr_map_ptr;
+  unsigned i;
+
+  for(i = 0; i < group_count; i++) {
+    if(groups[i].key == key) {
+      return &groups[i];
+    }
+  }
+
+  if(group_count == DB_GROUP_LIMIT) {
+    PRINTF("DB: Too many groups in the aggregation\n");
+    return NULL;
+  }
+
+  group = &groups[group_count++];
+  group->key = key;
+  group->count = 0;
+  for(i = 0, attr_map_ptr = attr_map;
+      i < attribute_count;
+      i++, attr_map_ptr++) {
+    switch(attr_map_ptr->to_attr->aggregator) {
+    case AQL_MAX:
+      group->values[i] = LONG_MIN;
+      break;
+    case AQL_MIN:
+      group->values[i] = LONG_MAX;
+      break;
+    default:
+      group->values[i] = 0;
+      break;
+    }
+  }
+
+  return group;
+}
+
+/* Update the aggregates of the group that the current row belongs to. */
+static db_result_t
+aggregate(unsigned attribute_count)
+{
+  struct source_dest_map *attr_map_ptr;
+  struct aggregation_group *group;
+  attribute_value_t value;
+  long long_value;
+  long *aggregation_value;
+  db_result_t result;
+
+  long_value = 0;
+  if(group_key != NULL) {
+    result = db_phy_to_value(&value, group_key->from_attr,
+                             row + group_key->from_offset);
+    if(DB_ERROR(result)) {
+      return result;
+    }
+    long_value = db_value_to_long(&value);
+  }
+
+  group = get_group(long_value, attribute_count);
+  if(group == NULL) {
+    return DB_LIMIT_ERROR;
+  }
+  group->count++;
+
+  for(attr_map_ptr = attr_map;
+      attr_map_ptr < attr_map + attribute_count;
+      attr_map_ptr++) {
+    if(attr_map_ptr->to_attr->aggregator == AQL_NONE) {
+      continue;
+    }
+
+    result = db_phy_to_value(&value, attr_map_ptr->from_attr,
+                             row + attr_map_ptr->from_offset);
+    if(DB_ERROR(result)) {
+      return result;
+    }
+    if(value.domain != DOMAIN_INT && value.domain != DOMAIN_LONG) {
+      continue;
+    }
+    long_value = db_value_to_long(&value);
+
+    aggregation_value = &group->values[attr_map_ptr - attr_map];
+    switch(attr_map_ptr->to_attr->aggregator) {
+    case AQL_COUNT:
+      (*aggregation_value)++;
+      break;
+    case AQL_SUM:
+    case AQL_MEAN:
+      *aggregation_value += long_value;
+      break;
+    case AQL_MAX:
+      if(long_value > *aggregation_value) {
+        *aggregation_value = long_value;
+      }
+      break;
+    case AQL_MIN:
+      if(long_value < *aggregation_value) {
+        *aggregation_value = long_value;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  return DB_OK;
+}
+
+/* Put the aggregates of a group into the result row. */
+static db_result_t
+generate_group_row(struct aggregation_group *group, unsigned attribute_count)
 {
+  struct source_dest_map *attr_map_ptr;
+  attribute_t *result_attr;
+  attribute_value_t value;
   long long_value;
 
-  switch(value->domain) {
-  case DOMAIN_INT:
-    long_value = VALUE_INT(value);
-    break;
-  case DOMAIN_LONG:
-    long_value = VALUE_LONG(value);
-    break;
-  default:
-    return;
-  }
-
-  switch(attr->aggregator) {
-  case AQL_COUNT:
-    attr->aggregation_value++;
-    break;
-  case AQL_SUM:
-    attr->aggregation_value += long_value;
-    break;
-  case AQL_MEAN:
-    break;
-  case AQL_MEDIAN:
-    break;
-  case AQL_MAX:
-    if(long_value > attr->aggregation_value) {
-      attr->aggregation_value = long_value;
-    }
-    break;
-  case AQL_MIN:
-    if(long_value < attr->aggregation_value) {
-      attr->aggregation_value = long_value;
-    }
-    break;
-  default:
-    break;
+  for(attr_map_ptr = attr_map;
+      attr_map_ptr < attr_map + attribute_count;
+      attr_map_ptr++) {
+    result_attr = attr_map_ptr->to_attr;
+    if(result_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+      continue;
+    }
+
+    long_value = group->values[attr_map_ptr - attr_map];
+    switch(result_attr->aggregator) {
+    case AQL_NONE:
+      /* Only the grouping attribute is not aggregated. */
+      long_value = group->key;
+      break;
+    case AQL_MEAN:
+      long_value = group->count > 0 ? long_value / (long)group->count : 0;
+      break;
+    default:
+      break;
+    }
+
+    value.domain = result_attr->domain;
+    if(value.domain == DOMAIN_INT) {
+      VALUE_INT(&value) = (int)long_value;
+    } else {
+      VALUE_LONG(&value) = long_value;
+    }
+
+    if(DB_ERROR(db_value_to_phy(result_row + attr_map_ptr->to_offset,
+                                result_attr, &value))) {
+      return DB_TYPE_ERROR;
+    }
   }
+
+  return DB_OK;
 }
 
 static db_result_t
@@ -627,6 +786,29 @@ generate_attribute_map(struct source_dest_map *attr_map, unsigned attribute_coun
   return DB_OK;
 }
 
+/* Limit a derived range to the values that the attribute can hold. */
+static void
+clamp_range(attribute_t *attr, long *min, long *max)
+{
+  long low;
+  long high;
+
+  if(attr->domain == DOMAIN_INT) {
+    low = -32768L;
+    high = 32767L;
+  } else {
+    low = -2147483647L - 1;
+    high = 2147483647L;
+  }
+
+  if(*min < low) {
+    *min = low;
+  }
+  if(*max > high) {
+    *max = high;
+  }
+}
+
 static void
 select_index(db_handle_t *handle, lvm_instance_t *lvm_instance)
 {
@@ -636,26 +818,33 @@ select_index(db_handle_t *handle, lvm_instance_t *lvm_instance)
   operand_value_t max;
   attribute_value_t av_min;
   attribute_value_t av_max;
-  long range;
-  unsigned long min_range;
+  unsigned long cost;
+  tuple_id_t rows;
+  db_plan_t *plan;
 
   index = NULL;
-  min_range = ULONG_MAX;
+  plan = &handle->plan;
 
-  /* Find all indexed and derived attributes, and select the index of 
-     the attribute with the smallest range. */
+  /* Find all indexed and derived attributes, and select the index
+     with the lowest estimated cost. The index is used only if it is
+     cheaper than a full scan of the relation. */
   for(attr = list_head(handle->rel->attributes);
       attr != NULL;
       attr = attr->next) {
     if(attr->index != NULL &&
        !LVM_ERROR(lvm_get_derived_range(lvm_instance, attr->name, &min, &max))) {
-      range = (unsigned long)max.l - (unsigned long)min.l;
-      PRINTF("DB: The search range for attribute \"%s\" comprises %ld values\n",
-             attr->name, range + 1);
+      clamp_range(attr, &min.l, &max.l);
+      cost = index_get_cost(attr->index, min.l, max.l, &rows);
+      PRINTF("DB: The search range for attribute \"%s\" is (%ld,%ld); cost %lu\n",
+             attr->name, min.l, max.l, cost);
 
-      if(range <= min_range) {
+      if(cost < plan->cost) {
         index = attr->index;
-        av_min.domain = av_max.domain = DOMAIN_INT;
+        plan->method = DB_PLAN_INDEX;
+        plan->attr = attr;
+        plan->cost = cost;
+        plan->rows = rows;
+        av_min.domain = av_max.domain = DOMAIN_LONG;
         VALUE_LONG(&av_min) = min.l;
         VALUE_LONG(&av_max) = max.l;
       }
@@ -667,8 +856,48 @@ select_index(db_handle_t *handle, lvm_instance_t *lvm_instance)
     if(index_get_iterator(&handle->index_iterator, index, 
                           &av_min, &av_max) == DB_OK) {
       handle->flags |= DB_HANDLE_FLAG_SEARCH_INDEX;
+    } else {
+      plan->method = DB_PLAN_SCAN;
+      plan->attr = NULL;
+      plan->cost = plan->rows = relation_cardinality(handle->rel);
+    }
+  }
+}
+
+#if LVM_USE_COMPILER
+static void
+compile_predicate(db_handle_t *handle, lvm_instance_t *lvm_instance,
+                  unsigned attribute_count)
+{
+  struct source_dest_map *attr_map_ptr;
+
+  for(attr_map_ptr = attr_map;
+      attr_map_ptr < attr_map + attribute_count;
+      attr_map_ptr++) {
+    if(attr_map_ptr->from_attr->domain == DOMAIN_INT ||
+       attr_map_ptr->from_attr->domain == DOMAIN_LONG) {
+      lvm_set_variable_location(attr_map_ptr->to_attr->name,
+                                attr_map_ptr->from_offset,
+                                attr_map_ptr->from_attr->element_size);
     }
   }
+
+  /* Predicates that cannot be compiled are interpreted instead. */
+  if(lvm_compile(lvm_instance, &predicate) == TRUE) {
+    handle->flags |= DB_HANDLE_FLAG_COMPILED;
+  }
+}
+#endif /* LVM_USE_COMPILER */
+
+static lvm_status_t
+evaluate_predicate(db_handle_t *handle, lvm_instance_t *lvm_instance)
+{
+#if LVM_USE_COMPILER
+  if(handle->flags & DB_HANDLE_FLAG_COMPILED) {
+    return lvm_run(&predicate, row);
+  }
+#endif /* LVM_USE_COMPILER */
+  return lvm_execute(lvm_instance);
 }
 
 static db_result_t
@@ -677,6 +906,7 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
   relation_t *result_rel;
   unsigned attribute_count;
   attribute_t *attr;
+  unsigned i;
 
   result_rel = handle->result_rel;
 
@@ -696,11 +926,30 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
     return DB_IMPLEMENTATION_ERROR;
   }
 
+  group_count = 0;
+  next_group = 0;
+  group_key = NULL;
+  for(i = 0; i < attribute_count; i++) {
+    if(attr_map[i].to_attr->flags & ATTRIBUTE_FLAG_GROUP) {
+      group_key = &attr_map[i];
+    }
+  }
+
+  handle->plan.method = DB_PLAN_SCAN;
+  handle->plan.attr = NULL;
+  handle->plan.cost = handle->plan.rows = relation_cardinality(rel);
+
   if(adt->lvm_instance != NULL) {
-    /* Try to establish acceptable ranges for the attribute values. */
-    if(!LVM_ERROR(lvm_derive(adt->lvm_instance))) {
+    /* Try to establish acceptable ranges for the attribute values.
+       An index yields only the tuples that fulfill the condition, so
+       it cannot be used when the inverse set is wanted. */
+    if(!(AQL_GET_FLAGS(adt) & AQL_FLAG_INVERSE_LOGIC) &&
+       !LVM_ERROR(lvm_derive(adt->lvm_instance))) {
       select_index(handle, adt->lvm_instance);
     }
+#if LVM_USE_COMPILER
+    compile_predicate(handle, adt->lvm_instance, attribute_count);
+#endif /* LVM_USE_COMPILER */
   }
 
   handle->flags |= DB_HANDLE_FLAG_PROCESSING;
@@ -741,10 +990,7 @@ relation_process_select(void *handle_ptr)
   struct source_dest_map *attr_map_ptr, *attr_map_end;
   attribute_t *result_attr;
   unsigned char *from_ptr;
-  unsigned char *to_ptr;
   operand_value_t operand_value;
-  uint8_t intbuf[2];
-  attribute_value_t value;
   lvm_status_t wanted_result;
 
   handle = (db_handle_t *)handle_ptr;
@@ -753,6 +999,10 @@ relation_process_select(void *handle_ptr)
   attribute_count = handle->result_rel->attribute_count;
   attr_map_end = attr_map + attribute_count;
 
+  if(handle->flags & DB_HANDLE_FLAG_AGGREGATED) {
+    goto end_aggregation;
+  }
+
   if(handle->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
     handle->tuple_id = index_get_next(&handle->index_iterator);
     if(handle->tuple_id == INVALID_TUPLE) {
@@ -788,11 +1038,14 @@ relation_process_select(void *handle_ptr)
     from_ptr = row + attr_map_ptr->from_offset;
     result_attr = attr_map_ptr->to_attr;
 
-    /* Update the internal state of the PLE. */
-    if(result_attr->domain == DOMAIN_INT) {
+    /* Update the internal state of the PLE. A compiled predicate
+       reads the values directly from the row instead. */
+    if(handle->flags & DB_HANDLE_FLAG_COMPILED) {
+      /* Nothing to update. */
+    } else if(attr_map_ptr->from_attr->domain == DOMAIN_INT) {
       operand_value.l = from_ptr[0] << 8 | from_ptr[1];
       lvm_set_variable_value(result_attr->name, operand_value);
-    } else if(result_attr->domain == DOMAIN_LONG) {
+    } else if(attr_map_ptr->from_attr->domain == DOMAIN_LONG) {
       operand_value.l = (uint32_t)from_ptr[0] << 24 |
                         (uint32_t)from_ptr[1] << 16 |
                         (uint32_t)from_ptr[2] << 8 |
@@ -820,16 +1073,9 @@ relation_process_select(void *handle_ptr)
 
   /* Check whether the given predicate is true for this tuple. */
   if(adt->lvm_instance == NULL ||
-     lvm_execute(adt->lvm_instance) == wanted_result) {
+     evaluate_predicate(handle, adt->lvm_instance) == wanted_result) {
     if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
-      for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-        from_ptr = row + attr_map_ptr->from_offset;
-        result = db_phy_to_value(&value, attr_map_ptr->to_attr, from_ptr);
-        if(DB_ERROR(result)) {
-	  return result;
-        }
-        aggregate(attr_map_ptr->to_attr, &value);
-      }
+      return aggregate(attribute_count);
     } else {
       if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
         if(DB_ERROR(storage_put_row(handle->result_rel, result_row))) {
@@ -845,15 +1091,23 @@ relation_process_select(void *handle_ptr)
   return DB_OK;
 
 end_aggregation:
-  /* Generate aggregated result if requested. */
-  for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-    result_attr = attr_map_ptr->to_attr;
-    to_ptr = result_row + attr_map_ptr->to_offset;
+  /* Generate one aggregated result row per group. Without GROUP BY,
+     a result is generated even if no tuples were selected. */
+  if(!(handle->flags & DB_HANDLE_FLAG_AGGREGATED)) {
+    handle->flags |= DB_HANDLE_FLAG_AGGREGATED;
+    if(group_key == NULL && group_count == 0 &&
+       get_group(0, attribute_count) == NULL) {
+      return DB_LIMIT_ERROR;
+    }
+  }
+
+  if(next_group >= group_count) {
+    return DB_FINISHED;
+  }
 
-    intbuf[0] = result_attr->aggregation_value >> 8;
-    intbuf[1] = result_attr->aggregation_value & 0xff;
-    from_ptr = intbuf;
-    memcpy(to_ptr, from_ptr, result_attr->element_size);
+  result = generate_group_row(&groups[next_group++], attribute_count);
+  if(DB_ERROR(result)) {
+    return result;
   }
 
   if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
@@ -863,8 +1117,7 @@ end_aggregation:
     }
   }
 
-  handle->current_row = 1;
-  AQL_GET_FLAGS(adt) &= ~AQL_FLAG_AGGREGATE; /* Stop the aggregation. */
+  handle->current_row++;
 
   return DB_GOT_ROW;
 }
@@ -880,6 +1133,7 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
   attribute_t *attr;
   int i;
   int normal_attributes;
+  int aggregated_attributes;
 
   adt = (aql_adt_t *)adt_ptr;
 
@@ -903,7 +1157,8 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
     return DB_ALLOCATION_ERROR;
   }
 
-  for(i = normal_attributes = 0; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
+  normal_attributes = aggregated_attributes = 0;
+  for(i = 0; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
     attribute_name = adt->attributes[i].name;
 
     attr = relation_attribute_get(rel, attribute_name);
@@ -916,10 +1171,20 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
     PRINTF("DB: Found attribute %s in relation %s\n",
 	attribute_name, rel->name);
 
-    attr = relation_attribute_add(handle->result_rel, dir,
-				  attribute_name, 
-				  adt->aggregators[i] ? DOMAIN_INT : attr->domain,
-				  attr->element_size);
+    if((adt->attributes[i].flags & ATTRIBUTE_FLAG_GROUP) &&
+       attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) {
+      PRINTF("DB: Cannot group by the attribute %s\n", attribute_name);
+      return DB_TYPE_ERROR;
+    }
+
+    /* Aggregated values are computed as longs. */
+    if(adt->aggregators[i] == AQL_NONE) {
+      attr = relation_attribute_add(handle->result_rel, dir, attribute_name,
+                                    attr->domain, attr->element_size);
+    } else {
+      attr = relation_attribute_add(handle->result_rel, dir, attribute_name,
+                                    DOMAIN_LONG, 4);
+    }
     if(attr == NULL) {
       PRINTF("DB: Failed to add a result attribute\n");
       relation_release(handle->result_rel);
@@ -927,31 +1192,21 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
     }
 
     attr->aggregator = adt->aggregators[i];
-    switch(attr->aggregator) {
-    case AQL_NONE:
-      if(!(adt->attributes[i].flags & ATTRIBUTE_FLAG_NO_STORE)) {
-        /* Only count attributes projected into the result set. */
-        normal_attributes++;
-      }
-      break;
-    case AQL_MAX:
-      attr->aggregation_value = LONG_MIN;
-      break;
-    case AQL_MIN:
-      attr->aggregation_value = LONG_MAX;
-      break;
-    default:
-      attr->aggregation_value = 0;
-      break;
-    }
-
     attr->flags = adt->attributes[i].flags;
+
+    if(attr->aggregator != AQL_NONE) {
+      aggregated_attributes++;
+    } else if(!(attr->flags & (ATTRIBUTE_FLAG_NO_STORE | ATTRIBUTE_FLAG_GROUP))) {
+      /* Only count attributes projected into the result set. */
+      normal_attributes++;
+    }
   }
 
   /* Preclude mixes of normal attributes and aggregated ones in 
-     selection results. */
+     selection results. The attribute that the result is grouped
+     by is the only exception. */
   if(normal_attributes > 0 &&
-     handle->result_rel->attribute_count > normal_attributes) {
+     (AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE)) {
      return DB_RELATIONAL_ERROR;
   }
 
@@ -959,31 +1214,79 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
 }
 
 #if DB_FEATURE_JOIN
+/*
+ * Load the next tuple of the inner relation that matches the current
+ * join value of the outer relation into the right row buffer.
+ */
+static db_result_t
+join_next_inner(db_handle_t *handle)
+{
+  relation_t *right_rel;
+  tuple_id_t right_tuple_id;
+  attribute_value_t value;
+  db_result_t result;
+
+  right_rel = handle->right_rel;
+
+  if(handle->plan.method == DB_PLAN_INDEX_JOIN) {
+    /* Get all rows matching the attribute value in the right relation. */
+    right_tuple_id = index_get_next(&handle->index_iterator);
+    if(right_tuple_id == INVALID_TUPLE) {
+      return DB_FINISHED;
+    }
+
+    result = storage_get_row(right_rel, &right_tuple_id, right_row);
+    if(result == DB_FINISHED) {
+      PRINTF("DB: The index refers to an invalid row: %lu\n",
+             (unsigned long)right_tuple_id);
+      return DB_IMPLEMENTATION_ERROR;
+    }
+    return DB_ERROR(result) ? result : DB_GOT_ROW;
+  }
+
+  /* Without an index, scan the right relation from the position
+     stored in the iterator until the next matching row. */
+  for(;;) {
+    right_tuple_id = handle->index_iterator.next_item_no++;
+    result = storage_get_row(right_rel, &right_tuple_id, right_row);
+    if(result != DB_OK) {
+      return result;
+    }
+
+    if(DB_ERROR(relation_get_value(right_rel, handle->right_join_attr,
+                                   right_row, &value))) {
+      return DB_IMPLEMENTATION_ERROR;
+    }
+
+    if(db_value_to_long(&value) ==
+       db_value_to_long(&handle->index_iterator.min_value)) {
+      return DB_GOT_ROW;
+    }
+  }
+}
+
 db_result_t
 relation_process_join(void *handle_ptr)
 {
   db_handle_t *handle;
   db_result_t result;
   relation_t *left_rel;
-  relation_t *right_rel;
   relation_t *join_rel;
   unsigned char *join_next_attribute_ptr;
   size_t element_size;
-  tuple_id_t right_tuple_id;
   attribute_value_t value;
   int i;
 
   handle = (db_handle_t *)handle_ptr;
   left_rel = handle->left_rel;
-  right_rel = handle->right_rel;
   join_rel = handle->join_rel;
 
   if(!(handle->flags & DB_HANDLE_FLAG_INDEX_STEP)) {
     goto inner_loop;
   }
 
-  /* Equi-join for indexed attributes only. In the outer loop, we iterate over
-     each tuple in the left relation. */
+  /* Equi-join on the attribute chosen by the planner. In the outer loop, 
+     we iterate over each tuple in the left relation. */
   for(handle->tuple_id = 0;; handle->tuple_id++) {
     result = storage_get_row(left_rel, &handle->tuple_id, left_row);
     if(DB_ERROR(result)) {
@@ -999,37 +1302,36 @@ relation_process_join(void *handle_ptr)
       return DB_IMPLEMENTATION_ERROR;
     }
 
-    if(DB_ERROR(index_get_iterator(&handle->index_iterator, 
-                                   handle->right_join_attr->index, 
-                                   &value, &value))) { 
-      PRINTF("DB: Failed to get an index iterator\n");
-      return DB_INDEX_ERROR;
+    if(handle->plan.method == DB_PLAN_INDEX_JOIN) {
+      if(DB_ERROR(index_get_iterator(&handle->index_iterator, 
+                                     handle->right_join_attr->index, 
+                                     &value, &value))) { 
+        PRINTF("DB: Failed to get an index iterator\n");
+        return DB_INDEX_ERROR;
+      }
+    } else {
+      handle->index_iterator.index = NULL;
+      handle->index_iterator.min_value = value;
+      handle->index_iterator.next_item_no = 0;
     }
     handle->flags &= ~DB_HANDLE_FLAG_INDEX_STEP;
 
     /* In the inner loop, we iterate over all rows with a matching value for the
-       join attribute. The index component provides an iterator for this purpose. */
+       join attribute. */
 inner_loop:
     for(;;) {
-      /* Get all rows matching the attribute value in the right relation. */
-      right_tuple_id = index_get_next(&handle->index_iterator);
-      if(right_tuple_id == INVALID_TUPLE) {
+      result = join_next_inner(handle);
+      if(DB_ERROR(result)) {
+        PRINTF("DB: Failed to get a row in right relation %s!\n",
+               handle->right_rel->name);
+        return result;
+      } else if(result == DB_FINISHED) {
         /* Exclude this row from the left relation in the result,
            and step to the next value in the index iteration. */
         handle->flags |= DB_HANDLE_FLAG_INDEX_STEP;
         break;
       }
 
-      result = storage_get_row(right_rel, &right_tuple_id, right_row);
-      if(DB_ERROR(result)) {
-        PRINTF("DB: Failed to get a row in right relation %s!\n", right_rel->name);
-        return result;
-      } else if(result == DB_FINISHED) {
-	PRINTF("DB: The index refers to an invalid row: %lu\n",
-	       (unsigned long)right_tuple_id);
-        return DB_IMPLEMENTATION_ERROR;
-      }
-
       /* Use the source attribute map to fill in the physical representation
 	 of the resulting tuple. */
       join_next_attribute_ptr = join_row;
@@ -1055,11 +1357,106 @@ inner_loop:
   return DB_OK;
 }
 
+static unsigned long
+join_cost(tuple_id_t outer_cardinality, unsigned long probe_cost)
+{
+  if(probe_cost == ULONG_MAX ||
+     (outer_cardinality > 0 && probe_cost > ULONG_MAX / outer_cardinality)) {
+    return ULONG_MAX;
+  }
+
+  return outer_cardinality * probe_cost + outer_cardinality;
+}
+
+/*
+ * Choose the join method and the order of the relations. An index
+ * nested-loop join is possible if the join attribute is indexed in
+ * either relation; the indexed relation then becomes the inner one.
+ * A plain nested-loop join, which scans the inner relation once for
+ * each outer tuple, is the fallback if no index can be used.
+ */
 static db_result_t
-generate_join_result(db_handle_t *handle)
+plan_join(db_handle_t *handle)
 {
-  relation_t *left_rel;
-  relation_t *right_rel;
+  relation_t *rel;
+  attribute_t *attr;
+  tuple_id_t left_cardinality;
+  tuple_id_t right_cardinality;
+  tuple_id_t rows;
+  unsigned long cost;
+  int swap;
+
+  left_cardinality = relation_cardinality(handle->left_rel);
+  right_cardinality = relation_cardinality(handle->right_rel);
+  if(left_cardinality == INVALID_TUPLE || right_cardinality == INVALID_TUPLE) {
+    return DB_STORAGE_ERROR;
+  }
+
+  handle->plan.method = DB_PLAN_NONE;
+  handle->plan.cost = ULONG_MAX;
+  swap = 0;
+
+  if(handle->left_join_attr->domain != DOMAIN_STRING) {
+    handle->plan.method = DB_PLAN_NESTED_LOOP_JOIN;
+    swap = right_cardinality < left_cardinality;
+    if(swap) {
+      handle->plan.cost = join_cost(right_cardinality, left_cardinality);
+      handle->plan.rows = left_cardinality;
+    } else {
+      handle->plan.cost = join_cost(left_cardinality, right_cardinality);
+      handle->plan.rows = right_cardinality;
+    }
+  }
+
+  if(index_exists(handle->right_join_attr)) {
+    cost = join_cost(left_cardinality,
+                     index_get_cost(handle->right_join_attr->index, 0, 0, &rows));
+    if(cost <= handle->plan.cost) {
+      handle->plan.method = DB_PLAN_INDEX_JOIN;
+      handle->plan.cost = cost;
+      handle->plan.rows = rows;
+      swap = 0;
+    }
+  }
+
+  if(index_exists(handle->left_join_attr)) {
+    cost = join_cost(right_cardinality,
+                     index_get_cost(handle->left_join_attr->index, 0, 0, &rows));
+    if(cost < handle->plan.cost) {
+      handle->plan.method = DB_PLAN_INDEX_JOIN;
+      handle->plan.cost = cost;
+      handle->plan.rows = rows;
+      swap = 1;
+    }
+  }
+
+  if(handle->plan.method == DB_PLAN_NONE) {
+    PRINTF("DB: No way to join on the attribute %s\n",
+           handle->left_join_attr->name);
+    return DB_INDEX_ERROR;
+  }
+
+  if(swap) {
+    rel = handle->left_rel;
+    handle->left_rel = handle->right_rel;
+    handle->right_rel = rel;
+    attr = handle->left_join_attr;
+    handle->left_join_attr = handle->right_join_attr;
+    handle->right_join_attr = attr;
+  }
+  handle->plan.attr = handle->right_join_attr;
+
+  PRINTF("DB: Join plan %d with %s as the inner relation; cost %lu\n",
+         handle->plan.method, handle->right_rel->name, handle->plan.cost);
+
+  return DB_OK;
+}
+
+static db_result_t
+generate_join_result(db_handle_t *handle, relation_t *first_rel,
+                     relation_t *second_rel)
+{
+  relation_t *rel;
   relation_t *join_rel;
   attribute_t *attr;
   attribute_t *result_attr;
@@ -1071,32 +1468,33 @@ generate_join_result(db_handle_t *handle)
   handle->tuple = (tuple_t)join_row;
   handle->tuple_id = 0;
 
-  left_rel = handle->left_rel;
-  right_rel = handle->right_rel;
   join_rel = handle->join_rel;
 
   /* Generate a map over the source attributes for each
-     attribute in the join relation. */
+     attribute in the join relation. The attributes are looked up
+     in the order that the relations were given in the query, 
+     regardless of which one the planner selected as the outer. */
   for(i = 0, result_attr = list_head(join_rel->attributes);
       result_attr != NULL; 
       result_attr = result_attr->next, i++) {
     source_pair = &source_map[i];
-    attr = attribute_find(left_rel, result_attr->name);
-    if(attr != NULL) {
-      offset = get_attribute_value_offset(left_rel, attr);
-      from_ptr = left_row + offset;
-    } else if((attr = attribute_find(right_rel, result_attr->name)) != NULL) {
-      offset = get_attribute_value_offset(right_rel, attr);
-      from_ptr = right_row + offset;
-    } else {
+    rel = first_rel;
+    attr = attribute_find(rel, result_attr->name);
+    if(attr == NULL) {
+      rel = second_rel;
+      attr = attribute_find(rel, result_attr->name);
+    }
+    if(attr == NULL) {
       PRINTF("DB: The attribute %s could not be found\n", result_attr->name);
       return DB_NAME_ERROR;
     }
 
+    offset = get_attribute_value_offset(rel, attr);
     if(offset < 0) {
       PRINTF("DB: Unable to retrieve attribute values for the JOIN result\n");
       return DB_IMPLEMENTATION_ERROR;
     }
+    from_ptr = (rel == handle->left_rel ? left_row : right_row) + offset;
     
     source_pair->attr = attr;
     source_pair->from_ptr = from_ptr;
@@ -1120,6 +1518,7 @@ relation_join(void *query_result, void *adt_ptr)
   int i;
   char *attribute_name;
   attribute_t *attr;
+  db_result_t result;
 
   adt = (aql_adt_t *)adt_ptr;
 
@@ -1158,9 +1557,9 @@ relation_join(void *query_result, void *adt_ptr)
     return DB_RELATIONAL_ERROR;
   }
 
-  if(!index_exists(handle->right_join_attr)) {
-    PRINTF("DB: The attribute to join on is not indexed\n");
-    return DB_INDEX_ERROR;
+  result = plan_join(handle);
+  if(DB_ERROR(result)) {
+    return result;
   }
 
   /*
@@ -1189,7 +1588,7 @@ relation_join(void *query_result, void *adt_ptr)
     handle->ncolumns++;
   }
 
-  return generate_join_result(handle);
+  return generate_join_result(handle, left_rel, right_rel);
 }
 #endif /* DB_FEATURE_JOIN */
 
@@ -49,6 +49,32 @@ typedef unsigned char *tuple_t;
 #define DB_HANDLE_FLAG_INDEX_STEP	0x01
 #define DB_HANDLE_FLAG_SEARCH_INDEX	0x02
 #define DB_HANDLE_FLAG_PROCESSING	0x04
+#define DB_HANDLE_FLAG_COMPILED		0x08
+#define DB_HANDLE_FLAG_AGGREGATED	0x10
+
+/* Access methods that the query planner can choose between. */
+typedef enum {
+  DB_PLAN_NONE = 0,
+  DB_PLAN_SCAN = 1,
+  DB_PLAN_INDEX = 2,
+  DB_PLAN_INDEX_JOIN = 3,
+  DB_PLAN_NESTED_LOOP_JOIN = 4
+} db_plan_method_t;
+
+/*
+ * The plan chosen for a query. The attribute is the one whose index
+ * is used to access the relation, or the join attribute of the inner
+ * relation in a join. The cost is given in units of sequential tuple
+ * reads, and the rows are the estimated number of tuples read through
+ * the access method (per outer tuple in the case of joins).
+ */
+struct db_plan {
+  attribute_t *attr;
+  unsigned long cost;
+  tuple_id_t rows;
+  uint8_t method;
+};
+typedef struct db_plan db_plan_t;
 
 struct db_handle {
   index_iterator_t index_iterator;
@@ -61,6 +87,7 @@ struct db_handle {
   relation_t *result_rel;
   attribute_t *left_join_attr;
   attribute_t *right_join_attr;
+  db_plan_t plan;
   tuple_t tuple;
   uint8_t flags;
   uint8_t ncolumns;
@@ -68,6 +68,28 @@ struct index_record {
 
 #define ROW_XOR 0xf6U
 
+#if DB_STORAGE_READ_BUFFER_SIZE > 0
+/* Consecutive tuples read ahead from a relation, in stored form. */
+static struct {
+  relation_t *rel;
+  tuple_id_t first;
+  tuple_id_t count;
+  unsigned char data[DB_STORAGE_READ_BUFFER_SIZE];
+} read_buffer;
+#endif /* DB_STORAGE_READ_BUFFER_SIZE > 0 */
+
+#if DB_STORAGE_WRITE_BUFFER_SIZE > 0
+/* Tuples that have been inserted into a relation, but not yet
+   appended to its tuple file. */
+static struct {
+  relation_t *rel;
+  unsigned length;
+  /* Bytes of the first tuple that already are in the tuple file. */
+  unsigned written;
+  unsigned char data[DB_STORAGE_WRITE_BUFFER_SIZE];
+} write_buffer;
+#endif /* DB_STORAGE_WRITE_BUFFER_SIZE > 0 */
+
 static void
 merge_strings(char *dest, char *prefix, char *suffix)
 {
@@ -75,6 +97,127 @@ merge_strings(char *dest, char *prefix, char *suffix)
   strcat(dest, suffix);
 }
 
+static void
+discard_buffers(relation_t *rel)
+{
+#if DB_STORAGE_READ_BUFFER_SIZE > 0
+  if(read_buffer.rel == rel) {
+    read_buffer.rel = NULL;
+  }
+#endif
+#if DB_STORAGE_WRITE_BUFFER_SIZE > 0
+  if(write_buffer.rel == rel) {
+    write_buffer.rel = NULL;
+    write_buffer.length = 0;
+    write_buffer.written = 0;
+  }
+#endif
+}
+
+static db_result_t
+get_file_rows(relation_t *rel, tuple_id_t *amount)
+{
+  cfs_offset_t offset;
+
+  offset = cfs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
+  if(offset == (cfs_offset_t)-1) {
+    return DB_STORAGE_ERROR;
+  }
+
+  *amount = (tuple_id_t)(offset / rel->row_length);
+  return DB_OK;
+}
+
+static db_result_t
+read_rows(relation_t *rel, tuple_id_t tuple_id, unsigned char *ptr,
+          unsigned length)
+{
+  int r;
+
+  PRINTF("DB: Read %u bytes from relation %s\n", length, rel->name);
+
+  if(cfs_seek(rel->tuple_storage, tuple_id * rel->row_length, CFS_SEEK_SET) ==
+              (cfs_offset_t)-1) {
+    return DB_STORAGE_ERROR;
+  }
+
+  while(length > 0) {
+    r = cfs_read(rel->tuple_storage, ptr, length);
+    if(r <= 0) {
+      PRINTF("DB: Reading failed on fd %d\n", rel->tuple_storage);
+      return DB_STORAGE_ERROR;
+    }
+    ptr += r;
+    length -= r;
+  }
+
+  return DB_OK;
+}
+
+/* Append stored rows to the tuple file of a relation, which does not
+   have to be loaded. On return, *length holds the number of bytes
+   that could not be written. */
+static db_result_t
+write_rows(relation_t *rel, unsigned char *ptr, unsigned *length)
+{
+  int fd;
+  int r;
+  db_result_t result;
+#if DB_FEATURE_INTEGRITY
+  cfs_offset_t end;
+  int missing_bytes;
+  char buf[rel->row_length];
+#endif
+
+  fd = rel->tuple_storage;
+  if(fd < 0) {
+    fd = cfs_open(rel->tuple_filename, CFS_READ | CFS_WRITE | CFS_APPEND);
+    if(fd < 0) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  result = DB_STORAGE_ERROR;
+
+#if DB_FEATURE_INTEGRITY
+  end = cfs_seek(fd, 0, CFS_SEEK_END);
+  if(end == (cfs_offset_t)-1) {
+    goto end;
+  }
+
+  missing_bytes = end % rel->row_length;
+  if(missing_bytes > 0) {
+    memset(buf, 0xff, sizeof(buf));
+    r = cfs_write(fd, buf, sizeof(buf));
+    if(r != missing_bytes) {
+      goto end;
+    }
+  }
+#else
+  if(cfs_seek(fd, 0, CFS_SEEK_END) == (cfs_offset_t)-1) {
+    goto end;
+  }
+#endif
+
+  while(*length > 0) {
+    r = cfs_write(fd, ptr, *length);
+    if(r < 0) {
+      PRINTF("DB: Failed to store %u bytes\n", *length);
+      goto end;
+    }
+    ptr += r;
+    *length -= r;
+  }
+
+  result = DB_OK;
+
+end:
+  if(fd != rel->tuple_storage) {
+    cfs_close(fd);
+  }
+  return result;
+}
+
 char *
 storage_generate_file(char *prefix, unsigned long size)
 {
@@ -279,6 +422,12 @@ storage_put_attribute(relation_t *rel, attribute_t *attr)
 db_result_t
 storage_drop_relation(relation_t *rel, int remove_tuples)
 {
+  if(remove_tuples) {
+    discard_buffers(rel);
+  } else if(DB_ERROR(storage_release(rel))) {
+    return DB_STORAGE_ERROR;
+  }
+
   if(remove_tuples && RELATION_HAS_TUPLES(rel)) {
     cfs_remove(rel->tuple_filename);
   }
@@ -295,6 +444,12 @@ storage_rename_relation(char *old_name, char *new_name)
   int r;
   char buf[64];
 
+  /* The relation that is renamed may have tuples waiting to be
+     written under its old name. */
+  if(DB_ERROR(storage_flush(NULL))) {
+    return DB_STORAGE_ERROR;
+  }
+
   result = DB_STORAGE_ERROR;
   old_fd = new_fd = -1;
 
@@ -403,108 +558,198 @@ storage_put_index(index_t *index)
 db_result_t
 storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
 {
-  int r;
   tuple_id_t nrows;
+#if DB_STORAGE_READ_BUFFER_SIZE > 0
+  tuple_id_t count;
+#endif
+
+#if DB_STORAGE_READ_BUFFER_SIZE > 0
+  if(read_buffer.rel == rel && *tuple_id >= read_buffer.first &&
+     *tuple_id - read_buffer.first < read_buffer.count) {
+    memcpy(row, read_buffer.data +
+           (*tuple_id - read_buffer.first) * rel->row_length,
+           rel->row_length);
+    goto decode;
+  }
+#endif /* DB_STORAGE_READ_BUFFER_SIZE > 0 */
 
-  if(DB_ERROR(storage_get_row_amount(rel, &nrows))) {
+  if(rel->row_length == 0 || DB_ERROR(get_file_rows(rel, &nrows))) {
     return DB_STORAGE_ERROR;
   }
 
   if(*tuple_id >= nrows) {
+#if DB_STORAGE_WRITE_BUFFER_SIZE > 0
+    /* The tuple may still be in the insert buffer. */
+    if(write_buffer.rel == rel &&
+       (*tuple_id - nrows) * rel->row_length < write_buffer.length) {
+      memcpy(row, write_buffer.data + (*tuple_id - nrows) * rel->row_length,
+             rel->row_length);
+      goto decode;
+    }
+#endif /* DB_STORAGE_WRITE_BUFFER_SIZE > 0 */
     return DB_FINISHED;
   }
 
-  if(cfs_seek(rel->tuple_storage, *tuple_id * rel->row_length, CFS_SEEK_SET) ==
-              (cfs_offset_t)-1) {
-    return DB_STORAGE_ERROR;
+#if DB_STORAGE_READ_BUFFER_SIZE > 0
+  if(rel->row_length <= sizeof(read_buffer.data)) {
+    /* Read ahead as many of the following tuples as will fit. */
+    count = sizeof(read_buffer.data) / rel->row_length;
+    if(count > nrows - *tuple_id) {
+      count = nrows - *tuple_id;
+    }
+
+    read_buffer.rel = NULL;
+    if(DB_ERROR(read_rows(rel, *tuple_id, read_buffer.data,
+                          count * rel->row_length))) {
+      return DB_STORAGE_ERROR;
+    }
+    read_buffer.rel = rel;
+    read_buffer.first = *tuple_id;
+    read_buffer.count = count;
+
+    memcpy(row, read_buffer.data, rel->row_length);
+    goto decode;
   }
+#endif /* DB_STORAGE_READ_BUFFER_SIZE > 0 */
 
-  r = cfs_read(rel->tuple_storage, row, rel->row_length);
-  if(r < 0) {
-    PRINTF("DB: Reading failed on fd %d\n", rel->tuple_storage);
-    return DB_STORAGE_ERROR;
-  } else if(r == 0) {
-    return DB_FINISHED;
-  } else if(r < rel->row_length) {
-    PRINTF("DB: Incomplete record: %d < %d\n", r, rel->row_length);
+  if(DB_ERROR(read_rows(rel, *tuple_id, row, rel->row_length))) {
     return DB_STORAGE_ERROR;
   }
 
+#if DB_STORAGE_READ_BUFFER_SIZE > 0 || DB_STORAGE_WRITE_BUFFER_SIZE > 0
+decode:
+#endif
   row[rel->row_length - 1] ^= ROW_XOR;
 
-  PRINTF("DB: Read %d bytes from relation %s\n", rel->row_length, rel->name);
-
   return DB_OK;
 }
 
 db_result_t
 storage_put_row(relation_t *rel, storage_row_t row)
 {
-  cfs_offset_t end;
-  unsigned remaining;
-  int r;
+  db_result_t result;
   unsigned char *last_byte;
-#if DB_FEATURE_INTEGRITY
-  int missing_bytes;
-  char buf[rel->row_length];
-#endif
+  unsigned length;
+
+#if DB_STORAGE_WRITE_BUFFER_SIZE > 0
+  if(rel->row_length <= sizeof(write_buffer.data)) {
+    /* The buffer may still be full if the last flush failed. */
+    if((write_buffer.rel != rel ||
+        write_buffer.length + rel->row_length > sizeof(write_buffer.data)) &&
+       DB_ERROR(storage_flush(NULL))) {
+      return DB_STORAGE_ERROR;
+    }
 
-  end = cfs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
-  if(end == (cfs_offset_t)-1) {
-    return DB_STORAGE_ERROR;
-  }
+    write_buffer.rel = rel;
+    last_byte = write_buffer.data + write_buffer.length + rel->row_length - 1;
+    memcpy(write_buffer.data + write_buffer.length, row, rel->row_length);
+    *last_byte ^= ROW_XOR;
+    write_buffer.length += rel->row_length;
 
-#if DB_FEATURE_INTEGRITY
-  missing_bytes = end % rel->row_length;
-  if(missing_bytes > 0) {
-    memset(buf, 0xff, sizeof(buf));
-    r = cfs_write(rel->tuple_storage, buf, sizeof(buf));
-    if(r != missing_bytes) {
-      return DB_STORAGE_ERROR;
+    /* Write the buffer as soon as it cannot hold another tuple. */
+    if(write_buffer.length + rel->row_length > sizeof(write_buffer.data)) {
+      return storage_flush(rel);
     }
+    return DB_OK;
   }
-#endif
+
+  /* Keep the tuples in insertion order. */
+  if(DB_ERROR(storage_flush(NULL))) {
+    return DB_STORAGE_ERROR;
+  }
+#endif /* DB_STORAGE_WRITE_BUFFER_SIZE > 0 */
 
   /* Ensure that last written byte is separated from 0, to make file
      lengths correct in Coffee. */
   last_byte = row + rel->row_length - 1;
   *last_byte ^= ROW_XOR;
 
-  remaining = rel->row_length;
-  do {
-    r = cfs_write(rel->tuple_storage, row, remaining);
-    if(r < 0) {
-      PRINTF("DB: Failed to store %u bytes\n", remaining);
-      *last_byte ^= ROW_XOR;
-      return DB_STORAGE_ERROR;
-    }
-    row += r;
-    remaining -= r;
-  } while(remaining > 0);
-
-  PRINTF("DB: Stored a of %d bytes\n", rel->row_length);
+  length = rel->row_length;
+  result = write_rows(rel, row, &length);
 
   *last_byte ^= ROW_XOR;
 
-  return DB_OK;
+  PRINTF("DB: Stored a of %d bytes\n", rel->row_length);
+
+  return result;
 }
 
 db_result_t
 storage_get_row_amount(relation_t *rel, tuple_id_t *amount)
 {
-  cfs_offset_t offset;
-
   if(rel->row_length == 0) {
     *amount = 0;
-  } else {
-    offset = cfs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
-    if(offset == (cfs_offset_t)-1) {
-      return DB_STORAGE_ERROR;
-    }
+    return DB_OK;
+  }
+
+  if(DB_ERROR(get_file_rows(rel, amount))) {
+    return DB_STORAGE_ERROR;
+  }
+
+#if DB_STORAGE_WRITE_BUFFER_SIZE > 0
+  if(write_buffer.rel == rel) {
+    *amount += write_buffer.length / rel->row_length;
+  }
+#endif
+
+  return DB_OK;
+}
+
+db_result_t
+storage_flush(relation_t *rel)
+{
+#if DB_STORAGE_WRITE_BUFFER_SIZE > 0
+  db_result_t result;
+  unsigned remaining;
+  unsigned written;
 
-    *amount = (tuple_id_t)(offset / rel->row_length);
+  if(write_buffer.length == 0 || (rel != NULL && rel != write_buffer.rel)) {
+    return DB_OK;
   }
 
+  PRINTF("DB: Flushing %u bytes to relation %s\n",
+         write_buffer.length, write_buffer.rel->name);
+
+  remaining = write_buffer.length - write_buffer.written;
+  result = write_rows(write_buffer.rel,
+                      write_buffer.data + write_buffer.written, &remaining);
+
+  /*
+   * Keep the tuples that were not written, so that the caller can
+   * retry the flush. Tuples that reached the file before the failure
+   * are dropped from the buffer to avoid storing them twice.
+   */
+  written = write_buffer.length - remaining;
+#if DB_FEATURE_INTEGRITY
+  /* The next write pads a partly written tuple to a whole row, so the
+     tuple is written again in full after it. */
+  write_buffer.written = 0;
+#else
+  /* The tuple file ends with the first bytes of a tuple. Only the rest
+     of it is written by the next flush, so that the rows stay aligned. */
+  write_buffer.written = written % write_buffer.rel->row_length;
+#endif
+  written -= written % write_buffer.rel->row_length;
+  memmove(write_buffer.data, write_buffer.data + written,
+          write_buffer.length - written);
+  write_buffer.length -= written;
+
+  return result;
+#else
+  return DB_OK;
+#endif /* DB_STORAGE_WRITE_BUFFER_SIZE > 0 */
+}
+
+db_result_t
+storage_release(relation_t *rel)
+{
+  /* Keep the buffered tuples if they cannot be written, so that the
+     release can be retried. */
+  if(DB_ERROR(storage_flush(rel))) {
+    PRINTF("DB: Failed to flush the tuples of relation %s\n", rel->name);
+    return DB_STORAGE_ERROR;
+  }
+  discard_buffers(rel);
   return DB_OK;
 }
 
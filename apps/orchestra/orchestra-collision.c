@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Orchestra: detection of persistent collisions in the unicast slotframe.
+ *         Nodes map to timeslots by hashing their link-layer address, so that
+ *         in dense networks, neighbors may end up sharing a timeslot. We compare
+ *         the failure ratio of the transmissions in the unicast slotframe to that
+ *         in shared timeslots; when it is much higher for a neighbor, the node
+ *         owning the timeslot (us in sender-based mode, the neighbor in
+ *         receiver-based mode) adds a new salt to its hash. Salts, and
+ *         collisions detected in receiver-based mode, are exchanged in an RPL
+ *         DIO option.
+ *
+ * \author agent <agent@local>
+ */
+
+#include "contiki.h"
+#include "orchestra.h"
+#include "net/packetbuf.h"
+#include "net/nbr-table.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/rpl/rpl-private.h"
+#include "lib/random.h"
+#include <string.h>
+
+#define DEBUG DEBUG_NONE
+#include "net/ip/uip-debug.h"
+
+#if ORCHESTRA_COLLISION_DETECTION
+
+#if !TSCH_WITH_LINK_STATISTICS
+#error "Orchestra collision detection requires TSCH_WITH_LINK_STATISTICS"
+#endif
+
+#if ORCHESTRA_UNICAST_PERIOD < 2 || ORCHESTRA_UNICAST_PERIOD > 256
+#error "Orchestra collision detection requires 2 <= ORCHESTRA_UNICAST_PERIOD <= 256"
+#endif
+
+/* Failure ratios are fixed-point, RATIO_ONE being 100%, averaged over
+ * transmissions with an EWMA of weight 1/RATIO_EWMA_DIV */
+#define RATIO_ONE 256
+#define RATIO_EWMA_DIV 8
+#define RATIO_THRESHOLD ((ORCHESTRA_COLLISION_THRESHOLD * RATIO_ONE) / 100)
+
+/* Option: salt, then per report: link-layer address of the timeslot owner, salt */
+#define OPTION_HDR_LEN 3
+#define OPTION_REPORT_LEN (LINKADDR_SIZE + 1)
+
+struct orchestra_nbr {
+  /* The salt of the neighbor, as announced in its DIOs */
+  uint8_t salt;
+  /* Transmissions to the neighbor in the unicast slotframe, since the last
+   * salt change, and their failure ratio */
+  uint8_t tx_count;
+  uint16_t fail_ratio;
+};
+NBR_TABLE(struct orchestra_nbr, orchestra_nbrs);
+
+/* A collision in the timeslot of a neighbor, to be reported in our DIOs */
+struct collision_report {
+  linkaddr_t addr;
+  uint8_t salt;
+  uint8_t dios_left;
+};
+
+static uint8_t own_salt = 0;
+static uint16_t shared_fail_ratio = 0;
+static int slotframe_handle = -1;
+#if !ORCHESTRA_UNICAST_SENDER_BASED
+static struct collision_report reports[ORCHESTRA_COLLISION_MAX_REPORTS];
+#endif
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+update_ratio(uint16_t ratio, int transmissions, int failures)
+{
+  /* One EWMA update per transmission, the failed ones last */
+  while(transmissions-- > 0) {
+    ratio = (ratio * (RATIO_EWMA_DIV - 1) + (transmissions < failures ? RATIO_ONE : 0)) / RATIO_EWMA_DIV;
+  }
+  return ratio;
+}
+/*---------------------------------------------------------------------------*/
+static void
+reset_nbr_stats(void)
+{
+  struct orchestra_nbr *n = nbr_table_head(orchestra_nbrs);
+  while(n != NULL) {
+    n->tx_count = 0;
+    n->fail_ratio = 0;
+    n = nbr_table_next(orchestra_nbrs, n);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+announce(void)
+{
+  /* Send DIOs soon, to spread a new salt or a report */
+  if(default_instance != NULL) {
+    rpl_reset_dio_timer(default_instance);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+resalt(void)
+{
+  /* Move to any other timeslot of the period */
+  own_salt = (own_salt + 1 + random_rand() % (ORCHESTRA_UNICAST_PERIOD - 1)) % ORCHESTRA_UNICAST_PERIOD;
+  PRINTF("Orchestra: new salt %u\n", own_salt);
+  /* Our links all moved, start over the statistics */
+  reset_nbr_stats();
+  orchestra_salt_changed(&linkaddr_node_addr);
+  announce();
+}
+/*---------------------------------------------------------------------------*/
+#if !ORCHESTRA_UNICAST_SENDER_BASED
+static void
+add_report(const linkaddr_t *addr, uint8_t salt)
+{
+  int i;
+  struct collision_report *r = NULL;
+  for(i = 0; i < ORCHESTRA_COLLISION_MAX_REPORTS; i++) {
+    if(reports[i].dios_left > 0 && linkaddr_cmp(&reports[i].addr, addr)) {
+      r = &reports[i];
+      break;
+    }
+    if(r == NULL && reports[i].dios_left == 0) {
+      r = &reports[i];
+    }
+  }
+  if(r != NULL) {
+    linkaddr_copy(&r->addr, addr);
+    r->salt = salt;
+    r->dios_left = ORCHESTRA_COLLISION_REPORT_DIOS;
+    announce();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+clear_report(const linkaddr_t *addr)
+{
+  int i;
+  for(i = 0; i < ORCHESTRA_COLLISION_MAX_REPORTS; i++) {
+    if(linkaddr_cmp(&reports[i].addr, addr)) {
+      reports[i].dios_left = 0;
+    }
+  }
+}
+#endif /* !ORCHESTRA_UNICAST_SENDER_BASED */
+/*---------------------------------------------------------------------------*/
+static void
+collision_detected(const linkaddr_t *addr, struct orchestra_nbr *n)
+{
+  PRINTF("Orchestra: collision with %u, failures %u/%u vs %u/%u\n",
+         addr->u8[LINKADDR_SIZE - 1], n->fail_ratio, RATIO_ONE, shared_fail_ratio, RATIO_ONE);
+#if ORCHESTRA_UNICAST_SENDER_BASED
+  /* The timeslot is ours */
+  resalt();
+#else /* ORCHESTRA_UNICAST_SENDER_BASED */
+  /* The timeslot is the neighbor's, ask it to move */
+  n->tx_count = 0;
+  n->fail_ratio = 0;
+  add_report(addr, n->salt);
+#endif /* ORCHESTRA_UNICAST_SENDER_BASED */
+}
+/*---------------------------------------------------------------------------*/
+void
+orchestra_collision_packet_sent(int mac_status)
+{
+  const linkaddr_t *dest = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
+  int transmissions = packetbuf_attr(PACKETBUF_ATTR_TSCH_TRANSMISSIONS);
+  int failures;
+  struct orchestra_nbr *n;
+
+  if(linkaddr_cmp(dest, &linkaddr_null) || transmissions == 0
+     || (mac_status != MAC_TX_OK && mac_status != MAC_TX_NOACK)) {
+    return;
+  }
+  failures = mac_status == MAC_TX_OK ? transmissions - 1 : transmissions;
+
+  if(packetbuf_attr(PACKETBUF_ATTR_TSCH_SLOTFRAME) != slotframe_handle) {
+    shared_fail_ratio = update_ratio(shared_fail_ratio, transmissions, failures);
+    return;
+  }
+
+  n = nbr_table_get_from_lladdr(orchestra_nbrs, dest);
+  if(n == NULL) {
+    /* A neighbor we have no DIO from yet, hence with salt 0 */
+    n = nbr_table_add_lladdr(orchestra_nbrs, dest);
+    if(n == NULL) {
+      return;
+    }
+  }
+  n->fail_ratio = update_ratio(n->fail_ratio, transmissions, failures);
+  n->tx_count = MIN(255, n->tx_count + transmissions);
+
+  if(n->tx_count >= ORCHESTRA_COLLISION_MIN_TX
+     && n->fail_ratio > shared_fail_ratio + RATIO_THRESHOLD) {
+    collision_detected(dest, n);
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+orchestra_collision_get_salt(const linkaddr_t *addr)
+{
+  struct orchestra_nbr *n;
+  if(linkaddr_cmp(addr, &linkaddr_node_addr)) {
+    return own_salt;
+  }
+  n = nbr_table_get_from_lladdr(orchestra_nbrs, addr);
+  return n != NULL ? n->salt : 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_nbr_salt(const linkaddr_t *addr, uint8_t salt)
+{
+  struct orchestra_nbr *n = nbr_table_get_from_lladdr(orchestra_nbrs, addr);
+  if(n == NULL) {
+    if(salt == 0) {
+      return;
+    }
+    n = nbr_table_add_lladdr(orchestra_nbrs, addr);
+    if(n == NULL) {
+      return;
+    }
+  } else if(n->salt == salt) {
+    return;
+  }
+  PRINTF("Orchestra: salt of %u is %u\n", addr->u8[LINKADDR_SIZE - 1], salt);
+  n->salt = salt;
+  n->tx_count = 0;
+  n->fail_ratio = 0;
+#if !ORCHESTRA_UNICAST_SENDER_BASED
+  /* The neighbor moved, our report is outdated */
+  clear_report(addr);
+#endif
+  orchestra_salt_changed(addr);
+}
+/*---------------------------------------------------------------------------*/
+void
+orchestra_callback_dio_option_input(const uip_ipaddr_t *from, const uint8_t *option, int len)
+{
+  const uip_lladdr_t *lladdr;
+  int i;
+
+  if(option[0] != ORCHESTRA_COLLISION_DIO_OPTION || len < OPTION_HDR_LEN) {
+    return;
+  }
+  lladdr = uip_ds6_nbr_lladdr_from_ipaddr(from);
+  if(lladdr == NULL) {
+    return;
+  }
+  set_nbr_salt((const linkaddr_t *)lladdr, option[2]);
+
+  /* Reports of a collision in our timeslot. A report with an older salt
+   * of ours is outdated, we moved already */
+  for(i = OPTION_HDR_LEN; i + OPTION_REPORT_LEN <= len; i += OPTION_REPORT_LEN) {
+    if(memcmp(&option[i], &linkaddr_node_addr, LINKADDR_SIZE) == 0
+       && option[i + LINKADDR_SIZE] == own_salt) {
+      PRINTF("Orchestra: collision reported by %u\n", lladdr->addr[LINKADDR_SIZE - 1]);
+      resalt();
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+orchestra_callback_dio_option_output(uint8_t *buf, int max_len)
+{
+  int pos = 0;
+#if !ORCHESTRA_UNICAST_SENDER_BASED
+  int i;
+#endif
+
+  if(max_len < OPTION_HDR_LEN) {
+    return 0;
+  }
+  buf[pos++] = ORCHESTRA_COLLISION_DIO_OPTION;
+  pos++; /* Option length, set below */
+  buf[pos++] = own_salt;
+#if !ORCHESTRA_UNICAST_SENDER_BASED
+  for(i = 0; i < ORCHESTRA_COLLISION_MAX_REPORTS; i++) {
+    if(reports[i].dios_left > 0 && pos + OPTION_REPORT_LEN <= max_len) {
+      memcpy(&buf[pos], &reports[i].addr, LINKADDR_SIZE);
+      pos += LINKADDR_SIZE;
+      buf[pos++] = reports[i].salt;
+      reports[i].dios_left--;
+    }
+  }
+#endif /* !ORCHESTRA_UNICAST_SENDER_BASED */
+  buf[1] = pos - 2;
+  return pos;
+}
+/*---------------------------------------------------------------------------*/
+void
+orchestra_collision_set_slotframe(uint16_t handle)
+{
+  slotframe_handle = handle;
+}
+/*---------------------------------------------------------------------------*/
+void
+orchestra_collision_init(void)
+{
+  nbr_table_register(orchestra_nbrs, NULL);
+}
+
+#endif /* ORCHESTRA_COLLISION_DETECTION */
@@ -81,6 +81,41 @@
 #define ORCHESTRA_UNICAST_SENDER_BASED            0
 #endif /* ORCHESTRA_CONF_UNICAST_SENDER_BASED */
 
+/* Traffic-adaptive unicast slotframe (orchestra-rule-unicast-adaptive.c).
+ * The slotframe is made of this many sub-slotframes of length ORCHESTRA_UNICAST_PERIOD,
+ * i.e. this is the max number of timeslots per link and slotframe.
+ * The rule installs up to ORCHESTRA_UNICAST_PERIOD * ORCHESTRA_UNICAST_ADAPTIVE_MAX_SLOTS
+ * TSCH links, on top of the links of the other rules: raise TSCH_SCHEDULE_CONF_MAX_LINKS
+ * (32 by default) accordingly. If the schedule runs out of links, the node uses fewer
+ * timeslots per link, which its neighbors do not know about */
+#ifdef ORCHESTRA_CONF_UNICAST_ADAPTIVE_MAX_SLOTS
+#define ORCHESTRA_UNICAST_ADAPTIVE_MAX_SLOTS      ORCHESTRA_CONF_UNICAST_ADAPTIVE_MAX_SLOTS
+#else /* ORCHESTRA_CONF_UNICAST_ADAPTIVE_MAX_SLOTS */
+#define ORCHESTRA_UNICAST_ADAPTIVE_MAX_SLOTS      4
+#endif /* ORCHESTRA_CONF_UNICAST_ADAPTIVE_MAX_SLOTS */
+
+/* A link gets one more timeslot for every that many nodes in the subtree of the child */
+#ifdef ORCHESTRA_CONF_UNICAST_ADAPTIVE_NODES_PER_SLOT
+#define ORCHESTRA_UNICAST_ADAPTIVE_NODES_PER_SLOT ORCHESTRA_CONF_UNICAST_ADAPTIVE_NODES_PER_SLOT
+#else /* ORCHESTRA_CONF_UNICAST_ADAPTIVE_NODES_PER_SLOT */
+#define ORCHESTRA_UNICAST_ADAPTIVE_NODES_PER_SLOT 2
+#endif /* ORCHESTRA_CONF_UNICAST_ADAPTIVE_NODES_PER_SLOT */
+
+/* Period of the resizing of the links, in slotframes */
+#ifdef ORCHESTRA_CONF_UNICAST_ADAPTIVE_UPDATE_PERIOD
+#define ORCHESTRA_UNICAST_ADAPTIVE_UPDATE_PERIOD  ORCHESTRA_CONF_UNICAST_ADAPTIVE_UPDATE_PERIOD
+#else /* ORCHESTRA_CONF_UNICAST_ADAPTIVE_UPDATE_PERIOD */
+#define ORCHESTRA_UNICAST_ADAPTIVE_UPDATE_PERIOD  8
+#endif /* ORCHESTRA_CONF_UNICAST_ADAPTIVE_UPDATE_PERIOD */
+
+/* Number of updates a change of subtree size must last before we shrink the
+ * links our parent uses to reach us, or grow the ones we use to reach it (at least 1) */
+#ifdef ORCHESTRA_CONF_UNICAST_ADAPTIVE_HYSTERESIS
+#define ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS     ORCHESTRA_CONF_UNICAST_ADAPTIVE_HYSTERESIS
+#else /* ORCHESTRA_CONF_UNICAST_ADAPTIVE_HYSTERESIS */
+#define ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS     3
+#endif /* ORCHESTRA_CONF_UNICAST_ADAPTIVE_HYSTERESIS */
+
 /* The hash function used to assign timeslot to a given node (based on its link-layer address) */
 #ifdef ORCHESTRA_CONF_LINKADDR_HASH
 #define ORCHESTRA_LINKADDR_HASH                   ORCHESTRA_CONF_LINKADDR_HASH
@@ -102,4 +137,51 @@
 #define ORCHESTRA_COLLISION_FREE_HASH             0 /* Set to 1 if ORCHESTRA_LINKADDR_HASH returns unique hashes */
 #endif /* ORCHESTRA_CONF_COLLISION_FREE_HASH */
 
+/* Detect persistent collisions in the unicast slotframe (orchestra-collision.c):
+ * when the transmissions to a neighbor fail much more often in its unicast
+ * timeslot than in shared timeslots, the hash of the node owning the timeslot
+ * is re-salted. Salts and collision reports are exchanged in an RPL DIO option.
+ * Requires TSCH_WITH_LINK_STATISTICS and the RPL_CALLBACK_DIO_OPTION_* callbacks. */
+#ifdef ORCHESTRA_CONF_COLLISION_DETECTION
+#define ORCHESTRA_COLLISION_DETECTION             ORCHESTRA_CONF_COLLISION_DETECTION
+#else /* ORCHESTRA_CONF_COLLISION_DETECTION */
+#define ORCHESTRA_COLLISION_DETECTION             0
+#endif /* ORCHESTRA_CONF_COLLISION_DETECTION */
+
+/* Transmissions to a neighbor in unicast timeslots needed before we decide on a collision */
+#ifdef ORCHESTRA_CONF_COLLISION_MIN_TX
+#define ORCHESTRA_COLLISION_MIN_TX                ORCHESTRA_CONF_COLLISION_MIN_TX
+#else /* ORCHESTRA_CONF_COLLISION_MIN_TX */
+#define ORCHESTRA_COLLISION_MIN_TX                16
+#endif /* ORCHESTRA_CONF_COLLISION_MIN_TX */
+
+/* A collision is detected when the failure ratio in unicast timeslots exceeds
+ * the failure ratio in shared timeslots by that many percents */
+#ifdef ORCHESTRA_CONF_COLLISION_THRESHOLD
+#define ORCHESTRA_COLLISION_THRESHOLD             ORCHESTRA_CONF_COLLISION_THRESHOLD
+#else /* ORCHESTRA_CONF_COLLISION_THRESHOLD */
+#define ORCHESTRA_COLLISION_THRESHOLD             30
+#endif /* ORCHESTRA_CONF_COLLISION_THRESHOLD */
+
+/* Max number of collisions reported at once in our DIOs (receiver-based only),
+ * and number of DIOs a report is repeated in */
+#ifdef ORCHESTRA_CONF_COLLISION_MAX_REPORTS
+#define ORCHESTRA_COLLISION_MAX_REPORTS           ORCHESTRA_CONF_COLLISION_MAX_REPORTS
+#else /* ORCHESTRA_CONF_COLLISION_MAX_REPORTS */
+#define ORCHESTRA_COLLISION_MAX_REPORTS           2
+#endif /* ORCHESTRA_CONF_COLLISION_MAX_REPORTS */
+
+#ifdef ORCHESTRA_CONF_COLLISION_REPORT_DIOS
+#define ORCHESTRA_COLLISION_REPORT_DIOS           ORCHESTRA_CONF_COLLISION_REPORT_DIOS
+#else /* ORCHESTRA_CONF_COLLISION_REPORT_DIOS */
+#define ORCHESTRA_COLLISION_REPORT_DIOS           3
+#endif /* ORCHESTRA_CONF_COLLISION_REPORT_DIOS */
+
+/* Type of the DIO option carrying salts and collision reports (not assigned by IANA) */
+#ifdef ORCHESTRA_CONF_COLLISION_DIO_OPTION
+#define ORCHESTRA_COLLISION_DIO_OPTION            ORCHESTRA_CONF_COLLISION_DIO_OPTION
+#else /* ORCHESTRA_CONF_COLLISION_DIO_OPTION */
+#define ORCHESTRA_COLLISION_DIO_OPTION            0x1f
+#endif /* ORCHESTRA_CONF_COLLISION_DIO_OPTION */
+
 #endif /* __ORCHESTRA_CONF_H__ */
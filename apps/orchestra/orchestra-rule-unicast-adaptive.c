@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+/**
+ * \file
+ *         Orchestra: a traffic-adaptive slotframe for unicast data transmission.
+ *         Works as orchestra-rule-unicast-per-neighbor, but the slotframe is
+ *         made of ORCHESTRA_UNICAST_ADAPTIVE_MAX_SLOTS sub-slotframes of length
+ *         ORCHESTRA_UNICAST_PERIOD. The i-th timeslot of a node is
+ *           i * ORCHESTRA_UNICAST_PERIOD + hash(MAC) % ORCHESTRA_UNICAST_PERIOD
+ *         so that two nodes share a timeslot only if they would share it with
+ *         the per-neighbor rule.
+ *         The number of timeslots used on the link between a node and its
+ *         parent grows with the size of the node's RPL subtree, which both ends
+ *         know from their routing tables (RPL storing mode). Packets are spread
+ *         over the timeslots of a link according to the queue depth; the
+ *         queue depth does not change the number of timeslots, as the other
+ *         end of the link could not know about it.
+ *         A link takes up to ORCHESTRA_UNICAST_ADAPTIVE_MAX_SLOTS entries of the
+ *         TSCH schedule, see TSCH_SCHEDULE_CONF_MAX_LINKS in orchestra-conf.h.
+ *
+ * \author agent <agent@local>
+ */
+
+#include "contiki.h"
+#include "orchestra.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/packetbuf.h"
+#include "net/mac/tsch/tsch-private.h"
+#include <string.h>
+
+#define DEBUG DEBUG_NONE
+#include "net/ip/uip-debug.h"
+
+#if ORCHESTRA_UNICAST_SENDER_BASED && ORCHESTRA_COLLISION_FREE_HASH && !ORCHESTRA_COLLISION_DETECTION
+#define UNICAST_SLOT_SHARED_FLAG    ((ORCHESTRA_UNICAST_PERIOD < (ORCHESTRA_MAX_HASH + 1)) ? LINK_OPTION_SHARED : 0)
+#else
+#define UNICAST_SLOT_SHARED_FLAG      LINK_OPTION_SHARED
+#endif
+
+/* Options of the links at our own timeslots, and at our neighbors' timeslots */
+#define OWN_LINK_OPTIONS (ORCHESTRA_UNICAST_SENDER_BASED ? LINK_OPTION_TX | UNICAST_SLOT_SHARED_FLAG : LINK_OPTION_RX)
+#define NBR_LINK_OPTIONS (ORCHESTRA_UNICAST_SENDER_BASED ? LINK_OPTION_RX : LINK_OPTION_TX | UNICAST_SLOT_SHARED_FLAG)
+
+#define SLOTFRAME_LENGTH (ORCHESTRA_UNICAST_PERIOD * ORCHESTRA_UNICAST_ADAPTIVE_MAX_SLOTS)
+
+static uint16_t slotframe_handle = 0;
+static uint16_t channel_offset = 0;
+static struct tsch_slotframe *sf_unicast;
+static struct ctimer update_timer;
+
+/* Timeslots for our subtree. The link to our parent uses 'own_slots' in the
+ * direction the parent does not control (parent to us in receiver-based
+ * mode), 'up_slots' in the other one. 'own_slots' grows at once and shrinks
+ * with hysteresis, 'up_slots' the opposite, so that we do not use a timeslot
+ * our parent is not aware of yet while our routes propagate */
+static uint8_t own_slots = 1;
+static uint8_t up_slots = 1;
+static uint8_t own_slots_countdown = ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS;
+static uint8_t up_slots_countdown = ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS;
+
+/* Max number of timeslots per link. Lowered for good if the TSCH schedule
+ * runs out of links */
+static uint8_t max_slots = ORCHESTRA_UNICAST_ADAPTIVE_MAX_SLOTS;
+
+/* Link options we want at each timeslot */
+static uint8_t link_options[SLOTFRAME_LENGTH];
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get_node_timeslot(const linkaddr_t *addr, uint8_t index)
+{
+  if(addr != NULL && ORCHESTRA_UNICAST_PERIOD > 0) {
+    return index * ORCHESTRA_UNICAST_PERIOD + ORCHESTRA_LINKADDR_SALTED_HASH(addr) % ORCHESTRA_UNICAST_PERIOD;
+  } else {
+    return 0xffff;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+slots_for_subtree(int subtree_size)
+{
+  int slots = 1 + subtree_size / ORCHESTRA_UNICAST_ADAPTIVE_NODES_PER_SLOT;
+  return slots < max_slots ? slots : max_slots;
+}
+/*---------------------------------------------------------------------------*/
+/* Timeslots of the link to a child, from the routes we have through it */
+static uint8_t
+child_slots(nbr_table_item_t *item)
+{
+  int num_routes = list_length(((struct uip_ds6_route_neighbor_routes *)item)->route_list);
+  /* One of the routes is to the child itself */
+  return slots_for_subtree(num_routes > 0 ? num_routes - 1 : 0);
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_parent(const linkaddr_t *linkaddr)
+{
+  return !linkaddr_cmp(&orchestra_parent_linkaddr, &linkaddr_null)
+    && linkaddr_cmp(&orchestra_parent_linkaddr, linkaddr);
+}
+/*---------------------------------------------------------------------------*/
+static int
+neighbor_has_uc_link(const linkaddr_t *linkaddr)
+{
+  if(linkaddr != NULL && !linkaddr_cmp(linkaddr, &linkaddr_null)) {
+    if((orchestra_parent_knows_us || !ORCHESTRA_UNICAST_SENDER_BASED)
+       && linkaddr_cmp(&orchestra_parent_linkaddr, linkaddr)) {
+      return 1;
+    }
+    if(nbr_table_get_from_lladdr(nbr_routes, (linkaddr_t *)linkaddr) != NULL) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Number of timeslots we use for transmitting to a neighbor */
+static uint8_t
+tx_slots(const linkaddr_t *linkaddr)
+{
+  nbr_table_item_t *item;
+  if(is_parent(linkaddr)) {
+    return MIN(up_slots, max_slots);
+  }
+  item = nbr_table_get_from_lladdr(nbr_routes, (linkaddr_t *)linkaddr);
+  return item != NULL ? child_slots(item) : 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_link_options(const linkaddr_t *linkaddr, uint8_t num_slots, uint8_t options)
+{
+  int i;
+  for(i = 0; i < num_slots && i < max_slots; i++) {
+    link_options[get_node_timeslot(linkaddr, i)] |= options;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Install the links we need and remove the others. Returns 0 if the TSCH
+ * schedule ran out of links */
+static int
+install_links(void)
+{
+  nbr_table_item_t *item;
+  uint8_t own = ORCHESTRA_UNICAST_SENDER_BASED ? up_slots : own_slots;
+  uint16_t timeslot;
+  int ret = 1;
+
+  memset(link_options, 0, sizeof(link_options));
+  /* Our parent */
+  if(!linkaddr_cmp(&orchestra_parent_linkaddr, &linkaddr_null)) {
+    set_link_options(&orchestra_parent_linkaddr,
+        ORCHESTRA_UNICAST_SENDER_BASED ? own_slots : up_slots, NBR_LINK_OPTIONS);
+  }
+  /* Our children, i.e. all route next hops */
+  item = nbr_table_head(nbr_routes);
+  while(item != NULL) {
+    uint8_t slots = child_slots(item);
+    set_link_options(nbr_table_get_lladdr(nbr_routes, item), slots, NBR_LINK_OPTIONS);
+    if(slots > own) {
+      own = slots;
+    }
+    item = nbr_table_next(nbr_routes, item);
+  }
+  /* Our own timeslots, as many as the busiest of our links needs */
+  set_link_options(&linkaddr_node_addr, own, OWN_LINK_OPTIONS);
+
+  /* Free the links we no longer need before adding new ones */
+  for(timeslot = 0; timeslot < SLOTFRAME_LENGTH; timeslot++) {
+    struct tsch_link *l = tsch_schedule_get_link_by_timeslot(sf_unicast, timeslot);
+    if(link_options[timeslot] == 0 && l != NULL) {
+      tsch_schedule_remove_link(sf_unicast, l);
+    }
+  }
+  for(timeslot = 0; timeslot < SLOTFRAME_LENGTH; timeslot++) {
+    struct tsch_link *l = tsch_schedule_get_link_by_timeslot(sf_unicast, timeslot);
+    if(link_options[timeslot] != 0
+       && (l == NULL || l->link_options != link_options[timeslot])) {
+      if(tsch_schedule_add_link(sf_unicast, link_options[timeslot],
+          LINK_TYPE_NORMAL, &tsch_broadcast_address,
+          timeslot, channel_offset) == NULL) {
+        ret = 0;
+      }
+    }
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+/* Install the links we need, with fewer timeslots per link if the TSCH
+ * schedule runs out of links. A neighbor that still uses more timeslots
+ * with us then misses us in the others; raise TSCH_SCHEDULE_CONF_MAX_LINKS
+ * to avoid this */
+static void
+update_links(void)
+{
+  if(sf_unicast == NULL) {
+    return;
+  }
+  while(!install_links() && max_slots > 1) {
+    max_slots--;
+    PRINTF("Orchestra: unicast adaptive, out of TSCH links, down to %u slots\n",
+           max_slots);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void update(void *ptr);
+
+/* Run the next update at the start of a slotframe, 'num_slotframes' from now */
+static void
+schedule_update(uint16_t num_slotframes)
+{
+  uint32_t num_timeslots = (uint32_t)num_slotframes * SLOTFRAME_LENGTH;
+  if(tsch_is_associated) {
+    num_timeslots -= ASN_MOD(current_asn, sf_unicast->size);
+  }
+  ctimer_set(&update_timer,
+      1 + num_timeslots * tsch_timing[tsch_ts_timeslot_length] / (RTIMER_SECOND / CLOCK_SECOND),
+      update, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* Periodically resize our links from our current subtree size */
+static void
+update(void *ptr)
+{
+  uint8_t slots = slots_for_subtree(uip_ds6_route_num_routes());
+
+  if(slots >= own_slots) {
+    own_slots = slots;
+    own_slots_countdown = ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS;
+  } else if(--own_slots_countdown == 0) {
+    own_slots = slots;
+    own_slots_countdown = ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS;
+  }
+  if(slots <= up_slots) {
+    up_slots = slots;
+    up_slots_countdown = ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS;
+  } else if(--up_slots_countdown == 0) {
+    up_slots = slots;
+    up_slots_countdown = ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS;
+  }
+  PRINTF("Orchestra: unicast adaptive, %u routes, own %u up %u\n",
+         uip_ds6_route_num_routes(), own_slots, up_slots);
+
+  update_links();
+  schedule_update(ORCHESTRA_UNICAST_ADAPTIVE_UPDATE_PERIOD);
+}
+/*---------------------------------------------------------------------------*/
+/* Index of the timeslot to use for a packet to a neighbor. The first packet
+ * in queue goes at the next of the link's timeslots to come, the following
+ * ones at the next timeslots, so that a backlog drains in one slotframe */
+static uint8_t
+select_index(const linkaddr_t *dest, const linkaddr_t *slot_owner)
+{
+  uint8_t num_slots = tx_slots(dest);
+  uint8_t next = 0;
+
+  if(num_slots <= 1) {
+    return 0;
+  }
+  if(tsch_is_associated && sf_unicast != NULL) {
+    uint16_t now = ASN_MOD(current_asn, sf_unicast->size);
+    while(next < num_slots && get_node_timeslot(slot_owner, next) <= now) {
+      next++;
+    }
+  }
+  return (next + tsch_queue_packet_count(dest)) % num_slots;
+}
+/*---------------------------------------------------------------------------*/
+static void
+child_added(const linkaddr_t *linkaddr)
+{
+  update_links();
+}
+/*---------------------------------------------------------------------------*/
+static void
+child_removed(const linkaddr_t *linkaddr)
+{
+  update_links();
+}
+/*---------------------------------------------------------------------------*/
+static int
+select_packet(uint16_t *slotframe, uint16_t *timeslot)
+{
+  /* Select data packets we have a unicast link to */
+  const linkaddr_t *dest = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
+  if(packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE) == FRAME802154_DATAFRAME
+     && neighbor_has_uc_link(dest)) {
+    if(slotframe != NULL) {
+      *slotframe = slotframe_handle;
+    }
+    if(timeslot != NULL) {
+      const linkaddr_t *slot_owner = ORCHESTRA_UNICAST_SENDER_BASED ? &linkaddr_node_addr : dest;
+      *timeslot = get_node_timeslot(slot_owner, select_index(dest, slot_owner));
+    }
+    return 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+new_time_source(const struct tsch_neighbor *old, const struct tsch_neighbor *new)
+{
+  if(new != old) {
+    const linkaddr_t *new_addr = new != NULL ? &new->addr : NULL;
+    if(new_addr != NULL) {
+      linkaddr_copy(&orchestra_parent_linkaddr, new_addr);
+    } else {
+      linkaddr_copy(&orchestra_parent_linkaddr, &linkaddr_null);
+    }
+    /* Start over with a single timeslot to the new parent */
+    up_slots = 1;
+    up_slots_countdown = ORCHESTRA_UNICAST_ADAPTIVE_HYSTERESIS;
+    update_links();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+salt_changed(const linkaddr_t *linkaddr)
+{
+  update_links();
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(uint16_t sf_handle)
+{
+  slotframe_handle = sf_handle;
+  channel_offset = sf_handle;
+  /* Slotframe for unicast transmissions */
+  sf_unicast = tsch_schedule_add_slotframe(slotframe_handle, SLOTFRAME_LENGTH);
+  if(sf_unicast == NULL) {
+    return;
+  }
+  update_links();
+  schedule_update(ORCHESTRA_UNICAST_ADAPTIVE_UPDATE_PERIOD);
+#if ORCHESTRA_COLLISION_DETECTION
+  orchestra_collision_set_slotframe(slotframe_handle);
+#endif /* ORCHESTRA_COLLISION_DETECTION */
+}
+/*---------------------------------------------------------------------------*/
+struct orchestra_rule unicast_adaptive = {
+  init,
+  new_time_source,
+  select_packet,
+  child_added,
+  child_removed,
+  salt_changed,
+};
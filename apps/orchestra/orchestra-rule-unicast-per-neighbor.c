@@ -44,7 +44,7 @@
 #include "net/ipv6/uip-ds6-route.h"
 #include "net/packetbuf.h"
 
-#if ORCHESTRA_UNICAST_SENDER_BASED && ORCHESTRA_COLLISION_FREE_HASH
+#if ORCHESTRA_UNICAST_SENDER_BASED && ORCHESTRA_COLLISION_FREE_HASH && !ORCHESTRA_COLLISION_DETECTION
 #define UNICAST_SLOT_SHARED_FLAG    ((ORCHESTRA_UNICAST_PERIOD < (ORCHESTRA_MAX_HASH + 1)) ? LINK_OPTION_SHARED : 0)
 #else
 #define UNICAST_SLOT_SHARED_FLAG      LINK_OPTION_SHARED
@@ -59,7 +59,7 @@ static uint16_t
 get_node_timeslot(const linkaddr_t *addr)
 {
   if(addr != NULL && ORCHESTRA_UNICAST_PERIOD > 0) {
-    return ORCHESTRA_LINKADDR_HASH(addr) % ORCHESTRA_UNICAST_PERIOD;
+    return ORCHESTRA_LINKADDR_SALTED_HASH(addr) % ORCHESTRA_UNICAST_PERIOD;
   } else {
     return 0xffff;
   }
@@ -80,19 +80,59 @@ neighbor_has_uc_link(const linkaddr_t *linkaddr)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+#if ORCHESTRA_UNICAST_SENDER_BASED
+/* Address of our Rx link in the timeslot of a neighbor: the neighbor's
+ * own, so that TSCH can learn its timing (see TSCH_ADAPTIVE_GUARD_TIME),
+ * unless another of our neighbors also sends in that timeslot */
+static const linkaddr_t *
+rx_link_addr(const linkaddr_t *linkaddr, uint16_t timeslot)
+{
+  nbr_table_item_t *item;
+  if(!linkaddr_cmp(&orchestra_parent_linkaddr, &linkaddr_null)
+     && !linkaddr_cmp(&orchestra_parent_linkaddr, linkaddr)
+     && timeslot == get_node_timeslot(&orchestra_parent_linkaddr)) {
+    return &tsch_broadcast_address;
+  }
+  item = nbr_table_head(nbr_routes);
+  while(item != NULL) {
+    linkaddr_t *addr = nbr_table_get_lladdr(nbr_routes, item);
+    if(!linkaddr_cmp(addr, linkaddr) && timeslot == get_node_timeslot(addr)) {
+      return &tsch_broadcast_address;
+    }
+    item = nbr_table_next(nbr_routes, item);
+  }
+  return linkaddr;
+}
+#endif /* ORCHESTRA_UNICAST_SENDER_BASED */
+/*---------------------------------------------------------------------------*/
 static void
 add_uc_link(const linkaddr_t *linkaddr)
 {
   if(linkaddr != NULL) {
     uint16_t timeslot = get_node_timeslot(linkaddr);
-    tsch_schedule_add_link(sf_unicast,
-        ORCHESTRA_UNICAST_SENDER_BASED ? LINK_OPTION_RX : LINK_OPTION_TX | UNICAST_SLOT_SHARED_FLAG,
+#if ORCHESTRA_UNICAST_SENDER_BASED
+    tsch_schedule_add_link(sf_unicast, LINK_OPTION_RX,
+        LINK_TYPE_NORMAL, rx_link_addr(linkaddr, timeslot),
+        timeslot, channel_offset);
+#else /* ORCHESTRA_UNICAST_SENDER_BASED */
+    tsch_schedule_add_link(sf_unicast, LINK_OPTION_TX | UNICAST_SLOT_SHARED_FLAG,
         LINK_TYPE_NORMAL, &tsch_broadcast_address,
         timeslot, channel_offset);
+#endif /* ORCHESTRA_UNICAST_SENDER_BASED */
   }
 }
 /*---------------------------------------------------------------------------*/
 static void
+add_own_link(void)
+{
+  uint16_t timeslot = get_node_timeslot(&linkaddr_node_addr);
+  tsch_schedule_add_link(sf_unicast,
+            ORCHESTRA_UNICAST_SENDER_BASED ? LINK_OPTION_TX | UNICAST_SLOT_SHARED_FLAG: LINK_OPTION_RX,
+            LINK_TYPE_NORMAL, &tsch_broadcast_address,
+            timeslot, channel_offset);
+}
+/*---------------------------------------------------------------------------*/
+static void
 remove_uc_link(const linkaddr_t *linkaddr)
 {
   uint16_t timeslot;
@@ -172,17 +212,37 @@ new_time_source(const struct tsch_neighbor *old, const struct tsch_neighbor *new
 }
 /*---------------------------------------------------------------------------*/
 static void
+salt_changed(const linkaddr_t *linkaddr)
+{
+  struct tsch_link *l;
+  nbr_table_item_t *item;
+  /* Timeslots moved, rebuild the slotframe: our own link first,
+   * then the links to our parent and children */
+  while((l = list_head(sf_unicast->links_list)) != NULL) {
+    tsch_schedule_remove_link(sf_unicast, l);
+  }
+  add_own_link();
+  if(!linkaddr_cmp(&orchestra_parent_linkaddr, &linkaddr_null)) {
+    add_uc_link(&orchestra_parent_linkaddr);
+  }
+  item = nbr_table_head(nbr_routes);
+  while(item != NULL) {
+    add_uc_link(nbr_table_get_lladdr(nbr_routes, item));
+    item = nbr_table_next(nbr_routes, item);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
 init(uint16_t sf_handle)
 {
   slotframe_handle = sf_handle;
   channel_offset = sf_handle;
   /* Slotframe for unicast transmissions */
   sf_unicast = tsch_schedule_add_slotframe(slotframe_handle, ORCHESTRA_UNICAST_PERIOD);
-  uint16_t timeslot = get_node_timeslot(&linkaddr_node_addr);
-  tsch_schedule_add_link(sf_unicast,
-            ORCHESTRA_UNICAST_SENDER_BASED ? LINK_OPTION_TX | UNICAST_SLOT_SHARED_FLAG: LINK_OPTION_RX,
-            LINK_TYPE_NORMAL, &tsch_broadcast_address,
-            timeslot, channel_offset);
+  add_own_link();
+#if ORCHESTRA_COLLISION_DETECTION
+  orchestra_collision_set_slotframe(slotframe_handle);
+#endif /* ORCHESTRA_COLLISION_DETECTION */
 }
 /*---------------------------------------------------------------------------*/
 struct orchestra_rule unicast_per_neighbor = {
@@ -191,4 +251,5 @@ struct orchestra_rule unicast_per_neighbor = {
   select_packet,
   child_added,
   child_removed,
+  salt_changed,
 };
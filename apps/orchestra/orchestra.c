@@ -79,6 +79,9 @@ orchestra_packet_sent(int mac_status)
       orchestra_parent_knows_us = 1;
     }
   }
+#if ORCHESTRA_COLLISION_DETECTION
+  orchestra_collision_packet_sent(mac_status);
+#endif /* ORCHESTRA_COLLISION_DETECTION */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -106,6 +109,18 @@ orchestra_callback_child_removed(const linkaddr_t *addr)
 }
 /*---------------------------------------------------------------------------*/
 void
+orchestra_salt_changed(const linkaddr_t *addr)
+{
+  /* Notify all Orchestra rules that the timeslots of a node moved */
+  int i;
+  for(i = 0; i < NUM_RULES; i++) {
+    if(all_rules[i]->salt_changed != NULL) {
+      all_rules[i]->salt_changed(addr);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
 orchestra_callback_packet_ready(void)
 {
   int i;
@@ -155,6 +170,9 @@ orchestra_init(void)
    * (i.e. has ACKed at one of our DAOs since we decided to use it as a parent) */
   rime_sniffer_add(&orchestra_sniffer);
   linkaddr_copy(&orchestra_parent_linkaddr, &linkaddr_null);
+#if ORCHESTRA_COLLISION_DETECTION
+  orchestra_collision_init();
+#endif /* ORCHESTRA_COLLISION_DETECTION */
   /* Initialize all Orchestra rules */
   for(i = 0; i < NUM_RULES; i++) {
     if(all_rules[i]->init != NULL) {
@@ -38,6 +38,7 @@
 #ifndef __ORCHESTRA_H__
 #define __ORCHESTRA_H__
 
+#include "net/ip/uip.h"
 #include "net/mac/tsch/tsch.h"
 #include "net/mac/tsch/tsch-conf.h"
 #include "net/mac/tsch/tsch-schedule.h"
@@ -50,15 +51,24 @@ struct orchestra_rule {
   int  (* select_packet)(uint16_t *slotframe, uint16_t *timeslot);
   void (* child_added)(const linkaddr_t *addr);
   void (* child_removed)(const linkaddr_t *addr);
+  void (* salt_changed)(const linkaddr_t *addr);
 };
 
 struct orchestra_rule eb_per_time_source;
 struct orchestra_rule unicast_per_neighbor;
+struct orchestra_rule unicast_adaptive;
 struct orchestra_rule default_common;
 
 extern linkaddr_t orchestra_parent_linkaddr;
 extern int orchestra_parent_knows_us;
 
+#if ORCHESTRA_COLLISION_DETECTION
+/* The hash of a node, with the salt it uses to move out of collisions */
+#define ORCHESTRA_LINKADDR_SALTED_HASH(addr) (ORCHESTRA_LINKADDR_HASH(addr) + orchestra_collision_get_salt(addr))
+#else /* ORCHESTRA_COLLISION_DETECTION */
+#define ORCHESTRA_LINKADDR_SALTED_HASH(addr) ORCHESTRA_LINKADDR_HASH(addr)
+#endif /* ORCHESTRA_COLLISION_DETECTION */
+
 /* Call from application to start Orchestra */
 void orchestra_init(void);
 /* Callbacks requied for Orchestra to operate */
@@ -71,4 +81,17 @@ void orchestra_callback_child_added(const linkaddr_t *addr);
 /* Set with #define NETSTACK_CONF_ROUTING_NEIGHBOR_REMOVED_CALLBACK orchestra_callback_child_removed */
 void orchestra_callback_child_removed(const linkaddr_t *addr);
 
+/* Collision detection in the unicast slotframe, see orchestra-collision.c */
+void orchestra_collision_init(void);
+/* Called by unicast rules: the slotframe where collisions are detected */
+void orchestra_collision_set_slotframe(uint16_t slotframe_handle);
+uint8_t orchestra_collision_get_salt(const linkaddr_t *addr);
+void orchestra_collision_packet_sent(int mac_status);
+/* Notifies all rules of a new salt. Called by orchestra-collision.c */
+void orchestra_salt_changed(const linkaddr_t *addr);
+/* Set with #define RPL_CALLBACK_DIO_OPTION_INPUT orchestra_callback_dio_option_input */
+void orchestra_callback_dio_option_input(const uip_ipaddr_t *from, const uint8_t *option, int len);
+/* Set with #define RPL_CALLBACK_DIO_OPTION_OUTPUT orchestra_callback_dio_option_output */
+int orchestra_callback_dio_option_output(uint8_t *buf, int max_len);
+
 #endif /* __ORCHESTRA_H__ */
@@ -106,6 +106,30 @@
  * \brief subresource URL of slotframe size
  */
 #define FRAME_SLOTS_LABEL "slots"
+/** \def FRAME_ENERGY_LABEL
+ * \brief subresource URL of radio usage in a slotframe (requires TSCH_WITH_ENERGEST)
+ */
+#define FRAME_ENERGY_LABEL "energy"
+/** \def ENERGY_TX_LABEL
+ * \brief field of radio usage objects: radio time transmitting, in ms
+ */
+#define ENERGY_TX_LABEL "tx"
+/** \def ENERGY_RX_LABEL
+ * \brief field of radio usage objects: radio time listening, in ms
+ */
+#define ENERGY_RX_LABEL "rx"
+/** \def ENERGY_SLOTS_LABEL
+ * \brief field of radio usage objects: number of timeslots the radio was used in
+ */
+#define ENERGY_SLOTS_LABEL "slots"
+/** \def ENERGY_IDLE_LABEL
+ * \brief field of radio usage objects: number of reception timeslots without any frame
+ */
+#define ENERGY_IDLE_LABEL "idle"
+/** \def ENERGY_UJ_LABEL
+ * \brief field of radio usage objects: energy spent by the radio, in microjoules
+ */
+#define ENERGY_UJ_LABEL "uj"
 #endif
 
 
@@ -136,6 +160,10 @@
  * \brief subresource URL of statistics on a link
  */
 #define LINK_STATS_LABEL "stats"
+/** \def LINK_ENERGY_LABEL
+ * \brief subresource URL of radio usage in a link (requires TSCH_WITH_ENERGEST)
+ */
+#define LINK_ENERGY_LABEL "energy"
 #endif
 
 /* when TSCH link statistics are enabled, statistics URI with 5 subresources and 4 metrics are defined */
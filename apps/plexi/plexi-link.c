@@ -72,6 +72,7 @@ uint8_t plexi_reply_tna_if_possible(const linkaddr_t *tna, uint8_t *buffer, size
  *   - \code{http} GET /LINK_RESOURCE/LINK_OPTION_LABEL -> a json array of link options the links belong to (one per link) e.g. [0,1]\endcode
  *   - \code{http} GET /LINK_RESOURCE/LINK_TYPE_LABEL -> a json array of link types (one per link) e.g. [0,0]\endcode
  *   - \code{http} GET /LINK_RESOURCE/LINK_STATS_LABEL -> a json array of statistics json objects kept per link e.g. [{"id":1,"value":5},{"id":2,"value":111}]\endcode Note the statistics identifier is unique in the whole system i.e. two different statistics in same link or different links in same or different slotframe are also different..
+ *   - \code{http} GET /LINK_RESOURCE/LINK_ENERGY_LABEL -> a json array of radio usage objects (one per link) e.g. [{"tx":120,"rx":2300,"slots":1042,"idle":998,"uj":135988}]\endcode Only with TSCH_WITH_ENERGEST. Counters are cumulative since the link was added.
  * - queries returning the complete link objects of a subset of links specified by the queries. Links can be queried by eitehr their id xor any combination of the following subresources: slotframe, slotoffset and/or channeloffset. It returns either a complete link object or an array with the complete link json objects that fulfill the queries:
  *   - \code{http} GET /LINK_RESOURCE?LINK_SLOT_LABEL=3 -> a json array of link objects allocated to specific slotoffset e.g. [{LINK_ID_LABEL:8,FRAME_ID_LABEL:1,LINK_SLOT_LABEL:3,LINK_CHANNEL_LABEL:5,LINK_OPTION_LABEL:0,LINK_TYPE_LABEL:0}]\endcode
  *   - \code{http} GET /LINK_RESOURCE?LINK_CHANNEL_LABEL=5 -> a json array of link objects allocated to specific channeloffset e.g. [{LINK_ID_LABEL:8,FRAME_ID_LABEL:1,LINK_SLOT_LABEL:3,LINK_CHANNEL_LABEL:5,LINK_OPTION_LABEL:0,LINK_TYPE_LABEL:0},{LINK_ID_LABEL:9,FRAME_ID_LABEL:3,LINK_SLOT_LABEL:4,LINK_CHANNEL_LABEL:5,"option"1:,LINK_TYPE_LABEL:0}]\endcode
@@ -274,7 +275,8 @@ plexi_get_links_handler(void *request, void *response, uint8_t *buffer, uint16_t
       if((uri_len > base_len + 1 && strcmp(LINK_ID_LABEL, uri_subresource) && strcmp(FRAME_ID_LABEL, uri_subresource) \
           && strcmp(LINK_SLOT_LABEL, uri_subresource) && strcmp(LINK_CHANNEL_LABEL, uri_subresource) \
           && strcmp(LINK_OPTION_LABEL, uri_subresource) && strcmp(LINK_TYPE_LABEL, uri_subresource) \
-          && strcmp(NEIGHBORS_TNA_LABEL, uri_subresource) && strcmp(LINK_STATS_LABEL, uri_subresource))) {
+          && strcmp(NEIGHBORS_TNA_LABEL, uri_subresource) && strcmp(LINK_STATS_LABEL, uri_subresource) \
+          && strcmp(LINK_ENERGY_LABEL, uri_subresource))) {
         coap_set_status_code(response, NOT_FOUND_4_04);
         coap_set_payload(response, "Invalid subresource", 19);
         return;
@@ -328,6 +330,14 @@ plexi_get_links_handler(void *request, void *response, uint8_t *buffer, uint16_t
                 return;
 #if PLEXI_WITH_LINK_STATISTICS
               }
+#endif
+              } else if(!strcmp(LINK_ENERGY_LABEL, uri_subresource)) {
+#if TSCH_WITH_ENERGEST
+                plexi_reply_energest_if_possible(&link->energest, buffer, &bufpos, bufsize, &strpos, offset);
+#else
+                coap_set_status_code(response, NOT_FOUND_4_04);
+                coap_set_payload(response, "No energy accounting", 20);
+                return;
 #endif
               } else {
                 plexi_reply_char_if_possible('{', buffer, &bufpos, bufsize, &strpos, offset);
@@ -345,6 +355,12 @@ plexi_get_links_handler(void *request, void *response, uint8_t *buffer, uint16_t
                   bufpos = undo_bufpos;
                   strpos = undo_strpos;
                 }
+#endif
+#if TSCH_WITH_ENERGEST
+                plexi_reply_string_if_possible(",\"", buffer, &bufpos, bufsize, &strpos, offset);
+                plexi_reply_string_if_possible(LINK_ENERGY_LABEL, buffer, &bufpos, bufsize, &strpos, offset);
+                plexi_reply_string_if_possible("\":", buffer, &bufpos, bufsize, &strpos, offset);
+                plexi_reply_energest_if_possible(&link->energest, buffer, &bufpos, bufsize, &strpos, offset);
 #endif
                 plexi_reply_char_if_possible('}', buffer, &bufpos, bufsize, &strpos, offset);
               }
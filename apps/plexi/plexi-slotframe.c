@@ -60,6 +60,7 @@
  * - subresources returning json arrays with the values of the specified subresource for all slotframes:
  *   - \code{http} GET /FRAME_RESOURCE/FRAME_ID_LABEL -> a json array of identifiers (one per slotframe) e.g. [1,3]\endcode
  *   - \code{http} GET /FRAME_RESOURCE/FRAME_SLOTS_LABEL -> a json array of slotframe sizes (one per slotframe) e.g. [13,101]\endcode
+ *   - \code{http} GET /FRAME_RESOURCE/FRAME_ENERGY_LABEL -> a json array of radio usage objects (one per slotframe) e.g. [{"tx":120,"rx":2300,"slots":1042,"idle":998,"uj":135988}]\endcode Only with TSCH_WITH_ENERGEST.
  * - queries:
  *   - \code{http} GET /FRAME_RESOURCE?FRAME_ID_LABEL=3 -> one slotframe object of specific identifier e.g. {FRAME_ID_LABEL:3,FRAME_SLOTS_LABEL:101}\endcode
  *   - \code{http} GET /FRAME_RESOURCE?FRAME_SLOTS_LABEL=101 -> a json array of slotframe objects of specific size [{FRAME_ID_LABEL:3,FRAME_SLOTS_LABEL:101}]\endcode
@@ -189,7 +190,11 @@ plexi_get_slotframe_handler(void *request, void *response, uint8_t *buffer, uint
       query = NULL;
     }
     /* make sure no other url structures are accepted */
-    if((uri_len > base_len + 1 && strcmp(FRAME_ID_LABEL, uri_subresource) && strcmp(FRAME_SLOTS_LABEL, uri_subresource)) || (query && !query_value)) {
+    if((uri_len > base_len + 1 && strcmp(FRAME_ID_LABEL, uri_subresource) && strcmp(FRAME_SLOTS_LABEL, uri_subresource)
+#if TSCH_WITH_ENERGEST
+        && strcmp(FRAME_ENERGY_LABEL, uri_subresource)
+#endif
+       ) || (query && !query_value)) {
       coap_set_status_code(response, NOT_IMPLEMENTED_5_01);
       coap_set_payload(response, "Supports only slot frame id XOR size as subresource or query", 60);
       return;
@@ -212,6 +217,10 @@ plexi_get_slotframe_handler(void *request, void *response, uint8_t *buffer, uint
           plexi_reply_uint16_if_possible(slotframe->handle, buffer, &bufpos, bufsize, &strpos, offset);
         } else if(!strcmp(FRAME_SLOTS_LABEL, uri_subresource)) {
           plexi_reply_uint16_if_possible(slotframe->size.val, buffer, &bufpos, bufsize, &strpos, offset);
+#if TSCH_WITH_ENERGEST
+        } else if(!strcmp(FRAME_ENERGY_LABEL, uri_subresource)) {
+          plexi_reply_energest_if_possible(&slotframe->energest, buffer, &bufpos, bufsize, &strpos, offset);
+#endif
         } else {
           plexi_reply_string_if_possible("{\"", buffer, &bufpos, bufsize, &strpos, offset);
           plexi_reply_string_if_possible(FRAME_ID_LABEL, buffer, &bufpos, bufsize, &strpos, offset);
@@ -221,6 +230,12 @@ plexi_get_slotframe_handler(void *request, void *response, uint8_t *buffer, uint
           plexi_reply_string_if_possible(FRAME_SLOTS_LABEL, buffer, &bufpos, bufsize, &strpos, offset);
           plexi_reply_string_if_possible("\":", buffer, &bufpos, bufsize, &strpos, offset);
           plexi_reply_uint16_if_possible(slotframe->size.val, buffer, &bufpos, bufsize, &strpos, offset);
+#if TSCH_WITH_ENERGEST
+          plexi_reply_string_if_possible(",\"", buffer, &bufpos, bufsize, &strpos, offset);
+          plexi_reply_string_if_possible(FRAME_ENERGY_LABEL, buffer, &bufpos, bufsize, &strpos, offset);
+          plexi_reply_string_if_possible("\":", buffer, &bufpos, bufsize, &strpos, offset);
+          plexi_reply_energest_if_possible(&slotframe->energest, buffer, &bufpos, bufsize, &strpos, offset);
+#endif
           plexi_reply_char_if_possible('}', buffer, &bufpos, bufsize, &strpos, offset);
         }
       }
@@ -411,6 +411,42 @@ plexi_reply_uint16_if_possible(uint16_t d, uint8_t *buffer, size_t *bufpos, uint
   return 1; 
 }
 
+uint8_t
+plexi_reply_uint32_if_possible(uint32_t d, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset)
+{
+  char s[11];
+  snprintf(s, sizeof(s), "%"PRIu32, d);
+  return plexi_reply_string_if_possible(s, buffer, bufpos, bufsize, strpos, offset);
+}
+
+#if TSCH_WITH_ENERGEST && (PLEXI_WITH_SLOTFRAME_RESOURCE || PLEXI_WITH_LINK_RESOURCE)
+uint8_t
+plexi_reply_energest_if_possible(const struct tsch_energest_stats *s, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset)
+{
+  return plexi_reply_string_if_possible("{\"", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(ENERGY_TX_LABEL, buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible("\":", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_uint32_if_possible(tsch_energest_ms(s->tx_ticks), buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(",\"", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(ENERGY_RX_LABEL, buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible("\":", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_uint32_if_possible(tsch_energest_ms(s->rx_ticks), buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(",\"", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(ENERGY_SLOTS_LABEL, buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible("\":", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_uint32_if_possible(s->slots, buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(",\"", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(ENERGY_IDLE_LABEL, buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible("\":", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_uint32_if_possible(s->idle_rx, buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(",\"", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible(ENERGY_UJ_LABEL, buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_string_if_possible("\":", buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_uint32_if_possible(tsch_energest_uj(s), buffer, bufpos, bufsize, strpos, offset) &&
+    plexi_reply_char_if_possible('}', buffer, bufpos, bufsize, strpos, offset);
+}
+#endif /* TSCH_WITH_ENERGEST && (PLEXI_WITH_SLOTFRAME_RESOURCE || PLEXI_WITH_LINK_RESOURCE) */
+
 void
 plexi_reply_lladdr_if_possible(const linkaddr_t *lladdr, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset)
 {
@@ -53,6 +53,8 @@
 #include "net/linkaddr.h"
 #include "net/ip/uip.h"
 #include "lib/list.h"
+#include "net/mac/tsch/tsch-conf.h"
+#include "net/mac/tsch/tsch-energest.h"
 #include "jsonparse.h"
 
 //#include "plexi-conf.h" /* Defines the size of CoAP reply buffer */
@@ -116,8 +118,16 @@ uint8_t plexi_reply_char_if_possible(char c, uint8_t *buffer, size_t *bufpos, ui
 uint8_t plexi_reply_string_if_possible(char *s, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset);
 uint8_t plexi_reply_hex_if_possible(unsigned int hex, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset, uint8_t min_size_format);
 uint8_t plexi_reply_uint16_if_possible(uint16_t d, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset);
+uint8_t plexi_reply_uint32_if_possible(uint32_t d, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset);
 void plexi_reply_lladdr_if_possible(const linkaddr_t *lladdr, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset);
 uint8_t plexi_reply_ip_if_possible(const uip_ipaddr_t *addr, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset);
+#if TSCH_WITH_ENERGEST && (PLEXI_WITH_SLOTFRAME_RESOURCE || PLEXI_WITH_LINK_RESOURCE)
+/**
+ * \brief Utility function. Replies the radio usage of a link or slotframe as a json object,
+ * e.g. {ENERGY_TX_LABEL:120,ENERGY_RX_LABEL:2300,ENERGY_SLOTS_LABEL:1042,ENERGY_IDLE_LABEL:998,ENERGY_UJ_LABEL:135988}
+ */
+uint8_t plexi_reply_energest_if_possible(const struct tsch_energest_stats *s, uint8_t *buffer, size_t *bufpos, uint16_t bufsize, size_t *strpos, int32_t *offset);
+#endif
 
 
 /**
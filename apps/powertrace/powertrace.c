@@ -42,6 +42,11 @@
 #include "sys/compower.h"
 #include "powertrace.h"
 #include "net/rime/rime.h"
+#include "net/mac/tsch/tsch-conf.h"
+#if TSCH_WITH_ENERGEST
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-schedule.h"
+#endif /* TSCH_WITH_ENERGEST */
 
 #include <stdio.h>
 #include <string.h>
@@ -69,6 +74,40 @@ LIST(stats_list);
 
 PROCESS(powertrace_process, "Periodic power output");
 /*---------------------------------------------------------------------------*/
+#if TSCH_WITH_ENERGEST
+/* Print the cumulative radio usage of every TSCH slotframe (TSF) and
+ * link (TL): tx and rx time in ms, timeslots, idle Rx timeslots, uJ */
+static void
+print_tsch(char *str, unsigned long seqno)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *l;
+
+  for(sf = tsch_schedule_get_slotframe_next(NULL); sf != NULL;
+      sf = tsch_schedule_get_slotframe_next(sf)) {
+    printf("%s %lu TSF %d.%d %lu %u %lu %lu %lu %lu %lu\n",
+           str, clock_time(), linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1], seqno,
+           sf->handle,
+           (unsigned long)tsch_energest_ms(sf->energest.tx_ticks),
+           (unsigned long)tsch_energest_ms(sf->energest.rx_ticks),
+           (unsigned long)sf->energest.slots,
+           (unsigned long)sf->energest.idle_rx,
+           (unsigned long)tsch_energest_uj(&sf->energest));
+    for(l = tsch_schedule_get_link_next(sf, NULL); l != NULL;
+        l = tsch_schedule_get_link_next(sf, l)) {
+      printf("%s %lu TL %d.%d %lu %u %u %u %u %lu %lu %lu %lu %lu\n",
+             str, clock_time(), linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1], seqno,
+             sf->handle, l->handle, l->timeslot, l->channel_offset,
+             (unsigned long)tsch_energest_ms(l->energest.tx_ticks),
+             (unsigned long)tsch_energest_ms(l->energest.rx_ticks),
+             (unsigned long)l->energest.slots,
+             (unsigned long)l->energest.idle_rx,
+             (unsigned long)tsch_energest_uj(&l->energest));
+    }
+  }
+}
+#endif /* TSCH_WITH_ENERGEST */
+/*---------------------------------------------------------------------------*/
 void
 powertrace_print(char *str)
 {
@@ -188,6 +227,9 @@ powertrace_print(char *str)
     s->last_output_rxtime = s->output_rxtime;
     
   }
+#if TSCH_WITH_ENERGEST
+  print_tsch(str, seqno);
+#endif /* TSCH_WITH_ENERGEST */
   seqno++;
 }
 /*---------------------------------------------------------------------------*/
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Shell interface to the TSCH slot operation profiler and burst statistics
+ */
+
+#include "shell.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-slot-profile.h"
+#include "net/mac/tsch/tsch-slot-operation.h"
+#include <stdio.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_tsch_profile_process, "tsch-profile");
+SHELL_COMMAND(tsch_profile_command,
+	      "tsch-profile",
+	      "tsch-profile [reset]: print TSCH slot phase timings (us), or clear them",
+	      &shell_tsch_profile_process);
+PROCESS(shell_tsch_burst_process, "tsch-burst");
+SHELL_COMMAND(tsch_burst_command,
+	      "tsch-burst",
+	      "tsch-burst [reset]: print the number of TSCH bursts per length (timeslots), or clear them",
+	      &shell_tsch_burst_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_tsch_profile_process, ev, data)
+{
+#if TSCH_SLOT_PROFILE
+  static const char *link_types[TSCH_SLOT_PROFILE_LINK_TYPES] = {
+    "normal", "adv", "adv-only"
+  };
+  char buf[80];
+  int phase;
+  int type;
+#if TSCH_SLOT_PROFILE_BUCKETS
+  int bucket;
+  int len;
+#endif
+#endif /* TSCH_SLOT_PROFILE */
+
+  PROCESS_BEGIN();
+
+#if TSCH_SLOT_PROFILE
+  if(data != NULL && strcmp(data, "reset") == 0) {
+    tsch_slot_profile_reset();
+    shell_output_str(&tsch_profile_command, "TSCH profile cleared", "");
+    PROCESS_EXIT();
+  }
+
+  shell_output_str(&tsch_profile_command, "phase link count min avg max", "");
+  for(type = 0; type < TSCH_SLOT_PROFILE_LINK_TYPES; type++) {
+    for(phase = 0; phase < TSCH_SLOT_PHASE_COUNT; phase++) {
+      const struct tsch_slot_profile_stats *s = tsch_slot_profile_get(phase, type);
+      if(s->count == 0) {
+        continue;
+      }
+      snprintf(buf, sizeof(buf), "%s %s %lu %lu %lu %lu",
+               tsch_slot_profile_phase_name(phase), link_types[type],
+               (unsigned long)s->count,
+               (unsigned long)RTIMERTICKS_TO_US(s->min),
+               (unsigned long)RTIMERTICKS_TO_US(s->sum / s->count),
+               (unsigned long)RTIMERTICKS_TO_US(s->max));
+      shell_output_str(&tsch_profile_command, buf, "");
+#if TSCH_SLOT_PROFILE_BUCKETS
+      /* Non-empty buckets, as <upper bound in us>:<count>, the last one
+         as more:<count> */
+      len = snprintf(buf, sizeof(buf), " hist");
+      for(bucket = 0; bucket < TSCH_SLOT_PROFILE_BUCKETS; bucket++) {
+        if(s->hist[bucket] == 0) {
+          continue;
+        }
+        if(len > (int)sizeof(buf) - 16) {
+          shell_output_str(&tsch_profile_command, buf, "");
+          len = snprintf(buf, sizeof(buf), " hist");
+        }
+        if(bucket == TSCH_SLOT_PROFILE_BUCKETS - 1) {
+          len += snprintf(buf + len, sizeof(buf) - len, " more:%u", s->hist[bucket]);
+        } else {
+          len += snprintf(buf + len, sizeof(buf) - len, " %lu:%u",
+                          (unsigned long)RTIMERTICKS_TO_US((rtimer_clock_t)1 << bucket),
+                          s->hist[bucket]);
+        }
+      }
+      shell_output_str(&tsch_profile_command, buf, "");
+#endif /* TSCH_SLOT_PROFILE_BUCKETS */
+    }
+    if(tsch_slot_profile_misses(type) != 0) {
+      snprintf(buf, sizeof(buf), "deadline misses %s %lu",
+               link_types[type], (unsigned long)tsch_slot_profile_misses(type));
+      shell_output_str(&tsch_profile_command, buf, "");
+    }
+  }
+#else /* TSCH_SLOT_PROFILE */
+  shell_output_str(&tsch_profile_command,
+                   "TSCH profiling disabled, set TSCH_CONF_SLOT_PROFILE", "");
+#endif /* TSCH_SLOT_PROFILE */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_tsch_burst_process, ev, data)
+{
+#if TSCH_BURST_MAX_LEN > 1
+  char buf[40];
+  int len;
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+
+  PROCESS_BEGIN();
+
+#if TSCH_BURST_MAX_LEN > 1
+  if(data != NULL && strcmp(data, "reset") == 0) {
+    tsch_burst_stats_reset();
+    shell_output_str(&tsch_burst_command, "TSCH burst statistics cleared", "");
+    PROCESS_EXIT();
+  }
+
+  shell_output_str(&tsch_burst_command, "len sent received", "");
+  for(len = 2; len <= TSCH_BURST_MAX_LEN; len++) {
+    snprintf(buf, sizeof(buf), "%d %lu %lu", len,
+             (unsigned long)tsch_burst_stats_get(1, len),
+             (unsigned long)tsch_burst_stats_get(0, len));
+    shell_output_str(&tsch_burst_command, buf, "");
+  }
+#else /* TSCH_BURST_MAX_LEN > 1 */
+  shell_output_str(&tsch_burst_command,
+                   "TSCH bursts disabled, set TSCH_CONF_BURST_MAX_LEN", "");
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+shell_tsch_init(void)
+{
+  shell_register_command(&tsch_profile_command);
+  shell_register_command(&tsch_burst_command);
+}
+/*---------------------------------------------------------------------------*/
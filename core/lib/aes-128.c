@@ -64,7 +64,31 @@ static const uint8_t sbox[256] =   {
 0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16 };
 
+#ifdef AES_128_CONF
+/* Another driver is in use, so only the keys themselves are cached */
+#define CACHED_ROUND_KEYS 1
+#else /* AES_128_CONF */
+#define CACHED_ROUND_KEYS 11
+#endif /* AES_128_CONF */
+
 static uint8_t round_keys[11][AES_128_KEY_LENGTH];
+static uint8_t (*current_round_keys)[AES_128_KEY_LENGTH] = round_keys;
+
+static uint8_t key_cache[AES_128_KEY_CACHE_SIZE][CACHED_ROUND_KEYS][AES_128_KEY_LENGTH];
+static uint8_t cached_keys;
+
+#if AES_128_WITH_T_TABLES
+/* t_tables[n][x] is the MixColumns column of the S-box output for x,
+   rotated right by n bytes. Built when the first key is set. */
+static uint32_t t_tables[4][256];
+static uint8_t t_tables_ready;
+
+#define GET_WORD(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) \
+                     | ((uint32_t)(p)[2] << 8) | (p)[3])
+#define PUT_WORD(p, w) do { \
+    (p)[0] = (w) >> 24; (p)[1] = (w) >> 16; (p)[2] = (w) >> 8; (p)[3] = (w); \
+  } while(0)
+#endif /* AES_128_WITH_T_TABLES */
 
 /*---------------------------------------------------------------------------*/
 /* multiplies by 2 in GF(2) */
@@ -75,28 +99,116 @@ galois_mul2(uint8_t value)
   return ((value << 1) ^ xor_val);
 }
 /*---------------------------------------------------------------------------*/
+#if AES_128_WITH_T_TABLES
 static void
-set_key(const uint8_t *key)
+init_t_tables(void)
+{
+  uint16_t x;
+  uint8_t n;
+  uint32_t s;
+  uint32_t s2;
+  uint32_t word;
+  
+  for(x = 0; x < 256; x++) {
+    s = sbox[x];
+    s2 = galois_mul2(s);
+    word = (s2 << 24) | (s << 16) | (s << 8) | (s2 ^ s);
+    for(n = 0; n < 4; n++) {
+      t_tables[n][x] = word;
+      word = (word >> 8) | (word << 24);
+    }
+  }
+  t_tables_ready = 1;
+}
+#endif /* AES_128_WITH_T_TABLES */
+/*---------------------------------------------------------------------------*/
+static void
+expand_key(uint8_t schedule[][AES_128_KEY_LENGTH], const uint8_t *key)
 {
   uint8_t i;
   uint8_t j;
   uint8_t rcon;
   
+#if AES_128_WITH_T_TABLES
+  if(!t_tables_ready) {
+    init_t_tables();
+  }
+#endif /* AES_128_WITH_T_TABLES */
+  
   rcon = 0x01;
-  memcpy(round_keys[0], key, AES_128_KEY_LENGTH);
+  memcpy(schedule[0], key, AES_128_KEY_LENGTH);
   for(i = 1; i <= 10; i++) {
-    round_keys[i][0] = sbox[round_keys[i - 1][13]] ^ round_keys[i - 1][0] ^ rcon;
-    round_keys[i][1] = sbox[round_keys[i - 1][14]] ^ round_keys[i - 1][1];
-    round_keys[i][2] = sbox[round_keys[i - 1][15]] ^ round_keys[i - 1][2];
-    round_keys[i][3] = sbox[round_keys[i - 1][12]] ^ round_keys[i - 1][3];
+    schedule[i][0] = sbox[schedule[i - 1][13]] ^ schedule[i - 1][0] ^ rcon;
+    schedule[i][1] = sbox[schedule[i - 1][14]] ^ schedule[i - 1][1];
+    schedule[i][2] = sbox[schedule[i - 1][15]] ^ schedule[i - 1][2];
+    schedule[i][3] = sbox[schedule[i - 1][12]] ^ schedule[i - 1][3];
     for(j = 4; j < AES_128_BLOCK_SIZE; j++) {
-      round_keys[i][j] = round_keys[i - 1][j] ^ round_keys[i][j - 4];
+      schedule[i][j] = schedule[i - 1][j] ^ schedule[i][j - 4];
     }
     rcon = galois_mul2(rcon);
   }
 }
 /*---------------------------------------------------------------------------*/
 static void
+set_key(const uint8_t *key)
+{
+  expand_key(round_keys, key);
+  current_round_keys = round_keys;
+}
+/*---------------------------------------------------------------------------*/
+#if AES_128_WITH_T_TABLES
+static void
+encrypt(uint8_t *state)
+{
+  uint32_t s0, s1, s2, s3;
+  uint32_t t0, t1, t2, t3;
+  const uint8_t *round_key;
+  uint8_t round;
+  
+  round_key = current_round_keys[0];
+  s0 = GET_WORD(state) ^ GET_WORD(round_key);
+  s1 = GET_WORD(state + 4) ^ GET_WORD(round_key + 4);
+  s2 = GET_WORD(state + 8) ^ GET_WORD(round_key + 8);
+  s3 = GET_WORD(state + 12) ^ GET_WORD(round_key + 12);
+  
+  for(round = 1; round < 10; round++) {
+    round_key = current_round_keys[round];
+    t0 = t_tables[0][s0 >> 24] ^ t_tables[1][(s1 >> 16) & 0xff]
+        ^ t_tables[2][(s2 >> 8) & 0xff] ^ t_tables[3][s3 & 0xff]
+        ^ GET_WORD(round_key);
+    t1 = t_tables[0][s1 >> 24] ^ t_tables[1][(s2 >> 16) & 0xff]
+        ^ t_tables[2][(s3 >> 8) & 0xff] ^ t_tables[3][s0 & 0xff]
+        ^ GET_WORD(round_key + 4);
+    t2 = t_tables[0][s2 >> 24] ^ t_tables[1][(s3 >> 16) & 0xff]
+        ^ t_tables[2][(s0 >> 8) & 0xff] ^ t_tables[3][s1 & 0xff]
+        ^ GET_WORD(round_key + 8);
+    t3 = t_tables[0][s3 >> 24] ^ t_tables[1][(s0 >> 16) & 0xff]
+        ^ t_tables[2][(s1 >> 8) & 0xff] ^ t_tables[3][s2 & 0xff]
+        ^ GET_WORD(round_key + 12);
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+  
+  /* last round skips MixColumn */
+  round_key = current_round_keys[10];
+  t0 = ((uint32_t)sbox[s0 >> 24] << 24) ^ ((uint32_t)sbox[(s1 >> 16) & 0xff] << 16)
+      ^ ((uint32_t)sbox[(s2 >> 8) & 0xff] << 8) ^ sbox[s3 & 0xff];
+  t1 = ((uint32_t)sbox[s1 >> 24] << 24) ^ ((uint32_t)sbox[(s2 >> 16) & 0xff] << 16)
+      ^ ((uint32_t)sbox[(s3 >> 8) & 0xff] << 8) ^ sbox[s0 & 0xff];
+  t2 = ((uint32_t)sbox[s2 >> 24] << 24) ^ ((uint32_t)sbox[(s3 >> 16) & 0xff] << 16)
+      ^ ((uint32_t)sbox[(s0 >> 8) & 0xff] << 8) ^ sbox[s1 & 0xff];
+  t3 = ((uint32_t)sbox[s3 >> 24] << 24) ^ ((uint32_t)sbox[(s0 >> 16) & 0xff] << 16)
+      ^ ((uint32_t)sbox[(s1 >> 8) & 0xff] << 8) ^ sbox[s2 & 0xff];
+  
+  PUT_WORD(state, t0 ^ GET_WORD(round_key));
+  PUT_WORD(state + 4, t1 ^ GET_WORD(round_key + 4));
+  PUT_WORD(state + 8, t2 ^ GET_WORD(round_key + 8));
+  PUT_WORD(state + 12, t3 ^ GET_WORD(round_key + 12));
+}
+#else /* AES_128_WITH_T_TABLES */
+static void
 encrypt(uint8_t *state)
 {
   uint8_t buf1, buf2, buf3, buf4, round, i;
@@ -104,7 +216,7 @@ encrypt(uint8_t *state)
   /* round 0 */
   /* AddRoundKey */
   for(i = 0; i < AES_128_BLOCK_SIZE; i++) {
-    state[i] = state[i] ^ round_keys[0][i];
+    state[i] = state[i] ^ current_round_keys[0][i];
   }
   
   for(round = 1; round <= 10; round++) {
@@ -161,10 +273,11 @@ encrypt(uint8_t *state)
     
     /* AddRoundKey */
     for(i = 0; i < AES_128_BLOCK_SIZE; i++) {
-      state[i] = state[i] ^ round_keys[round][i];
+      state[i] = state[i] ^ current_round_keys[round][i];
     }
   }
 }
+#endif /* AES_128_WITH_T_TABLES */
 /*---------------------------------------------------------------------------*/
 void
 aes_128_set_padded_key(uint8_t *key, uint8_t key_len)
@@ -176,6 +289,45 @@ aes_128_set_padded_key(uint8_t *key, uint8_t key_len)
   AES_128.set_key(block);
 }
 /*---------------------------------------------------------------------------*/
+int
+aes_128_add_key(const uint8_t *key)
+{
+  uint8_t i;
+  
+  for(i = 0; i < cached_keys; i++) {
+    if(memcmp(key_cache[i][0], key, AES_128_KEY_LENGTH) == 0) {
+      return i;
+    }
+  }
+  
+  if(cached_keys == AES_128_KEY_CACHE_SIZE) {
+    return -1;
+  }
+  
+#if CACHED_ROUND_KEYS > 1
+  expand_key(key_cache[cached_keys], key);
+#else /* CACHED_ROUND_KEYS > 1 */
+  memcpy(key_cache[cached_keys][0], key, AES_128_KEY_LENGTH);
+#endif /* CACHED_ROUND_KEYS > 1 */
+  return cached_keys++;
+}
+/*---------------------------------------------------------------------------*/
+void
+aes_128_use_key(int handle)
+{
+#if CACHED_ROUND_KEYS > 1
+  current_round_keys = key_cache[handle];
+#else /* CACHED_ROUND_KEYS > 1 */
+  AES_128.set_key(key_cache[handle][0]);
+#endif /* CACHED_ROUND_KEYS > 1 */
+}
+/*---------------------------------------------------------------------------*/
+const uint8_t *
+aes_128_get_key(int handle)
+{
+  return key_cache[handle][0];
+}
+/*---------------------------------------------------------------------------*/
 const struct aes_128_driver aes_128_driver = {
   set_key,
   encrypt
@@ -51,6 +51,24 @@
 #define AES_128            aes_128_driver
 #endif /* AES_128_CONF */
 
+/*
+ * The software driver can use four 1 KiB lookup tables that combine
+ * SubBytes, ShiftRows, and MixColumns, and operate on 32-bit words.
+ * This is considerably faster on 32- and 64-bit targets that have RAM
+ * to spare, but not on 8- and 16-bit MCUs.
+ */
+#ifdef AES_128_CONF_WITH_T_TABLES
+#define AES_128_WITH_T_TABLES AES_128_CONF_WITH_T_TABLES
+#else /* AES_128_CONF_WITH_T_TABLES */
+#define AES_128_WITH_T_TABLES 0
+#endif /* AES_128_CONF_WITH_T_TABLES */
+
+#ifdef AES_128_CONF_KEY_CACHE_SIZE
+#define AES_128_KEY_CACHE_SIZE AES_128_CONF_KEY_CACHE_SIZE
+#else /* AES_128_CONF_KEY_CACHE_SIZE */
+#define AES_128_KEY_CACHE_SIZE 2
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+
 /**
  * Structure of AES drivers.
  */
@@ -72,6 +90,24 @@ struct aes_128_driver {
  */
 void aes_128_set_padded_key(uint8_t *key, uint8_t key_len);
 
+/**
+ * \brief   Adds a key to the key cache. With the software driver, the
+ *          key schedule is expanded here once, rather than each time
+ *          the key is put in use.
+ * \return  A handle to the cached key, or -1 if the cache is full
+ */
+int aes_128_add_key(const uint8_t *key);
+
+/**
+ * \brief   Makes a cached key the current key of AES_128
+ */
+void aes_128_use_key(int handle);
+
+/**
+ * \brief   Returns a cached key
+ */
+const uint8_t *aes_128_get_key(int handle);
+
 extern const struct aes_128_driver AES_128;
 
 #endif /* AES_128_H_ */
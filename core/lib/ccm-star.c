@@ -59,34 +59,29 @@ set_iv(uint8_t *iv,
   iv[15] = counter;
 }
 /*---------------------------------------------------------------------------*/
-/* XORs the block m[pos] ... m[pos + 15] with K_{counter} */
 static void
-ctr_step(const uint8_t *nonce,
-    uint8_t pos,
-    uint8_t *m_and_result,
-    uint8_t m_len,
-    uint8_t counter)
+set_key(const uint8_t *key)
 {
-  uint8_t a[AES_128_BLOCK_SIZE];
-  uint8_t i;
-  
-  set_iv(a, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter);
-  AES_128.encrypt(a);
-  
-  for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-    m_and_result[pos + i] ^= a[i];
-  }
+  AES_128.set_key(key);
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Computes the CBC-MAC and the CTR keystream in a single pass over m, so
+ * that each block of m is only loaded once and no second loop over the
+ * message is needed.
+ */
 static void
-mic(const uint8_t *nonce,
-    const uint8_t *m, uint8_t m_len,
-    const uint8_t *a, uint8_t a_len,
-    uint8_t *result,
-    uint8_t mic_len)
+aead(const uint8_t* nonce,
+    uint8_t* m, uint8_t m_len,
+    const uint8_t* a, uint8_t a_len,
+    uint8_t *result, uint8_t mic_len,
+    int forward)
 {
   uint8_t x[AES_128_BLOCK_SIZE];
-  uint8_t pos;
+  uint8_t s[AES_128_BLOCK_SIZE];
+  uint16_t pos;
+  uint8_t block_len;
+  uint8_t counter;
   uint8_t i;
   
   set_iv(x, CCM_STAR_AUTH_FLAGS(a_len, mic_len), nonce, m_len);
@@ -110,64 +105,43 @@ mic(const uint8_t *nonce,
     }
   }
   
-  if(m_len) {
-    pos = 0;
-    while(pos < m_len) {
-      for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
+  counter = 1;
+  for(pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
+    block_len = MIN(AES_128_BLOCK_SIZE, m_len - pos);
+    
+    set_iv(s, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+    AES_128.encrypt(s);
+    
+    /* the MIC is always computed over the plaintext */
+    if(forward) {
+      for(i = 0; i < block_len; i++) {
+        x[i] ^= m[pos + i];
+        m[pos + i] ^= s[i];
+      }
+    } else {
+      for(i = 0; i < block_len; i++) {
+        m[pos + i] ^= s[i];
         x[i] ^= m[pos + i];
       }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
     }
+    AES_128.encrypt(x);
   }
   
-  ctr_step(nonce, 0, x, AES_128_BLOCK_SIZE, 0);
-  
-  memcpy(result, x, mic_len);
-}
-/*---------------------------------------------------------------------------*/
-static void
-ctr(const uint8_t *nonce, uint8_t *m, uint8_t m_len)
-{
-  uint8_t pos;
-  uint8_t counter;
-  
-  pos = 0;
-  counter = 1;
-  while(pos < m_len) {
-    ctr_step(nonce, pos, m, m_len, counter++);
-    pos += AES_128_BLOCK_SIZE;
+  set_iv(s, CCM_STAR_ENCRYPTION_FLAGS, nonce, 0);
+  AES_128.encrypt(s);
+  for(i = 0; i < mic_len; i++) {
+    result[i] = x[i] ^ s[i];
   }
 }
 /*---------------------------------------------------------------------------*/
-static void
-set_key(const uint8_t *key)
+void
+ccm_star_use_key(int handle)
 {
-  AES_128.set_key(key);
-}
-/*---------------------------------------------------------------------------*/
-static void
-aead(const uint8_t* nonce,
-    uint8_t* m, uint8_t m_len,
-    const uint8_t* a, uint8_t a_len,
-    uint8_t *result, uint8_t mic_len,
-    int forward)
-{
-  if(!forward) {
-    /* decrypt */
-    ctr(nonce, m, m_len);
-  }
-  
-  mic(nonce,
-    m, m_len,
-    a, a_len,
-    result,
-    mic_len);
-  
-  if(forward) {
-    /* encrypt */
-    ctr(nonce, m, m_len);
-  }
+#ifdef CCM_STAR_CONF
+  CCM_STAR.set_key(aes_128_get_key(handle));
+#else /* CCM_STAR_CONF */
+  aes_128_use_key(handle);
+#endif /* CCM_STAR_CONF */
 }
 /*---------------------------------------------------------------------------*/
 const struct ccm_star_driver ccm_star_driver = {
@@ -79,4 +79,10 @@ struct ccm_star_driver {
 
 extern const struct ccm_star_driver CCM_STAR;
 
+/**
+ * \brief         Makes a key from the AES-128 key cache the key in use.
+ * \param handle  The handle returned by aes_128_add_key().
+ */
+void ccm_star_use_key(int handle);
+
 #endif /* CCM_STAR_H_ */
@@ -45,6 +45,7 @@
 #if NETSTACK_CONF_WITH_IPV6
 #include "net/ipv6/uip-nd6.h"
 #include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-bufpool.h"
 #endif
 
 #include <string.h>
@@ -103,7 +104,8 @@ static struct internal_state {
 enum {
   TCP_POLL,
   UDP_POLL,
-  PACKET_INPUT
+  PACKET_INPUT,
+  PACKET_QUEUED
 };
 
 /* Called on IP packet output. */
@@ -510,12 +512,31 @@ eventhandler(process_event_t ev, process_data_t data)
     case PACKET_INPUT:
       packet_input();
       break;
+
+#if UIP_BUFFER_POOL_SIZE
+    case PACKET_QUEUED:
+      /* Handle every queued packet, in case an earlier event was lost */
+      while(uip_bufpool_dequeue()) {
+        packet_input();
+        uip_clear_buf();
+      }
+      break;
+#endif /* UIP_BUFFER_POOL_SIZE */
   };
 }
 /*---------------------------------------------------------------------------*/
 void
 tcpip_input(void)
 {
+#if UIP_BUFFER_POOL_SIZE
+  /* Let the driver go on while the packet waits in the pool */
+  if(uip_bufpool_enqueue()) {
+    process_post(&tcpip_process, PACKET_QUEUED, NULL);
+    return;
+  }
+  /* The pool is full. Handle the oldest packet now to keep the order. */
+  uip_bufpool_exchange();
+#endif /* UIP_BUFFER_POOL_SIZE */
   process_post_synch(&tcpip_process, PACKET_INPUT, NULL);
   uip_clear_buf();
 }
@@ -696,6 +717,7 @@ tcpip_ipv6_output(void)
         nbr->state = NBR_DELAY;
         stimer_set(&nbr->reachable, UIP_ND6_DELAY_FIRST_PROBE_TIME);
         nbr->nscount = 0;
+        uip_ds6_nbr_reschedule(nbr);
         PRINTF("tcpip_ipv6_output: nbr cache entry stale moving to delay\n");
       }
 #endif /* UIP_ND6_SEND_NA */
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ */
+
+/**
+ * \file
+ *         Internet checksum computed a 32-bit word at a time
+ *
+ *         The one's complement sum does not depend on byte order
+ *         (RFC 1071), so the buffer is summed as native-endian words
+ *         and only the folded result is converted to host order. A
+ *         buffer that starts at an odd address is summed from the next
+ *         byte, which swaps the bytes of the partial sum. Words are
+ *         loaded with memcpy, which compilers turn into plain loads
+ *         where the target allows it, without breaking strict aliasing.
+ */
+
+#include "net/ip/uip.h"
+#include "net/ip/uip-chksum.h"
+
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+fold(uint64_t acc)
+{
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
+/*---------------------------------------------------------------------------*/
+static inline uint32_t
+load32(const uint8_t *data)
+{
+  uint32_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+/*---------------------------------------------------------------------------*/
+static inline uint16_t
+load16(const uint8_t *data)
+{
+  uint16_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_words(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint64_t acc;
+  uint16_t word;
+  uint16_t result;
+  uint8_t odd;
+
+  acc = 0;
+  word = 0;
+  odd = 0;
+
+  /* Align to 16 bits. The first byte is the high half of a word. */
+  if(len > 0 && ((uintptr_t)data & 1)) {
+    ((uint8_t *)&word)[0] = *data++;
+    len--;
+    odd = 1;
+  }
+
+  /* Align to 32 bits */
+  if(len >= 2 && ((uintptr_t)data & 2)) {
+    acc += load16(data);
+    data += 2;
+    len -= 2;
+  }
+
+  while(len >= 16) {
+    acc += load32(data);
+    acc += load32(data + 4);
+    acc += load32(data + 8);
+    acc += load32(data + 12);
+    data += 16;
+    len -= 16;
+  }
+  while(len >= 4) {
+    acc += load32(data);
+    data += 4;
+    len -= 4;
+  }
+
+  if(len >= 2) {
+    acc += load16(data);
+    data += 2;
+    len -= 2;
+  }
+  if(len > 0) {
+    uint16_t last = 0;
+    ((uint8_t *)&last)[0] = *data;
+    acc += last;
+  }
+
+  result = fold(acc);
+  if(odd) {
+    result = (result << 8) | (result >> 8);
+    result = fold((uint32_t)result + word);
+  }
+
+  /* Add the partial sum, now in host byte order. */
+  result = UIP_HTONS(result);
+  result += sum;
+  if(result < sum) {
+    result++;
+  }
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -517,10 +517,17 @@ typedef union {
   uint8_t u8[UIP_BUFSIZE];
 } uip_buf_t;
 
+#if UIP_BUFFER_POOL_SIZE
+CCIF extern uip_buf_t *uip_bufp;
+
+/** Macro to access the current buffer of the pool as an array of bytes */
+#define uip_buf (uip_bufp->u8)
+#else /* UIP_BUFFER_POOL_SIZE */
 CCIF extern uip_buf_t uip_aligned_buf;
 
 /** Macro to access uip_aligned_buf as an array of bytes */
 #define uip_buf (uip_aligned_buf.u8)
+#endif /* UIP_BUFFER_POOL_SIZE */
 
 
 /** @} */
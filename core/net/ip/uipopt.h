@@ -175,6 +175,22 @@
 #define UIP_BUFSIZE (UIP_CONF_BUFFER_SIZE)
 #endif /* UIP_CONF_BUFFER_SIZE */
 
+/**
+ * The number of packet buffers of the IPv6 stack.
+ *
+ * With more than one buffer, uip_buf refers to the current buffer of
+ * a pool. tcpip_input() then queues the received packet by handle and
+ * returns with a fresh buffer, and the tcpip process handles the queued
+ * packets in order. 0 keeps a single static uip_buf.
+ *
+ * \hideinitializer
+ */
+#if defined(UIP_CONF_BUFFER_POOL_SIZE) && NETSTACK_CONF_WITH_IPV6
+#define UIP_BUFFER_POOL_SIZE (UIP_CONF_BUFFER_POOL_SIZE)
+#else /* UIP_CONF_BUFFER_POOL_SIZE */
+#define UIP_BUFFER_POOL_SIZE 0
+#endif /* UIP_CONF_BUFFER_POOL_SIZE */
+
 
 /**
  * Determines if statistics support should be compiled in.
@@ -619,6 +635,22 @@ void uip_log(char *msg);
 #define UIP_BYTE_ORDER     (UIP_LITTLE_ENDIAN)
 #endif /* UIP_CONF_BYTE_ORDER */
 
+/**
+ * Compute the Internet checksum with 32-bit loads into a 64-bit
+ * accumulator instead of 16 bits at a time.
+ *
+ * This is faster on 32- and 64-bit CPUs, but slower on 8- and 16-bit
+ * ones. It is not used if the architecture provides its own checksum
+ * functions (UIP_ARCH_CHKSUM).
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_WORD_CHKSUM
+#define UIP_WORD_CHKSUM    (UIP_CONF_WORD_CHKSUM)
+#else /* UIP_CONF_WORD_CHKSUM */
+#define UIP_WORD_CHKSUM    0
+#endif /* UIP_CONF_WORD_CHKSUM */
+
 /** @} */
 /*------------------------------------------------------------------------------*/
 
@@ -74,6 +74,7 @@
 #include "net/ip/uipopt.h"
 #include "net/ipv4/uip_arp.h"
 #include "net/ip/uip_arch.h"
+#include "net/ip/uip-chksum.h"
 
 #include "net/ipv4/uip-neighbor.h"
 
@@ -263,6 +264,9 @@ uip_add32(uint8_t *op32, uint16_t op16)
 static uint16_t
 chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 {
+#if UIP_WORD_CHKSUM
+  return uip_chksum_words(sum, data, len);
+#else /* UIP_WORD_CHKSUM */
   uint16_t t;
   const uint8_t *dataptr;
   const uint8_t *last_byte;
@@ -289,6 +293,7 @@ chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 
   /* Return sum in host byte order. */
   return sum;
+#endif /* UIP_WORD_CHKSUM */
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -199,6 +199,7 @@ struct sliding_window {
   int16_t lower_bound;          /* lolipop */
   int16_t upper_bound;          /* lolipop */
   int16_t min_listed;           /* lolipop */
+  uint32_t seen;                /* Bloom filter of buffered seq. values */
   uint8_t flags;                /* Is used, Trickle param, Is listed */
   uint8_t count;
 };
@@ -207,6 +208,7 @@ struct sliding_window {
 #define SLIDING_WINDOW_M_BIT 0x40       /* Window trickle parametrization */
 #define SLIDING_WINDOW_L_BIT 0x20       /* Current ICMP message lists us */
 #define SLIDING_WINDOW_B_BIT 0x10       /* Used when updating bounds */
+#define SLIDING_WINDOW_H_BIT 0x08       /* Is in the Seed ID index */
 
 /**
  * \brief Is Occupied sliding window location w
@@ -263,6 +265,18 @@ struct sliding_window {
  */
 #define SLIDING_WINDOW_GET_M(w) \
   ((uint8_t)(((w)->flags & SLIDING_WINDOW_M_BIT) == SLIDING_WINDOW_M_BIT))
+
+/**
+ * \brief Bit of sequence value s in the 'seen' filter of a sliding window
+ *
+ * A clear bit means that no packet with this sequence value is buffered for
+ * the window, so the buffers need not be searched. A set bit may be stale:
+ * Bits are only cleared when window_update_bounds() rebuilds the filter.
+ * Consecutive sequence values map to different bits.
+ */
+#define SLIDING_WINDOW_SEEN_BIT(s) ((uint32_t)1 << ((s) & 0x1F))
+#define SLIDING_WINDOW_MAY_HAVE_SEEN(w, s) \
+  (((w)->seen & SLIDING_WINDOW_SEEN_BIT(s)) != 0)
 /*---------------------------------------------------------------------------*/
 /* Multicast Packet Buffers */
 struct mcast_packet {
@@ -443,6 +457,20 @@ static struct roll_tm_stats stats;
 static struct trickle_param t[2];
 static struct sliding_window windows[ROLL_TM_WINS];
 static struct mcast_packet buffered_msgs[ROLL_TM_BUFF_NUM];
+#if ROLL_TM_WIN_HASH_SIZE
+/*
+ * Index of the sliding windows by Seed ID and M. Each bucket is a chain of
+ * window indexes, linked through win_hash_next[]. Like the linear search, the
+ * index still finds a window after window_free(), until the window gets a new
+ * Seed ID.
+ */
+#define WIN_NONE 0xFF
+#if ROLL_TM_WINS >= WIN_NONE
+#error "ROLL_TM_CONF_WINS must be less than 255 with the window index"
+#endif
+static uint8_t win_hash_heads[ROLL_TM_WIN_HASH_SIZE];
+static uint8_t win_hash_next[ROLL_TM_WINS];
+#endif
 /*---------------------------------------------------------------------------*/
 /* Temporary Stores */
 /*---------------------------------------------------------------------------*/
@@ -698,9 +726,66 @@ window_allocate()
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if ROLL_TM_WIN_HASH_SIZE
+static uint8_t *
+window_bucket(seed_id_t *s, uint8_t m)
+{
+  uint8_t h = m;
+  uint8_t i;
+
+  for(i = 0; i < sizeof(seed_id_t); i++) {
+    h ^= ((uint8_t *)s)[i];
+  }
+  return &win_hash_heads[h % ROLL_TM_WIN_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+static void
+window_index_add(struct sliding_window *w)
+{
+  uint8_t *bucket = window_bucket(&w->seed_id, SLIDING_WINDOW_GET_M(w));
+
+  win_hash_next[w - windows] = *bucket;
+  *bucket = w - windows;
+  w->flags |= SLIDING_WINDOW_H_BIT;
+}
+/*---------------------------------------------------------------------------*/
+static void
+window_index_remove(struct sliding_window *w)
+{
+  uint8_t *link;
+
+  if(!(w->flags & SLIDING_WINDOW_H_BIT)) {
+    return;
+  }
+  for(link = window_bucket(&w->seed_id, SLIDING_WINDOW_GET_M(w));
+      *link != WIN_NONE; link = &win_hash_next[*link]) {
+    if(*link == w - windows) {
+      *link = win_hash_next[*link];
+      break;
+    }
+  }
+  w->flags &= ~SLIDING_WINDOW_H_BIT;
+}
+#endif /* ROLL_TM_WIN_HASH_SIZE */
+/*---------------------------------------------------------------------------*/
 static struct sliding_window *
 window_lookup(seed_id_t *s, uint8_t m)
 {
+#if ROLL_TM_WIN_HASH_SIZE
+  uint8_t i;
+
+  for(i = *window_bucket(s, m); i != WIN_NONE; i = win_hash_next[i]) {
+    iterswptr = &windows[i];
+    VERBOSE_PRINTF("ROLL TM: M=%u (%u) ", SLIDING_WINDOW_GET_M(iterswptr), m);
+    VERBOSE_PRINT_SEED(&iterswptr->seed_id);
+    VERBOSE_PRINTF("\n");
+    if(seed_id_cmp(s, &iterswptr->seed_id) &&
+       SLIDING_WINDOW_GET_M(iterswptr) == m) {
+      return iterswptr;
+    }
+  }
+  return NULL;
+#else
   for(iterswptr = &windows[ROLL_TM_WINS - 1]; iterswptr >= windows;
       iterswptr--) {
     VERBOSE_PRINTF("ROLL TM: M=%u (%u) ", SLIDING_WINDOW_GET_M(iterswptr), m);
@@ -712,6 +797,7 @@ window_lookup(seed_id_t *s, uint8_t m)
     }
   }
   return NULL;
+#endif /* ROLL_TM_WIN_HASH_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -720,6 +806,7 @@ window_update_bounds()
   for(iterswptr = &windows[ROLL_TM_WINS - 1]; iterswptr >= windows;
       iterswptr--) {
     iterswptr->lower_bound = -1;
+    iterswptr->seen = 0;
   }
 
   for(locmpptr = &buffered_msgs[ROLL_TM_BUFF_NUM - 1];
@@ -729,6 +816,7 @@ window_update_bounds()
       VERBOSE_PRINTF("ROLL TM: Update Bounds: [%d - %d] vs %u\n",
                      iterswptr->lower_bound, iterswptr->upper_bound,
                      locmpptr->seq_val);
+      iterswptr->seen |= SLIDING_WINDOW_SEEN_BIT(locmpptr->seq_val);
       if(iterswptr->lower_bound < 0
          || SEQ_VAL_IS_LT(locmpptr->seq_val, iterswptr->lower_bound)) {
         iterswptr->lower_bound = locmpptr->seq_val;
@@ -979,7 +1067,8 @@ accept(uint8_t in)
       return UIP_MCAST6_DROP;
     }
     for(locmpptr = &buffered_msgs[ROLL_TM_BUFF_NUM - 1];
-        locmpptr >= buffered_msgs; locmpptr--) {
+        locmpptr >= buffered_msgs &&
+        SLIDING_WINDOW_MAY_HAVE_SEEN(locswptr, seq_val); locmpptr--) {
       if(MCAST_PACKET_IS_USED(locmpptr) &&
          locmpptr->sw == locswptr &&
          SLIDING_WINDOW_GET_M(locmpptr->sw) == m &&
@@ -1032,12 +1121,18 @@ accept(uint8_t in)
 
   /* We have a window and we have a buffer. Accept this message */
   /* Set the seed ID and correct M for this window */
+#if ROLL_TM_WIN_HASH_SIZE
+  window_index_remove(locswptr);
+#endif
   SLIDING_WINDOW_M_CLR(locswptr);
   if(m) {
     SLIDING_WINDOW_M_SET(locswptr);
   }
   SLIDING_WINDOW_IS_USED_SET(locswptr);
   seed_id_cpy(&locswptr->seed_id, seed_ptr);
+#if ROLL_TM_WIN_HASH_SIZE
+  window_index_add(locswptr);
+#endif
   PRINTF("ROLL TM: Window for seed ");
   PRINT_SEED(&locswptr->seed_id);
   PRINTF(" M=%u, count=%u\n",
@@ -1045,6 +1140,7 @@ accept(uint8_t in)
 
   /* If this window was previously empty, set its lower bound to this packet */
   if(locswptr->count == 0) {
+    locswptr->seen = 0;
     locswptr->lower_bound = seq_val;
     VERBOSE_PRINTF("ROLL TM: New Lower Bound %u\n", locswptr->lower_bound);
   }
@@ -1056,6 +1152,7 @@ accept(uint8_t in)
   }
 
   locswptr->count++;
+  locswptr->seen |= SLIDING_WINDOW_SEEN_BIT(seq_val);
 
   memset(locmpptr, 0, sizeof(struct mcast_packet));
   memcpy(&locmpptr->buff, UIP_IP_BUF, uip_len);
@@ -1223,7 +1320,8 @@ icmp_input()
           inconsistency = 1;
           /* Check if the advertised sequence is in our buffer */
           for(locmpptr = &buffered_msgs[ROLL_TM_BUFF_NUM - 1];
-              locmpptr >= buffered_msgs; locmpptr--) {
+              locmpptr >= buffered_msgs &&
+              SLIDING_WINDOW_MAY_HAVE_SEEN(locswptr, val); locmpptr--) {
             if(MCAST_PACKET_IS_USED(locmpptr) && locmpptr->sw == locswptr) {
               if(SEQ_VAL_IS_EQ(locmpptr->seq_val, val)) {
 
@@ -1416,6 +1514,9 @@ init()
   memset(windows, 0, sizeof(windows));
   memset(buffered_msgs, 0, sizeof(buffered_msgs));
   memset(t, 0, sizeof(t));
+#if ROLL_TM_WIN_HASH_SIZE
+  memset(win_hash_heads, WIN_NONE, sizeof(win_hash_heads));
+#endif
 
   ROLL_TM_STATS_INIT();
   UIP_MCAST6_STATS_INIT(&stats);
@@ -187,6 +187,16 @@
 #define ROLL_TM_BUFF_NUM 6
 #endif
 /*---------------------------------------------------------------------------*/
+/**
+ * Number of buckets of the index of sliding windows by Seed ID and M.
+ * 0: Search the windows linearly
+ */
+#ifdef ROLL_TM_CONF_WIN_HASH_SIZE
+#define ROLL_TM_WIN_HASH_SIZE ROLL_TM_CONF_WIN_HASH_SIZE
+#else
+#define ROLL_TM_WIN_HASH_SIZE ROLL_TM_WINS
+#endif
+/*---------------------------------------------------------------------------*/
 /**
  * Use Short Seed IDs [short: 2, long: 16 (default)]
  * It can be argued that we should (and it would be easy to) support both at
@@ -56,15 +56,84 @@
 #else
 #define UIP_MCAST6_ROUTE_ROUTES 1
 #endif /* UIP_CONF_DS6_MCAST_ROUTES */
+
+/* Number of buckets of the group index, 0 to search the list linearly */
+#ifdef UIP_MCAST6_ROUTE_CONF_HASH_SIZE
+#define UIP_MCAST6_ROUTE_HASH_SIZE UIP_MCAST6_ROUTE_CONF_HASH_SIZE
+#else
+#define UIP_MCAST6_ROUTE_HASH_SIZE UIP_MCAST6_ROUTE_ROUTES
+#endif /* UIP_MCAST6_ROUTE_CONF_HASH_SIZE */
 /*---------------------------------------------------------------------------*/
 LIST(mcast_route_list);
 MEMB(mcast_route_memb, uip_mcast6_route_t, UIP_MCAST6_ROUTE_ROUTES);
 
 static uip_mcast6_route_t *locmcastrt;
+
+#if UIP_MCAST6_ROUTE_HASH_SIZE
+/*
+ * Index of the routes by group. Each bucket is a chain of route slots in
+ * mcast_route_memb, linked through hash_next[]. A route is in the index
+ * while it is in mcast_route_list.
+ */
+#if UIP_MCAST6_ROUTE_ROUTES < 0xff
+typedef uint8_t route_slot_t;
+#else
+typedef uint16_t route_slot_t;
+#endif
+#define SLOT_NONE ((route_slot_t)~0)
+
+static route_slot_t hash_heads[UIP_MCAST6_ROUTE_HASH_SIZE];
+static route_slot_t hash_next[UIP_MCAST6_ROUTE_ROUTES];
+
+#define route_from_slot(s) (&((uip_mcast6_route_t *)mcast_route_memb.mem)[s])
+#define slot_from_route(r) ((r) - (uip_mcast6_route_t *)mcast_route_memb.mem)
+/*---------------------------------------------------------------------------*/
+static route_slot_t *
+hash_bucket(const uip_ipaddr_t *group)
+{
+  /* Group IDs are in the low-order bytes of the address */
+  uint8_t h = group->u8[12] ^ group->u8[13] ^ group->u8[14] ^ group->u8[15];
+
+  return &hash_heads[h % UIP_MCAST6_ROUTE_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_add(uip_mcast6_route_t *route)
+{
+  route_slot_t *bucket = hash_bucket(&route->group);
+
+  hash_next[slot_from_route(route)] = *bucket;
+  *bucket = slot_from_route(route);
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(uip_mcast6_route_t *route)
+{
+  route_slot_t *link;
+
+  for(link = hash_bucket(&route->group); *link != SLOT_NONE;
+      link = &hash_next[*link]) {
+    if(*link == slot_from_route(route)) {
+      *link = hash_next[*link];
+      return;
+    }
+  }
+}
+#endif /* UIP_MCAST6_ROUTE_HASH_SIZE */
 /*---------------------------------------------------------------------------*/
 uip_mcast6_route_t *
 uip_mcast6_route_lookup(uip_ipaddr_t *group)
 {
+#if UIP_MCAST6_ROUTE_HASH_SIZE
+  route_slot_t slot;
+
+  for(slot = *hash_bucket(group); slot != SLOT_NONE; slot = hash_next[slot]) {
+    if(uip_ipaddr_cmp(&route_from_slot(slot)->group, group)) {
+      return route_from_slot(slot);
+    }
+  }
+  return NULL;
+#else /* UIP_MCAST6_ROUTE_HASH_SIZE */
   locmcastrt = NULL;
   for(locmcastrt = list_head(mcast_route_list);
       locmcastrt != NULL;
@@ -75,6 +144,7 @@ uip_mcast6_route_lookup(uip_ipaddr_t *group)
   }
 
   return NULL;
+#endif /* UIP_MCAST6_ROUTE_HASH_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 uip_mcast6_route_t *
@@ -89,12 +159,14 @@ uip_mcast6_route_add(uip_ipaddr_t *group)
       return NULL;
     }
     list_add(mcast_route_list, locmcastrt);
+    uip_ipaddr_copy(&(locmcastrt->group), group);
+#if UIP_MCAST6_ROUTE_HASH_SIZE
+    hash_add(locmcastrt);
+#endif
   }
 
   /* Reaching here means we either found the prefix or allocated a new one */
 
-  uip_ipaddr_copy(&(locmcastrt->group), group);
-
   return locmcastrt;
 }
 /*---------------------------------------------------------------------------*/
@@ -106,6 +178,9 @@ uip_mcast6_route_rm(uip_mcast6_route_t *route)
       locmcastrt != NULL;
       locmcastrt = list_item_next(locmcastrt)) {
     if(locmcastrt == route) {
+#if UIP_MCAST6_ROUTE_HASH_SIZE
+      hash_remove(route);
+#endif
       list_remove(mcast_route_list, route);
       memb_free(&mcast_route_memb, route);
       return;
@@ -130,6 +205,9 @@ uip_mcast6_route_init()
 {
   memb_init(&mcast_route_memb);
   list_init(mcast_route_list);
+#if UIP_MCAST6_ROUTE_HASH_SIZE
+  memset(hash_heads, 0xff, sizeof(hash_heads));
+#endif
 }
 /*---------------------------------------------------------------------------*/
 /** @} */
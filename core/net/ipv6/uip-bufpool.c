@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \addtogroup uip6
+ * @{
+ */
+
+/**
+ * \file
+ *         Pool of uIP packet buffers
+ */
+
+#include "net/ip/uip.h"
+#include "net/ipv6/uip-bufpool.h"
+#include "net/packetbuf.h"
+
+#define DEBUG DEBUG_NONE
+#include "net/ip/uip-debug.h"
+
+#if UIP_BUFFER_POOL_SIZE
+
+#if UIP_BUFFER_POOL_SIZE < 2
+#error "UIP_CONF_BUFFER_POOL_SIZE must be 0 or at least 2"
+#endif
+
+static uip_buf_t pool[UIP_BUFFER_POOL_SIZE];
+
+/* The buffer that uip_buf refers to */
+uip_buf_t *uip_bufp = &pool[0];
+
+/* Handles of the queued packets, oldest first, and their lengths */
+static uint8_t queue[UIP_BUFFER_POOL_SIZE];
+static uint16_t queue_len[UIP_BUFFER_POOL_SIZE];
+
+/* The packetbuf attributes of the frames that carried the queued
+   packets, which upper layers (RPL, ND) read when they process them */
+static struct {
+  linkaddr_t sender;
+  linkaddr_t receiver;
+  packetbuf_attr_t rssi;
+  packetbuf_attr_t link_quality;
+} queue_info[UIP_BUFFER_POOL_SIZE];
+static uint8_t queue_head;
+static uint8_t queued;
+
+/* Handles of the buffers that are neither current nor queued */
+static uint8_t free_list[UIP_BUFFER_POOL_SIZE];
+static uint8_t free_count;
+static uint8_t initialized;
+
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+  uint8_t i;
+
+  /* pool[0] is the initial current buffer */
+  for(i = 1; i < UIP_BUFFER_POOL_SIZE; i++) {
+    free_list[free_count++] = i;
+  }
+  initialized = 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+push_current(void)
+{
+  uint8_t slot;
+
+  slot = (queue_head + queued) % UIP_BUFFER_POOL_SIZE;
+  queue[slot] = uip_bufp - pool;
+  queue_len[slot] = uip_len;
+  linkaddr_copy(&queue_info[slot].sender,
+                packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  linkaddr_copy(&queue_info[slot].receiver,
+                packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+  queue_info[slot].rssi = packetbuf_attr(PACKETBUF_ATTR_RSSI);
+  queue_info[slot].link_quality = packetbuf_attr(PACKETBUF_ATTR_LINK_QUALITY);
+  queued++;
+
+  PRINTF("uip-bufpool: queued %u bytes in buffer %u, %u queued\n",
+         queue_len[slot], queue[slot], queued);
+}
+/*---------------------------------------------------------------------------*/
+static void
+pop_current(void)
+{
+  uip_bufp = &pool[queue[queue_head]];
+  uip_len = queue_len[queue_head];
+  uip_ext_len = 0;
+  /* Later frames have overwritten packetbuf since the packet was queued */
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &queue_info[queue_head].sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER,
+                     &queue_info[queue_head].receiver);
+  packetbuf_set_attr(PACKETBUF_ATTR_RSSI, queue_info[queue_head].rssi);
+  packetbuf_set_attr(PACKETBUF_ATTR_LINK_QUALITY,
+                     queue_info[queue_head].link_quality);
+  queue_head = (queue_head + 1) % UIP_BUFFER_POOL_SIZE;
+  queued--;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_bufpool_enqueue(void)
+{
+  if(!initialized) {
+    init();
+  }
+
+  if(free_count == 0) {
+    PRINTF("uip-bufpool: no free buffer\n");
+    return 0;
+  }
+
+  push_current();
+  uip_bufp = &pool[free_list[--free_count]];
+  uip_clear_buf();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_bufpool_dequeue(void)
+{
+  if(queued == 0) {
+    return 0;
+  }
+
+  free_list[free_count++] = uip_bufp - pool;
+  pop_current();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_bufpool_exchange(void)
+{
+  if(queued == 0) {
+    return 0;
+  }
+
+  /* The queue has room for every buffer but the current one */
+  push_current();
+  pop_current();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_bufpool_queued(void)
+{
+  return queued;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* UIP_BUFFER_POOL_SIZE */
+/** @} */
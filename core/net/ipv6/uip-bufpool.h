@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \addtogroup uip6
+ * @{
+ */
+
+/**
+ * \file
+ *         Pool of uIP packet buffers
+ *
+ *         With UIP_CONF_BUFFER_POOL_SIZE set, uip_buf is the current
+ *         buffer of this pool. Received packets are queued by handle
+ *         instead of being processed while the driver waits, and the
+ *         single-buffer API (uip_buf, uip_len) works unchanged on
+ *         whichever buffer is current. The link-layer sender and
+ *         receiver addresses, RSSI and link quality of a queued packet
+ *         are saved with it, and restored into packetbuf when it
+ *         becomes current again.
+ */
+
+#ifndef UIP_BUFPOOL_H_
+#define UIP_BUFPOOL_H_
+
+#include "net/ip/uip.h"
+
+/**
+ * \brief  Queue the packet in uip_buf and switch to a free buffer
+ * \retval 1 The packet was queued. uip_buf is a free buffer and
+ *           uip_len is 0.
+ * \retval 0 All buffers are in use. uip_buf is unchanged.
+ */
+int uip_bufpool_enqueue(void);
+
+/**
+ * \brief  Make the oldest queued packet the current uip_buf
+ * \retval 1 uip_buf and uip_len hold the dequeued packet. The
+ *           previous current buffer is free.
+ * \retval 0 No packet was queued.
+ */
+int uip_bufpool_dequeue(void);
+
+/**
+ * \brief  Queue the packet in uip_buf and make the oldest queued
+ *         packet the current uip_buf, without needing a free buffer
+ * \retval 1 The packets were exchanged
+ * \retval 0 No packet was queued. uip_buf is unchanged.
+ */
+int uip_bufpool_exchange(void);
+
+/** \brief The number of packets waiting in the queue */
+int uip_bufpool_queued(void);
+
+#endif /* UIP_BUFPOOL_H_ */
+/** @} */
@@ -70,10 +70,188 @@ void LINK_NEIGHBOR_CALLBACK(const linkaddr_t *addr, int status, int numtx);
 
 NBR_TABLE_GLOBAL(uip_ds6_nbr_t, ds6_neighbors);
 
+/* Index of an entry in the neighbor table */
+#if NBR_TABLE_MAX_NEIGHBORS < 0xff
+typedef uint8_t nbr_slot_t;
+#else
+typedef uint16_t nbr_slot_t;
+#endif
+#define SLOT_NONE ((nbr_slot_t)~0)
+
+/*
+ * Neighbors with a pending timer, ordered by deadline (in seconds).
+ * uip_ds6_neighbor_periodic() only looks at the neighbors at the head
+ * that are due, and computes their next deadline from their state. A
+ * neighbor that is due early is harmless, so only a change that moves
+ * a deadline earlier needs uip_ds6_nbr_reschedule().
+ */
+static nbr_slot_t sched_head = SLOT_NONE;
+static nbr_slot_t sched_next[NBR_TABLE_MAX_NEIGHBORS];
+static unsigned long sched_deadline[NBR_TABLE_MAX_NEIGHBORS];
+/*
+ * Neighbors that uip_ds6_neighbor_periodic() found still due, e.g.
+ * because their NS had to wait. They are put back at the head of the
+ * schedule when the walk ends. The list is global so that a neighbor
+ * removed during the walk (sending an NS may evict entries from the
+ * neighbor table) is also unlinked from it.
+ */
+static nbr_slot_t sched_deferred = SLOT_NONE;
+static nbr_slot_t *sched_deferred_tail = &sched_deferred;
+
+/*---------------------------------------------------------------------------*/
+static nbr_slot_t
+slot_from_nbr(const uip_ds6_nbr_t *nbr)
+{
+  return nbr - _ds6_neighbors_mem;
+}
+
+#if UIP_DS6_NBR_HASH_SIZE
+/*
+ * Index of the neighbor cache by IP address. Each bucket is a chain of
+ * neighbor table slots, linked through hash_next[]. A slot is in the
+ * index from uip_ds6_nbr_add() until uip_ds6_nbr_rm(), which is also
+ * called by the neighbor table when it evicts an entry. Entries hold
+ * slot + 1, so that the zero-initialized tables are valid even before
+ * uip_ds6_neighbors_init().
+ */
+static nbr_slot_t hash_heads[UIP_DS6_NBR_HASH_SIZE];
+static nbr_slot_t hash_next[NBR_TABLE_MAX_NEIGHBORS];
+
+/*---------------------------------------------------------------------------*/
+static nbr_slot_t *
+hash_bucket(const uip_ipaddr_t *ipaddr)
+{
+  uint8_t i;
+  uint16_t h;
+
+  /* Prefixes are mostly shared, so hash the interface identifier */
+  h = 0;
+  for(i = 8; i < 16; i += 2) {
+    h ^= (ipaddr->u8[i] << 8) | ipaddr->u8[i + 1];
+  }
+  return &hash_heads[h % UIP_DS6_NBR_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_add(uip_ds6_nbr_t *nbr)
+{
+  nbr_slot_t *head;
+  nbr_slot_t slot;
+
+  head = hash_bucket(&nbr->ipaddr);
+  slot = slot_from_nbr(nbr);
+  hash_next[slot] = *head;
+  *head = slot + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(uip_ds6_nbr_t *nbr)
+{
+  nbr_slot_t *link;
+  nbr_slot_t slot;
+
+  slot = slot_from_nbr(nbr);
+  for(link = hash_bucket(&nbr->ipaddr);
+      *link != 0;
+      link = &hash_next[*link - 1]) {
+    if(*link == slot + 1) {
+      *link = hash_next[slot];
+      return;
+    }
+  }
+}
+#endif /* UIP_DS6_NBR_HASH_SIZE */
+/*---------------------------------------------------------------------------*/
+static void
+sched_remove(nbr_slot_t slot)
+{
+  nbr_slot_t *link;
+
+  for(link = &sched_head; *link != SLOT_NONE; link = &sched_next[*link]) {
+    if(*link == slot) {
+      *link = sched_next[slot];
+      return;
+    }
+  }
+  for(link = &sched_deferred; *link != SLOT_NONE; link = &sched_next[*link]) {
+    if(*link == slot) {
+      *link = sched_next[slot];
+      if(sched_deferred_tail == &sched_next[slot]) {
+        sched_deferred_tail = link;
+      }
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+sched_insert(nbr_slot_t slot, unsigned long deadline)
+{
+  nbr_slot_t *link;
+
+  /* Equal deadlines are kept in insertion order */
+  for(link = &sched_head;
+      *link != SLOT_NONE && (long)(sched_deadline[*link] - deadline) <= 0;
+      link = &sched_next[*link]);
+  sched_deadline[slot] = deadline;
+  sched_next[slot] = *link;
+  *link = slot;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+stimer_deadline(const struct stimer *t)
+{
+  return t->start + t->interval;
+}
+/*---------------------------------------------------------------------------*/
+/* Gets the time of the next state change of nbr. Returns 0 if none. */
+static int
+get_deadline(const uip_ds6_nbr_t *nbr, unsigned long *deadline)
+{
+  switch(nbr->state) {
+  case NBR_REACHABLE:
+    *deadline = stimer_deadline(&nbr->reachable);
+    return 1;
+#if UIP_ND6_SEND_NA
+  case NBR_DELAY:
+    *deadline = stimer_deadline(&nbr->reachable);
+    return 1;
+  case NBR_INCOMPLETE:
+    *deadline = nbr->nscount >= UIP_ND6_MAX_MULTICAST_SOLICIT ?
+      clock_seconds() : stimer_deadline(&nbr->sendns);
+    return 1;
+  case NBR_PROBE:
+    *deadline = nbr->nscount >= UIP_ND6_MAX_UNICAST_SOLICIT ?
+      clock_seconds() : stimer_deadline(&nbr->sendns);
+    return 1;
+#endif /* UIP_ND6_SEND_NA */
+  default:
+    return 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_ds6_nbr_reschedule(uip_ds6_nbr_t *nbr)
+{
+  unsigned long deadline;
+  nbr_slot_t slot;
+
+  if(nbr == NULL) {
+    return;
+  }
+  slot = slot_from_nbr(nbr);
+  sched_remove(slot);
+  if(get_deadline(nbr, &deadline)) {
+    sched_insert(slot, deadline);
+  }
+}
 /*---------------------------------------------------------------------------*/
 void
 uip_ds6_neighbors_init(void)
 {
+#if UIP_DS6_NBR_HASH_SIZE
+  memset(hash_heads, 0, sizeof(hash_heads));
+#endif /* UIP_DS6_NBR_HASH_SIZE */
   nbr_table_register(ds6_neighbors, (nbr_table_callback *)uip_ds6_nbr_rm);
 }
 /*---------------------------------------------------------------------------*/
@@ -81,9 +259,23 @@ uip_ds6_nbr_t *
 uip_ds6_nbr_add(const uip_ipaddr_t *ipaddr, const uip_lladdr_t *lladdr,
                 uint8_t isrouter, uint8_t state)
 {
-  uip_ds6_nbr_t *nbr = nbr_table_add_lladdr(ds6_neighbors, (linkaddr_t*)lladdr);
+  uip_ds6_nbr_t *nbr;
+
+  /* Adding an existing link-layer address reuses its entry */
+  nbr = nbr_table_get_from_lladdr(ds6_neighbors, (linkaddr_t*)lladdr);
+  if(nbr != NULL) {
+#if UIP_DS6_NBR_HASH_SIZE
+    hash_remove(nbr);
+#endif /* UIP_DS6_NBR_HASH_SIZE */
+    sched_remove(slot_from_nbr(nbr));
+  }
+
+  nbr = nbr_table_add_lladdr(ds6_neighbors, (linkaddr_t*)lladdr);
   if(nbr) {
     uip_ipaddr_copy(&nbr->ipaddr, ipaddr);
+#if UIP_DS6_NBR_HASH_SIZE
+    hash_add(nbr);
+#endif /* UIP_DS6_NBR_HASH_SIZE */
     nbr->isrouter = isrouter;
     nbr->state = state;
   #if UIP_CONF_IPV6_QUEUE_PKT
@@ -98,6 +290,7 @@ uip_ds6_nbr_add(const uip_ipaddr_t *ipaddr, const uip_lladdr_t *lladdr,
     PRINTF(" link addr ");
     PRINTLLADDR(lladdr);
     PRINTF(" state %u\n", state);
+    uip_ds6_nbr_reschedule(nbr);
     NEIGHBOR_STATE_CHANGED(nbr);
     return nbr;
   } else {
@@ -119,6 +312,10 @@ uip_ds6_nbr_rm(uip_ds6_nbr_t *nbr)
     uip_packetqueue_free(&nbr->packethandle);
 #endif /* UIP_CONF_IPV6_QUEUE_PKT */
     NEIGHBOR_STATE_CHANGED(nbr);
+#if UIP_DS6_NBR_HASH_SIZE
+    hash_remove(nbr);
+#endif /* UIP_DS6_NBR_HASH_SIZE */
+    sched_remove(slot_from_nbr(nbr));
     nbr_table_remove(ds6_neighbors, nbr);
   }
   return;
@@ -156,6 +353,18 @@ uip_ds6_nbr_num(void)
 uip_ds6_nbr_t *
 uip_ds6_nbr_lookup(const uip_ipaddr_t *ipaddr)
 {
+#if UIP_DS6_NBR_HASH_SIZE
+  nbr_slot_t slot;
+
+  if(ipaddr != NULL) {
+    for(slot = *hash_bucket(ipaddr); slot != 0; slot = hash_next[slot - 1]) {
+      if(uip_ipaddr_cmp(&_ds6_neighbors_mem[slot - 1].ipaddr, ipaddr)) {
+        return &_ds6_neighbors_mem[slot - 1];
+      }
+    }
+  }
+  return NULL;
+#else /* UIP_DS6_NBR_HASH_SIZE */
   uip_ds6_nbr_t *nbr = nbr_table_head(ds6_neighbors);
   if(ipaddr != NULL) {
     while(nbr != NULL) {
@@ -166,6 +375,7 @@ uip_ds6_nbr_lookup(const uip_ipaddr_t *ipaddr)
     }
   }
   return NULL;
+#endif /* UIP_DS6_NBR_HASH_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 uip_ds6_nbr_t *
@@ -220,8 +430,13 @@ uip_ds6_link_neighbor_callback(int status, int numtx)
     uip_ds6_nbr_t *nbr;
     nbr = uip_ds6_nbr_ll_lookup((uip_lladdr_t *)dest);
     if(nbr != NULL && nbr->state != NBR_INCOMPLETE) {
+      uint8_t was_stale = nbr->state == NBR_STALE;
       nbr->state = NBR_REACHABLE;
       stimer_set(&nbr->reachable, UIP_ND6_REACHABLE_TIME / 1000);
+      /* Other states are already scheduled no later than this */
+      if(was_stale) {
+        uip_ds6_nbr_reschedule(nbr);
+      }
       PRINTF("uip-ds6-neighbor : received a link layer ACK : ");
       PRINTLLADDR((uip_lladdr_t *)dest);
       PRINTF(" is reachable.\n");
@@ -231,85 +446,139 @@ uip_ds6_link_neighbor_callback(int status, int numtx)
 
 }
 /*---------------------------------------------------------------------------*/
-/** Periodic processing on neighbors */
-void
-uip_ds6_neighbor_periodic(void)
+/*
+ * Handles the expired timers of nbr. An NS is only sent if *ns_budget
+ * allows it. Returns 0 if nbr was removed.
+ */
+static int
+nbr_timeout(uip_ds6_nbr_t *nbr, uint8_t *ns_budget)
 {
-  uip_ds6_nbr_t *nbr = nbr_table_head(ds6_neighbors);
-  while(nbr != NULL) {
-    switch(nbr->state) {
-    case NBR_REACHABLE:
-      if(stimer_expired(&nbr->reachable)) {
+  switch(nbr->state) {
+  case NBR_REACHABLE:
+    if(stimer_expired(&nbr->reachable)) {
 #if UIP_CONF_IPV6_RPL
-        /* when a neighbor leave it's REACHABLE state and is a default router,
-           instead of going to STALE state it enters DELAY state in order to
-           force a NUD on it. Otherwise, if there is no upward traffic, the
-           node never knows if the default router is still reachable. This
-           mimics the 6LoWPAN-ND behavior.
-         */
-        if(uip_ds6_defrt_lookup(&nbr->ipaddr) != NULL) {
-          PRINTF("REACHABLE: defrt moving to DELAY (");
-          PRINT6ADDR(&nbr->ipaddr);
-          PRINTF(")\n");
-          nbr->state = NBR_DELAY;
-          stimer_set(&nbr->reachable, UIP_ND6_DELAY_FIRST_PROBE_TIME);
-          nbr->nscount = 0;
-        } else {
-          PRINTF("REACHABLE: moving to STALE (");
-          PRINT6ADDR(&nbr->ipaddr);
-          PRINTF(")\n");
-          nbr->state = NBR_STALE;
-        }
-#else /* UIP_CONF_IPV6_RPL */
+      /* when a neighbor leave it's REACHABLE state and is a default router,
+         instead of going to STALE state it enters DELAY state in order to
+         force a NUD on it. Otherwise, if there is no upward traffic, the
+         node never knows if the default router is still reachable. This
+         mimics the 6LoWPAN-ND behavior.
+       */
+      if(uip_ds6_defrt_lookup(&nbr->ipaddr) != NULL) {
+        PRINTF("REACHABLE: defrt moving to DELAY (");
+        PRINT6ADDR(&nbr->ipaddr);
+        PRINTF(")\n");
+        nbr->state = NBR_DELAY;
+        stimer_set(&nbr->reachable, UIP_ND6_DELAY_FIRST_PROBE_TIME);
+        nbr->nscount = 0;
+      } else {
         PRINTF("REACHABLE: moving to STALE (");
         PRINT6ADDR(&nbr->ipaddr);
         PRINTF(")\n");
         nbr->state = NBR_STALE;
-#endif /* UIP_CONF_IPV6_RPL */
       }
-      break;
+#else /* UIP_CONF_IPV6_RPL */
+      PRINTF("REACHABLE: moving to STALE (");
+      PRINT6ADDR(&nbr->ipaddr);
+      PRINTF(")\n");
+      nbr->state = NBR_STALE;
+#endif /* UIP_CONF_IPV6_RPL */
+    }
+    break;
 #if UIP_ND6_SEND_NA
-    case NBR_INCOMPLETE:
-      if(nbr->nscount >= UIP_ND6_MAX_MULTICAST_SOLICIT) {
-        uip_ds6_nbr_rm(nbr);
-      } else if(stimer_expired(&nbr->sendns) && (uip_len == 0)) {
-        nbr->nscount++;
-        PRINTF("NBR_INCOMPLETE: NS %u\n", nbr->nscount);
-        uip_nd6_ns_output(NULL, NULL, &nbr->ipaddr);
-        stimer_set(&nbr->sendns, uip_ds6_if.retrans_timer / 1000);
-      }
-      break;
-    case NBR_DELAY:
-      if(stimer_expired(&nbr->reachable)) {
-        nbr->state = NBR_PROBE;
-        nbr->nscount = 0;
-        PRINTF("DELAY: moving to PROBE\n");
-        stimer_set(&nbr->sendns, 0);
-      }
-      break;
-    case NBR_PROBE:
-      if(nbr->nscount >= UIP_ND6_MAX_UNICAST_SOLICIT) {
-        uip_ds6_defrt_t *locdefrt;
-        PRINTF("PROBE END\n");
-        if((locdefrt = uip_ds6_defrt_lookup(&nbr->ipaddr)) != NULL) {
-          if (!locdefrt->isinfinite) {
-            uip_ds6_defrt_rm(locdefrt);
-          }
+  case NBR_INCOMPLETE:
+    if(nbr->nscount >= UIP_ND6_MAX_MULTICAST_SOLICIT) {
+      uip_ds6_nbr_rm(nbr);
+      return 0;
+    } else if(stimer_expired(&nbr->sendns) && (uip_len == 0) && *ns_budget > 0) {
+      (*ns_budget)--;
+      nbr->nscount++;
+      PRINTF("NBR_INCOMPLETE: NS %u\n", nbr->nscount);
+      uip_nd6_ns_output(NULL, NULL, &nbr->ipaddr);
+      stimer_set(&nbr->sendns, uip_ds6_if.retrans_timer / 1000);
+    }
+    break;
+  case NBR_DELAY:
+    if(stimer_expired(&nbr->reachable)) {
+      nbr->state = NBR_PROBE;
+      nbr->nscount = 0;
+      PRINTF("DELAY: moving to PROBE\n");
+      stimer_set(&nbr->sendns, 0);
+    }
+    break;
+  case NBR_PROBE:
+    if(nbr->nscount >= UIP_ND6_MAX_UNICAST_SOLICIT) {
+      uip_ds6_defrt_t *locdefrt;
+      PRINTF("PROBE END\n");
+      if((locdefrt = uip_ds6_defrt_lookup(&nbr->ipaddr)) != NULL) {
+        if (!locdefrt->isinfinite) {
+          uip_ds6_defrt_rm(locdefrt);
         }
-        uip_ds6_nbr_rm(nbr);
-      } else if(stimer_expired(&nbr->sendns) && (uip_len == 0)) {
-        nbr->nscount++;
-        PRINTF("PROBE: NS %u\n", nbr->nscount);
-        uip_nd6_ns_output(NULL, &nbr->ipaddr, &nbr->ipaddr);
-        stimer_set(&nbr->sendns, uip_ds6_if.retrans_timer / 1000);
       }
-      break;
+      uip_ds6_nbr_rm(nbr);
+      return 0;
+    } else if(stimer_expired(&nbr->sendns) && (uip_len == 0) && *ns_budget > 0) {
+      (*ns_budget)--;
+      nbr->nscount++;
+      PRINTF("PROBE: NS %u\n", nbr->nscount);
+      uip_nd6_ns_output(NULL, &nbr->ipaddr, &nbr->ipaddr);
+      stimer_set(&nbr->sendns, uip_ds6_if.retrans_timer / 1000);
+    }
+    break;
 #endif /* UIP_ND6_SEND_NA */
-    default:
-      break;
+  default:
+    break;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/** Periodic processing on neighbors */
+void
+uip_ds6_neighbor_periodic(void)
+{
+  unsigned long now;
+  unsigned long deadline;
+  nbr_slot_t slot;
+  uip_ds6_nbr_t *nbr;
+  uint8_t ns_budget;
+
+  now = clock_seconds();
+  ns_budget = UIP_DS6_NBR_NS_PER_PERIOD;
+
+  while(sched_head != SLOT_NONE
+        && (long)(sched_deadline[sched_head] - now) <= 0) {
+    slot = sched_head;
+    sched_head = sched_next[slot];
+    nbr = &_ds6_neighbors_mem[slot];
+
+    if(!nbr_timeout(nbr, &ns_budget)) {
+      continue;
+    }
+    /* Sending an NS may have evicted nbr from the neighbor table */
+    if(nbr_table_get_from_lladdr(ds6_neighbors,
+                                 nbr_table_get_lladdr(ds6_neighbors, nbr)) != nbr) {
+      continue;
+    }
+    /* It may also have rescheduled nbr already */
+    sched_remove(slot);
+
+    if(get_deadline(nbr, &deadline)) {
+      if((long)(deadline - now) <= 0) {
+        /* Still due: its NS waits for the budget or for uip_buf */
+        sched_deadline[slot] = now;
+        sched_next[slot] = SLOT_NONE;
+        *sched_deferred_tail = slot;
+        sched_deferred_tail = &sched_next[slot];
+      } else {
+        sched_insert(slot, deadline);
+      }
     }
-    nbr = nbr_table_next(ds6_neighbors, nbr);
   }
+
+  /* The deferred neighbors go first in the next period, in order */
+  *sched_deferred_tail = sched_head;
+  sched_head = sched_deferred;
+  sched_deferred = SLOT_NONE;
+  sched_deferred_tail = &sched_deferred;
 }
 /*---------------------------------------------------------------------------*/
 uip_ds6_nbr_t *
@@ -64,6 +64,22 @@
 #define  NBR_DELAY 3
 #define  NBR_PROBE 4
 
+/** \brief Number of buckets of the IP address index of the nbr cache,
+    0 to search the table linearly */
+#ifndef UIP_CONF_DS6_NBR_HASH_SIZE
+#define UIP_DS6_NBR_HASH_SIZE NBR_TABLE_MAX_NEIGHBORS
+#else
+#define UIP_DS6_NBR_HASH_SIZE UIP_CONF_DS6_NBR_HASH_SIZE
+#endif
+
+/** \brief Maximum number of NS sent by the periodic neighbor processing
+    per UIP_DS6_PERIOD. Further probes are deferred in order. */
+#ifndef UIP_CONF_DS6_NBR_NS_PER_PERIOD
+#define UIP_DS6_NBR_NS_PER_PERIOD 1
+#else
+#define UIP_DS6_NBR_NS_PER_PERIOD UIP_CONF_DS6_NBR_NS_PER_PERIOD
+#endif
+
 NBR_TABLE_DECLARE(ds6_neighbors);
 
 /** \brief An entry in the nbr cache */
@@ -94,6 +110,15 @@ uip_ds6_nbr_t *uip_ds6_nbr_ll_lookup(const uip_lladdr_t *lladdr);
 uip_ipaddr_t *uip_ds6_nbr_ipaddr_from_lladdr(const uip_lladdr_t *lladdr);
 const uip_lladdr_t *uip_ds6_nbr_lladdr_from_ipaddr(const uip_ipaddr_t *ipaddr);
 void uip_ds6_link_neighbor_callback(int status, int numtx);
+
+/**
+ * \brief
+ *    Updates the deadline of a neighbor in the periodic processing.
+ *    Must be called after changing the state or timers of a neighbor
+ *    such that its next timeout is earlier than before, e.g. when
+ *    leaving NBR_STALE. Later timeouts need no update.
+ */
+void uip_ds6_nbr_reschedule(uip_ds6_nbr_t *nbr);
 void uip_ds6_neighbor_periodic(void);
 int uip_ds6_nbr_num(void);
 
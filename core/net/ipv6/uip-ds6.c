@@ -54,6 +54,7 @@
 #include "net/ip/uip-debug.h"
 
 struct etimer uip_ds6_timer_periodic;                           /**< Timer for maintenance of data structures */
+static unsigned long last_lifetime_check;                       /**< Second of the last lifetime check */
 
 #if UIP_CONF_ROUTER
 struct stimer uip_ds6_timer_ra;                                 /**< RA timer, to schedule RA sending */
@@ -164,27 +165,25 @@ uip_ds6_periodic(void)
     }
   }
 
-  /* Periodic processing on default routers */
-  uip_ds6_defrt_periodic();
-  /*  for(locdefrt = uip_ds6_defrt_list;
-      locdefrt < uip_ds6_defrt_list + UIP_DS6_DEFRT_NB; locdefrt++) {
-    if((locdefrt->isused) && (!locdefrt->isinfinite) &&
-       (stimer_expired(&(locdefrt->lifetime)))) {
-      uip_ds6_defrt_rm(locdefrt);
-    }
-    }*/
+  /* Router and prefix lifetimes count in seconds */
+  if(clock_seconds() != last_lifetime_check) {
+    last_lifetime_check = clock_seconds();
+
+    /* Periodic processing on default routers */
+    uip_ds6_defrt_periodic();
 
 #if !UIP_CONF_ROUTER
-  /* Periodic processing on prefixes */
-  for(locprefix = uip_ds6_prefix_list;
-      locprefix < uip_ds6_prefix_list + UIP_DS6_PREFIX_NB;
-      locprefix++) {
-    if(locprefix->isused && !locprefix->isinfinite
-       && stimer_expired(&(locprefix->vlifetime))) {
-      uip_ds6_prefix_rm(locprefix);
+    /* Periodic processing on prefixes */
+    for(locprefix = uip_ds6_prefix_list;
+        locprefix < uip_ds6_prefix_list + UIP_DS6_PREFIX_NB;
+        locprefix++) {
+      if(locprefix->isused && !locprefix->isinfinite
+         && stimer_expired(&(locprefix->vlifetime))) {
+        uip_ds6_prefix_rm(locprefix);
+      }
     }
-  }
 #endif /* !UIP_CONF_ROUTER */
+  }
 
   uip_ds6_neighbor_periodic();
 
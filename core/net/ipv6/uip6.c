@@ -78,6 +78,7 @@
 #include "net/ipv6/uip-nd6.h"
 #include "net/ipv6/uip-ds6.h"
 #include "net/ipv6/multicast/uip-mcast6.h"
+#include "net/ip/uip-chksum.h"
 
 #include <string.h>
 
@@ -174,9 +175,9 @@ uint8_t uip_ext_opt_offset = 0;
  * @{
  */
 /** Packet buffer for incoming and outgoing packets */
-#ifndef UIP_CONF_EXTERNAL_BUFFER
+#if !defined(UIP_CONF_EXTERNAL_BUFFER) && !UIP_BUFFER_POOL_SIZE
 uip_buf_t uip_aligned_buf;
-#endif /* UIP_CONF_EXTERNAL_BUFFER */
+#endif /* !UIP_CONF_EXTERNAL_BUFFER && !UIP_BUFFER_POOL_SIZE */
 
 /* The uip_appdata pointer points to application data. */
 void *uip_appdata;
@@ -326,6 +327,9 @@ uip_add32(uint8_t *op32, uint16_t op16)
 static uint16_t
 chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 {
+#if UIP_WORD_CHKSUM
+  return uip_chksum_words(sum, data, len);
+#else /* UIP_WORD_CHKSUM */
   uint16_t t;
   const uint8_t *dataptr;
   const uint8_t *last_byte;
@@ -352,6 +356,7 @@ chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 
   /* Return sum in host byte order. */
   return sum;
+#endif /* UIP_WORD_CHKSUM */
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -53,6 +53,7 @@
 #include "net/nbr-table.h"
 #include "net/linkaddr.h"
 #include "lib/ccm-star.h"
+#include "lib/aes-128.h"
 #include <string.h>
 
 #define WITH_ENCRYPTION (LLSEC802154_SECURITY_LEVEL & (1 << 2))
@@ -78,6 +79,8 @@
 
 /* network-wide CCM* key */
 static uint8_t key[16] = NONCORESEC_KEY;
+/* handle of the key in the AES-128 key cache, or -1 */
+static int key_handle;
 NBR_TABLE(struct anti_replay_info, anti_replay_table);
 
 /*---------------------------------------------------------------------------*/
@@ -110,6 +113,9 @@ aead(uint8_t hdrlen, int forward)
   mic = a + totlen;
   result = forward ? mic : generated_mic;
   
+  if(key_handle >= 0) {
+    ccm_star_use_key(key_handle);
+  }
   CCM_STAR.aead(nonce,
       m, m_len,
       a, a_len,
@@ -239,7 +245,10 @@ length(void)
 static void
 init(void)
 {
-  CCM_STAR.set_key(key);
+  key_handle = aes_128_add_key(key);
+  if(key_handle < 0) {
+    CCM_STAR.set_key(key);
+  }
   nbr_table_register(anti_replay_table, NULL);
 }
 /*---------------------------------------------------------------------------*/
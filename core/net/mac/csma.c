@@ -108,6 +108,14 @@ struct neighbor_queue {
 #define CSMA_MAX_NEIGHBOR_QUEUES 2
 #endif /* CSMA_CONF_MAX_NEIGHBOR_QUEUES */
 
+/* The number of hash buckets for the neighbor queues. 0 keeps all
+   queues in a single list. */
+#ifdef CSMA_CONF_NEIGHBOR_QUEUE_HASH_SIZE
+#define CSMA_NEIGHBOR_QUEUE_HASH_SIZE CSMA_CONF_NEIGHBOR_QUEUE_HASH_SIZE
+#else
+#define CSMA_NEIGHBOR_QUEUE_HASH_SIZE 0
+#endif /* CSMA_CONF_NEIGHBOR_QUEUE_HASH_SIZE */
+
 /* The maximum number of pending packet per neighbor */
 #ifdef CSMA_CONF_MAX_PACKET_PER_NEIGHBOR
 #define CSMA_MAX_PACKET_PER_NEIGHBOR CSMA_CONF_MAX_PACKET_PER_NEIGHBOR
@@ -119,16 +127,43 @@ struct neighbor_queue {
 MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
 MEMB(packet_memb, struct rdc_buf_list, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
+
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE
+/* Each bucket is a list of neighbor queues */
+static void *neighbor_buckets[CSMA_NEIGHBOR_QUEUE_HASH_SIZE];
+#else /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
 LIST(neighbor_list);
+#endif /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
+
+/* The neighbor whose queue is being sent by NETSTACK_RDC.send_list() */
+static struct neighbor_queue *burst_neighbor;
+/* Set when packet_sent() reported a completed transmission of the burst */
+static uint8_t burst_reported;
 
 static void packet_sent(void *ptr, int status, int num_transmissions);
 static void transmit_packet_list(void *ptr);
 
+/*---------------------------------------------------------------------------*/
+static list_t
+neighbor_list_for(const linkaddr_t *addr)
+{
+#if CSMA_NEIGHBOR_QUEUE_HASH_SIZE
+  uint8_t h = 0;
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h ^= addr->u8[i];
+  }
+  return (list_t)&neighbor_buckets[h % CSMA_NEIGHBOR_QUEUE_HASH_SIZE];
+#else /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
+  return neighbor_list;
+#endif /* CSMA_NEIGHBOR_QUEUE_HASH_SIZE */
+}
 /*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
-  struct neighbor_queue *n = list_head(neighbor_list);
+  struct neighbor_queue *n = list_head(neighbor_list_for(addr));
   while(n != NULL) {
     if(linkaddr_cmp(&n->addr, addr)) {
       return n;
@@ -164,8 +199,22 @@ transmit_packet_list(void *ptr)
     if(q != NULL) {
       PRINTF("csma: preparing number %d %p, queue len %d\n", n->transmissions, q,
           list_length(n->queued_packet_list));
-      /* Send packets in the neighbor's list */
+      /* Send packets in the neighbor's list. The RDC goes on with
+         the next packet by itself as long as the burst succeeds. */
+      burst_neighbor = n;
+      burst_reported = 0;
       NETSTACK_RDC.send_list(packet_sent, n, q);
+      if(burst_neighbor == n) {
+        burst_neighbor = NULL;
+        /* The burst stopped early without setting a retransmission.
+           If nothing was reported, the RDC deferred the packet and
+           will send the list itself later: do not send it again. */
+        if(burst_reported &&
+           list_head(n->queued_packet_list) != NULL &&
+           ctimer_expired(&n->transmit_timer)) {
+          ctimer_set(&n->transmit_timer, 0, transmit_packet_list, n);
+        }
+      }
     }
   }
 }
@@ -189,13 +238,19 @@ free_packet(struct neighbor_queue *n, struct rdc_buf_list *p, int status)
       n->transmissions = 0;
       n->collisions = 0;
       n->deferrals = 0;
-      /* Set a timer for next transmissions */
-      tx_delay = (status == MAC_TX_OK) ? 0 : default_timebase();
-      ctimer_set(&n->transmit_timer, tx_delay, transmit_packet_list, n);
+      /* Set a timer for next transmissions, unless the next packet
+         is already on its way in the current burst */
+      if(status != MAC_TX_OK || n != burst_neighbor) {
+        tx_delay = (status == MAC_TX_OK) ? 0 : default_timebase();
+        ctimer_set(&n->transmit_timer, tx_delay, transmit_packet_list, n);
+      }
     } else {
       /* This was the last packet in the queue, we free the neighbor */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
+      if(n == burst_neighbor) {
+        burst_neighbor = NULL;
+      }
+      list_remove(neighbor_list_for(&n->addr), n);
       memb_free(&neighbor_memb, n);
     }
   }
@@ -218,6 +273,9 @@ packet_sent(void *ptr, int status, int num_transmissions)
   if(n == NULL) {
     return;
   }
+  if(n == burst_neighbor && status != MAC_TX_DEFERRED) {
+    burst_reported = 1;
+  }
   switch(status) {
   case MAC_TX_OK:
   case MAC_TX_NOACK:
@@ -351,7 +409,7 @@ send_packet(mac_callback_t sent, void *ptr)
       /* Init packet list for this neighbor */
       LIST_STRUCT_INIT(n, queued_packet_list);
       /* Add neighbor to the list */
-      list_add(neighbor_list, n);
+      list_add(neighbor_list_for(addr), n);
     }
   }
 
@@ -401,7 +459,7 @@ send_packet(mac_callback_t sent, void *ptr)
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->queued_packet_list) == 0) {
-        list_remove(neighbor_list, n);
+        list_remove(neighbor_list_for(addr), n);
         memb_free(&neighbor_memb, n);
       }
     } else {
@@ -60,9 +60,13 @@ enum ieee802154e_header_ie_id {
 enum ieee802154e_payload_ie_id {
   PAYLOAD_IE_ESDU = 0,
   PAYLOAD_IE_MLME,
+  PAYLOAD_IE_IETF = 0x5,
   PAYLOAD_IE_LIST_TERMINATION = 0xf,
 };
 
+/* c.f. RFC 8480, IETF IE sub-ID of 6top */
+#define IETF_IE_SIXTOP 0xc9
+
 /* c.f. IEEE 802.15.4e Table 4d */
 enum ieee802154e_mlme_short_subie_id {
   MLME_SHORT_IE_TSCH_SYNCHRONIZATION = 0x1a,
@@ -74,6 +78,10 @@ enum ieee802154e_mlme_short_subie_id {
   MLME_SHORT_IE_TSCH_MAC_METRICS_2,
 };
 
+/* Not in IEEE 802.15.4e: sub-ID of the TSCH hopping sequence switch IE,
+ * taken below the range of the standard TSCH sub-IEs */
+#define MLME_SHORT_IE_TSCH_HOPPING_SWITCH 0x19
+
 /* c.f. IEEE 802.15.4e Table 4e */
 enum ieee802154e_mlme_long_subie_id {
   MLME_LONG_IE_TSCH_CHANNEL_HOPPING_SEQUENCE = 0x9,
@@ -317,6 +325,53 @@ frame80215e_create_ie_tsch_channel_hopping_sequence(uint8_t *buf, int len,
   }
 }
 
+/* MLME sub-IE. TSCH hopping sequence switch. Used in EBs: upcoming hopping sequence */
+int
+frame80215e_create_ie_tsch_hopping_switch(uint8_t *buf, int len,
+    struct ieee802154_ies *ies)
+{
+  int ie_len;
+  if(ies == NULL || ies->ie_hopping_switch_len > sizeof(ies->ie_hopping_switch_list)) {
+    return -1;
+  }
+  if(ies->ie_hopping_switch_len == 0) {
+    return 0;
+  }
+  ie_len = 5 + ies->ie_hopping_switch_len;
+  if(len >= 2 + ie_len) {
+    buf[2] = ies->ie_hopping_switch_asn.ls4b;
+    buf[3] = ies->ie_hopping_switch_asn.ls4b >> 8;
+    buf[4] = ies->ie_hopping_switch_asn.ls4b >> 16;
+    buf[5] = ies->ie_hopping_switch_asn.ls4b >> 24;
+    buf[6] = ies->ie_hopping_switch_asn.ms1b;
+    memcpy(buf + 7, ies->ie_hopping_switch_list, ies->ie_hopping_switch_len);
+    create_mlme_short_ie_descriptor(buf, MLME_SHORT_IE_TSCH_HOPPING_SWITCH, ie_len);
+    return 2 + ie_len;
+  } else {
+    return -1;
+  }
+}
+
+/* Payload IE. IETF, 6top sub-IE. Used in 6P messages */
+int
+frame80215e_create_ie_sixtop(uint8_t *buf, int len,
+    struct ieee802154_ies *ies)
+{
+  int ie_len;
+  if(ies == NULL || ies->ie_sixtop == NULL) {
+    return -1;
+  }
+  ie_len = 1 + ies->ie_sixtop_len;
+  if(len >= 2 + ie_len) {
+    buf[2] = IETF_IE_SIXTOP;
+    memcpy(buf + 3, ies->ie_sixtop, ies->ie_sixtop_len);
+    create_payload_ie_descriptor(buf, PAYLOAD_IE_IETF, ie_len);
+    return 2 + ie_len;
+  } else {
+    return -1;
+  }
+}
+
 /* Parse a header IE */
 static int
 frame802154e_parse_header_ie(const uint8_t *buf, int len,
@@ -397,6 +452,20 @@ frame802154e_parse_mlme_short_ie(const uint8_t *buf, int len,
         return len;
       }
       break;
+    case MLME_SHORT_IE_TSCH_HOPPING_SWITCH:
+      if(len > 5 && len - 5 <= sizeof(ies->ie_hopping_switch_list)) {
+        if(ies != NULL) {
+          ies->ie_hopping_switch_asn.ls4b = (uint32_t)buf[0];
+          ies->ie_hopping_switch_asn.ls4b |= (uint32_t)buf[1] << 8;
+          ies->ie_hopping_switch_asn.ls4b |= (uint32_t)buf[2] << 16;
+          ies->ie_hopping_switch_asn.ls4b |= (uint32_t)buf[3] << 24;
+          ies->ie_hopping_switch_asn.ms1b = (uint8_t)buf[4];
+          ies->ie_hopping_switch_len = len - 5;
+          memcpy(ies->ie_hopping_switch_list, buf + 5, len - 5);
+        }
+        return len;
+      }
+      break;
     case MLME_SHORT_IE_TSCH_TIMESLOT:
       if(len == 1 || len == 25) {
         if(ies != NULL) {
@@ -529,6 +598,17 @@ frame802154e_parse_information_elements(const uint8_t *buf, uint8_t buf_size,
             len = 0; /* Reset len as we want to read subIEs and not jump over them */
             PRINTF("frame802154e: entering MLME ie with len %u\n", nested_mlme_len);
             break;
+          case PAYLOAD_IE_IETF:
+            if(len > buf_size) {
+              return -1;
+            }
+            /* Other IETF sub-IEs are skipped */
+            if(len >= 1 && buf[0] == IETF_IE_SIXTOP) {
+              ies->ie_sixtop = buf + 1;
+              ies->ie_sixtop_len = len - 1;
+              PRINTF("frame802154e: 6top ie len %u\n", len - 1);
+            }
+            break;
           case PAYLOAD_IE_LIST_TERMINATION:
             PRINTF("frame802154e: payload ie list termination %u\n", len);
             return (len == 0) ? buf + len - start : -1;
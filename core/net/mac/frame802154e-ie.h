@@ -80,6 +80,15 @@ struct ieee802154_ies {
   /* We include and parse only the sequence len and list and omit unused fields */
   uint16_t ie_hopping_sequence_len;
   uint8_t ie_hopping_sequence_list[TSCH_HOPPING_SEQUENCE_MAX_LEN];
+  /* Hopping sequence switch: the sequence to use from ASN ie_hopping_switch_asn on.
+   * Not part of IEEE 802.15.4e, used by TSCH adaptive hopping. Len 0: no switch */
+  struct asn_t ie_hopping_switch_asn;
+  uint8_t ie_hopping_switch_len;
+  uint8_t ie_hopping_switch_list[TSCH_HOPPING_SEQUENCE_MAX_LEN];
+  /* Payload IETF IE, 6top sub-IE: the 6P message, not copied but pointing
+   * into the parsed buffer. NULL if absent */
+  const uint8_t *ie_sixtop;
+  uint16_t ie_sixtop_len;
 };
 
 /** Insert various Information Elements **/
@@ -112,6 +121,14 @@ int frame80215e_create_ie_tsch_timeslot(uint8_t *buf, int len,
 /* MLME sub-IE. TSCH channel hopping sequence. Used in EBs: hopping sequence */
 int frame80215e_create_ie_tsch_channel_hopping_sequence(uint8_t *buf, int len,
     struct ieee802154_ies *ies);
+/* MLME sub-IE. TSCH hopping sequence switch. Used in EBs: upcoming hopping sequence.
+ * Writes nothing if no switch is set */
+int frame80215e_create_ie_tsch_hopping_switch(uint8_t *buf, int len,
+    struct ieee802154_ies *ies);
+
+/* Payload IE. IETF, 6top sub-IE. Used in 6P messages */
+int frame80215e_create_ie_sixtop(uint8_t *buf, int len,
+    struct ieee802154_ies *ies);
 
 /* Parse all Information Elements of a frame */
 int frame802154e_parse_information_elements(const uint8_t *buf, uint8_t buf_size,
@@ -94,6 +94,8 @@ create_frame(int type, int do_create)
    * source nor destination address, we have dest PAN ID iff compression is *set*. */
   params.fcf.panid_compression = 0;
   params.fcf.sequence_number_suppression = FRAME802154_SUPPR_SEQNO;
+  /* The payload starts with Information Elements (e.g. 6P messages) */
+  params.fcf.ie_list_present = packetbuf_attr(PACKETBUF_ATTR_MAC_IE_LIST_PRESENT);
 
   /* Insert IEEE 802.15.4 version bits. */
   params.fcf.frame_version = FRAME802154_VERSION;
@@ -229,6 +231,7 @@ parse(void)
     }
     packetbuf_set_addr(PACKETBUF_ADDR_SENDER, (linkaddr_t *)&frame.src_addr);
     packetbuf_set_attr(PACKETBUF_ATTR_PENDING, frame.fcf.frame_pending);
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_IE_LIST_PRESENT, frame.fcf.ie_list_present);
     if(frame.fcf.sequence_number_suppression == 0) {
       packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, frame.seq);
     } else {
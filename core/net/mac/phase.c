@@ -44,21 +44,49 @@
 #include "net/queuebuf.h"
 #include "net/nbr-table.h"
 
+#include <string.h>
+
 #if PHASE_CONF_DRIFT_CORRECT
 #define PHASE_DRIFT_CORRECT PHASE_CONF_DRIFT_CORRECT
 #else
 #define PHASE_DRIFT_CORRECT 0
 #endif
 
+#if PHASE_PERSIST
+#include "cfs/cfs.h"
+#endif /* PHASE_PERSIST */
+
 struct phase {
   rtimer_clock_t time;
 #if PHASE_DRIFT_CORRECT
-  rtimer_clock_t drift;
+  /* The clock_time() at which time was observed */
+  clock_time_t updated;
+  /* Estimated phase drift, in 1/256 rtimer ticks per second */
+  int32_t drift;
 #endif
   uint8_t noacks;
+#if PHASE_PERSIST
+  /* Phase read back from CFS, not yet confirmed by an ACK */
+  uint8_t restored;
+#endif
   struct timer noacks_timer;
 };
 
+#if PHASE_PERSIST
+/* A phase as it is stored in CFS */
+struct phase_record {
+  linkaddr_t neighbor;
+  rtimer_clock_t time;
+  int32_t drift;
+};
+
+#define PHASE_FILENAME        "phase"
+
+#if PHASE_SNAPSHOT_INTERVAL
+static struct ctimer snapshot_timer;
+#endif
+#endif /* PHASE_PERSIST */
+
 struct phase_queueitem {
   struct ctimer timer;
   mac_callback_t mac_callback;
@@ -74,6 +102,18 @@ struct phase_queueitem {
 
 #define MAX_NOACKS_TIME       CLOCK_SECOND * 30
 
+/* The drift is only measured between phases observed at least
+   DRIFT_MIN_TIME apart, to average out the strobe granularity, and at
+   most DRIFT_MAX_TIME apart, so that the drift is less than half a
+   cycle. Corrections are not extrapolated beyond DRIFT_MAX_TIME. */
+#define DRIFT_MIN_TIME        (CLOCK_SECOND * 30)
+#define DRIFT_MAX_TIME        (CLOCK_SECOND * 600)
+
+#if PHASE_DRIFT_CORRECT
+/* The cycle time of the duty cycling protocol, as seen by phase_wait() */
+static rtimer_clock_t phase_cycle_time;
+#endif
+
 MEMB(queued_packets_memb, struct phase_queueitem, PHASE_QUEUESIZE);
 NBR_TABLE(struct phase, nbr_phase);
 
@@ -87,6 +127,85 @@ NBR_TABLE(struct phase, nbr_phase);
 #define PRINTDEBUG(...)
 #endif
 /*---------------------------------------------------------------------------*/
+#if PHASE_DRIFT_CORRECT
+/* Refine the drift estimate of e from a newly observed phase */
+static void
+update_drift(struct phase *e, rtimer_clock_t time)
+{
+  clock_time_t elapsed;
+  int32_t shift;
+  int32_t sample;
+
+  elapsed = clock_time() - e->updated;
+  if(phase_cycle_time == 0 ||
+     elapsed < DRIFT_MIN_TIME || elapsed > DRIFT_MAX_TIME) {
+    return;
+  }
+
+  /* How far the phase has moved since it was last observed, within
+     half a cycle either way */
+  shift = (rtimer_clock_t)(time - e->time) % phase_cycle_time;
+  if(shift > phase_cycle_time / 2) {
+    shift -= phase_cycle_time;
+  }
+  sample = shift * 256 / (int32_t)(elapsed / CLOCK_SECOND);
+
+  if(e->drift == 0) {
+    e->drift = sample;
+  } else {
+    e->drift = (3 * e->drift + sample) / 4;
+  }
+  PRINTF("phase drift %ld (sample %ld)\n", (long)e->drift, (long)sample);
+}
+/*---------------------------------------------------------------------------*/
+/* The expected phase of e now, corrected for its drift */
+static rtimer_clock_t
+corrected_phase(const struct phase *e)
+{
+  clock_time_t elapsed;
+
+  elapsed = clock_time() - e->updated;
+  if(elapsed > DRIFT_MAX_TIME) {
+    elapsed = DRIFT_MAX_TIME;
+  }
+  return e->time + e->drift * (int32_t)(elapsed / CLOCK_SECOND) / 256;
+}
+#endif /* PHASE_DRIFT_CORRECT */
+/*---------------------------------------------------------------------------*/
+#if PHASE_PERSIST && PHASE_PERSISTENT_RTIMER
+/* The guard time for a restored phase. The time spent across the
+   reboot is unknown, so the guard time is doubled. With drift
+   correction, it is also widened by the drift accumulated since the
+   restore, as the estimate comes from before the reboot. */
+static rtimer_clock_t
+restored_guard_time(const struct phase *e, rtimer_clock_t cycle_time,
+                    rtimer_clock_t guard_time)
+{
+  rtimer_clock_t guard;
+#if PHASE_DRIFT_CORRECT
+  clock_time_t elapsed;
+  int32_t widen;
+
+  elapsed = clock_time() - e->updated;
+  if(elapsed > DRIFT_MAX_TIME) {
+    elapsed = DRIFT_MAX_TIME;
+  }
+  widen = (e->drift < 0 ? -e->drift : e->drift) *
+    (int32_t)(elapsed / CLOCK_SECOND) / 256;
+  if(widen > cycle_time / 2) {
+    widen = cycle_time / 2;
+  }
+  guard = 2 * guard_time + widen;
+#else
+  guard = 2 * guard_time;
+#endif
+  if(guard > cycle_time / 2) {
+    guard = cycle_time / 2;
+  }
+  return guard > guard_time ? guard : guard_time;
+}
+#endif /* PHASE_PERSIST && PHASE_PERSISTENT_RTIMER */
+/*---------------------------------------------------------------------------*/
 void
 phase_update(const linkaddr_t *neighbor, rtimer_clock_t time,
              int mac_status)
@@ -98,7 +217,17 @@ phase_update(const linkaddr_t *neighbor, rtimer_clock_t time,
   if(e != NULL) {
     if(mac_status == MAC_TX_OK) {
 #if PHASE_DRIFT_CORRECT
-      e->drift = time-e->time;
+#if PHASE_PERSIST
+      /* A restored phase comes from another time base */
+      if(!e->restored)
+#endif
+      {
+        update_drift(e, time);
+      }
+      e->updated = clock_time();
+#endif
+#if PHASE_PERSIST
+      e->restored = 0;
 #endif
       e->time = time;
     }
@@ -107,6 +236,15 @@ phase_update(const linkaddr_t *neighbor, rtimer_clock_t time,
        before we drop it from the phase list. */
     if(mac_status == MAC_TX_NOACK) {
       PRINTF("phase noacks %d to %d.%d\n", e->noacks, neighbor->u8[0], neighbor->u8[1]);
+#if PHASE_PERSIST && PHASE_PERSISTENT_RTIMER
+      /* A restored phase that misses is most likely stale. Dropping
+         it makes the next transmission strobe for a full cycle. */
+      if(e->restored) {
+        PRINTF("drop restored %d\n", neighbor->u8[0]);
+        nbr_table_remove(nbr_phase, e);
+        return;
+      }
+#endif /* PHASE_PERSIST && PHASE_PERSISTENT_RTIMER */
       e->noacks++;
       if(e->noacks == 1) {
         timer_set(&e->noacks_timer, MAX_NOACKS_TIME);
@@ -126,9 +264,10 @@ phase_update(const linkaddr_t *neighbor, rtimer_clock_t time,
       if(e) {
         e->time = time;
 #if PHASE_DRIFT_CORRECT
-      e->drift = 0;
+        e->updated = clock_time();
+        e->drift = 0;
 #endif
-      e->noacks = 0;
+        e->noacks = 0;
       }
     }
   }
@@ -183,19 +322,19 @@ phase_wait(const linkaddr_t *neighbor, rtimer_clock_t cycle_time,
     
     now = RTIMER_NOW();
 
-    sync = (e == NULL) ? now : e->time;
-
 #if PHASE_DRIFT_CORRECT
-    {
-      int32_t s;
-      if(e->drift > cycle_time) {
-        s = e->drift % cycle_time / (e->drift / cycle_time);  /* drift per cycle */
-        s = s * (now - sync) / cycle_time;                    /* estimated drift to now */
-        sync += s;                                            /* add it in */
-      }
-    }
+    phase_cycle_time = cycle_time;
+    sync = corrected_phase(e);
+#else
+    sync = e->time;
 #endif
 
+#if PHASE_PERSIST && PHASE_PERSISTENT_RTIMER
+    if(e->restored) {
+      guard_time = restored_guard_time(e, cycle_time, guard_time);
+    }
+#endif /* PHASE_PERSIST && PHASE_PERSISTENT_RTIMER */
+
     /* Check if cycle_time is a power of two */
     if(!(cycle_time & (cycle_time - 1))) {
       /* Faster if cycle_time is a power of two */
@@ -238,15 +377,107 @@ phase_wait(const linkaddr_t *neighbor, rtimer_clock_t cycle_time,
       /* Wait until the receiver is expected to be awake */
       while(RTIMER_CLOCK_LT(RTIMER_NOW(), expected));
     }
+#if PHASE_PERSIST && !PHASE_PERSISTENT_RTIMER
+    /* Until a restored phase is confirmed, the caller should strobe
+       as for an unknown phase. Starting at the restored phase still
+       gets an early ACK if it is right. */
+    if(e->restored) {
+      return PHASE_UNKNOWN;
+    }
+#endif /* PHASE_PERSIST && !PHASE_PERSISTENT_RTIMER */
     return PHASE_SEND_NOW;
   }
   return PHASE_UNKNOWN;
 }
 /*---------------------------------------------------------------------------*/
+#if PHASE_PERSIST
+int
+phase_snapshot(void)
+{
+  struct phase *e;
+  struct phase_record r;
+  int fd;
+  int n;
+
+  cfs_remove(PHASE_FILENAME);
+  fd = cfs_open(PHASE_FILENAME, CFS_WRITE);
+  if(fd < 0) {
+    PRINTF("phase: cannot open %s\n", PHASE_FILENAME);
+    return -1;
+  }
+
+  n = 0;
+  for(e = nbr_table_head(nbr_phase); e != NULL;
+      e = nbr_table_next(nbr_phase, e)) {
+    memset(&r, 0, sizeof(r));
+    linkaddr_copy(&r.neighbor, nbr_table_get_lladdr(nbr_phase, e));
+#if PHASE_DRIFT_CORRECT
+    r.time = corrected_phase(e);
+    r.drift = e->drift;
+#else
+    r.time = e->time;
+#endif
+    if(cfs_write(fd, &r, sizeof(r)) != sizeof(r)) {
+      PRINTF("phase: cannot write %s\n", PHASE_FILENAME);
+      cfs_close(fd);
+      return -1;
+    }
+    n++;
+  }
+  cfs_close(fd);
+  PRINTF("phase: saved %d phases\n", n);
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+phase_restore(void)
+{
+  struct phase *e;
+  struct phase_record r;
+  int fd;
+
+  fd = cfs_open(PHASE_FILENAME, CFS_READ);
+  if(fd < 0) {
+    return;
+  }
+  while(cfs_read(fd, &r, sizeof(r)) == sizeof(r)) {
+    e = nbr_table_add_lladdr(nbr_phase, &r.neighbor);
+    if(e == NULL) {
+      break;
+    }
+    e->time = r.time;
+#if PHASE_DRIFT_CORRECT
+    e->updated = clock_time();
+    e->drift = r.drift;
+#endif
+    e->noacks = 0;
+    e->restored = 1;
+    PRINTF("phase: restored %d.%d\n", r.neighbor.u8[0], r.neighbor.u8[1]);
+  }
+  cfs_close(fd);
+}
+/*---------------------------------------------------------------------------*/
+#if PHASE_SNAPSHOT_INTERVAL
+static void
+handle_snapshot_timer(void *ptr)
+{
+  phase_snapshot();
+  ctimer_reset(&snapshot_timer);
+}
+#endif /* PHASE_SNAPSHOT_INTERVAL */
+#endif /* PHASE_PERSIST */
+/*---------------------------------------------------------------------------*/
 void
 phase_init(void)
 {
   memb_init(&queued_packets_memb);
   nbr_table_register(nbr_phase, NULL);
+#if PHASE_PERSIST
+  phase_restore();
+#if PHASE_SNAPSHOT_INTERVAL
+  ctimer_set(&snapshot_timer, PHASE_SNAPSHOT_INTERVAL,
+             handle_snapshot_timer, NULL);
+#endif /* PHASE_SNAPSHOT_INTERVAL */
+#endif /* PHASE_PERSIST */
 }
 /*---------------------------------------------------------------------------*/
@@ -47,6 +47,35 @@
 #include "lib/memb.h"
 #include "net/netstack.h"
 
+/* PHASE_CONF_PERSIST enables phase_snapshot(), and makes phase_init()
+   read the saved phases back from CFS. A restored phase is used as a
+   starting point for a full-length strobe until an ACK confirms it. */
+#ifdef PHASE_CONF_PERSIST
+#define PHASE_PERSIST PHASE_CONF_PERSIST
+#else
+#define PHASE_PERSIST 0
+#endif
+
+/* PHASE_CONF_PERSISTENT_RTIMER tells that the rtimer keeps counting
+   across a reboot, which is not the case on most platforms (e.g. Sky
+   or Z1). Only then are restored phases trusted without a full-length
+   strobe: phase_wait() wakes up earlier for them, and a single missed
+   ACK drops them. */
+#ifdef PHASE_CONF_PERSISTENT_RTIMER
+#define PHASE_PERSISTENT_RTIMER PHASE_CONF_PERSISTENT_RTIMER
+#else
+#define PHASE_PERSISTENT_RTIMER 0
+#endif
+
+/* The interval at which the phases are saved when PHASE_PERSIST is
+   set. With 0, the default, only explicit phase_snapshot() calls save
+   them, as each snapshot rewrites the file in flash. */
+#ifdef PHASE_CONF_SNAPSHOT_INTERVAL
+#define PHASE_SNAPSHOT_INTERVAL PHASE_CONF_SNAPSHOT_INTERVAL
+#else
+#define PHASE_SNAPSHOT_INTERVAL 0
+#endif
+
 typedef enum {
   PHASE_UNKNOWN,
   PHASE_SEND_NOW,
@@ -63,4 +92,10 @@ void phase_update(const linkaddr_t *neighbor,
                   rtimer_clock_t time, int mac_status);
 void phase_remove(const linkaddr_t *neighbor);
 
+#if PHASE_PERSIST
+/* Saves the known phases to CFS. Returns the number of phases saved,
+   or -1 on error. */
+int phase_snapshot(void);
+#endif /* PHASE_PERSIST */
+
 #endif /* PHASE_H */
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         TSCH adaptive channel hopping. Every node keeps the outcome of its
+ *         unicast transmissions per channel. The coordinator periodically
+ *         blacklists the channels whose PDR fell below a threshold, and
+ *         announces the resulting hopping sequence in its EBs together with
+ *         the ASN at which to switch. Nodes relay the announcement in their own
+ *         EBs and all switch in the same slot. Blacklisted channels are given
+ *         a new chance after TSCH_ADAPTIVE_HOPPING_BLACKLIST_PERIODS.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-private.h"
+#include "net/mac/tsch/tsch-adaptive-hopping.h"
+#include "net/mac/tsch/tsch-slot-operation.h"
+#include "net/mac/tsch/tsch-log.h"
+#include <stdio.h>
+#include <string.h>
+
+#if TSCH_ADAPTIVE_HOPPING
+
+#if TSCH_LOG_LEVEL >= 1
+#define DEBUG DEBUG_PRINT
+#else /* TSCH_LOG_LEVEL */
+#define DEBUG DEBUG_NONE
+#endif /* TSCH_LOG_LEVEL */
+#include "net/ip/uip-debug.h"
+
+/* EWMA weight of a new sample is 1 / 2^EWMA_SHIFT */
+#define EWMA_SHIFT 3
+#define PDR_FULL 0xffff
+
+#define CHANNEL_BIT(c) ((uint32_t)1 << (c))
+
+/* The coordinator blacklists channels out of the default sequence */
+static const uint8_t *base = TSCH_DEFAULT_HOPPING_SEQUENCE;
+#define BASE_LEN sizeof(TSCH_DEFAULT_HOPPING_SEQUENCE)
+
+static struct tsch_channel_stats stats[TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL];
+/* Coordinator: blacklisted channels, for how many periods, and the
+ * channels that must not be blacklisted */
+static uint32_t blacklist;
+static uint8_t blacklist_age[TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL];
+static uint32_t whitelist;
+static struct ctimer evaluate_timer;
+
+/* The announced hopping sequence. Written with the TSCH lock held; the slot
+ * operation only reads it and clears 'valid' once the switch is done. */
+static struct {
+  struct asn_t asn;
+  uint8_t len;
+  uint8_t list[TSCH_HOPPING_SEQUENCE_MAX_LEN];
+  volatile uint8_t valid;
+} pending;
+
+/*---------------------------------------------------------------------------*/
+static void
+reset_channel(uint8_t channel)
+{
+  stats[channel].pdr = PDR_FULL;
+  stats[channel].samples = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Set a hopping sequence to switch to at a given ASN */
+static int
+set_pending(const struct asn_t *asn, const uint8_t *list, uint8_t len)
+{
+  if(len == 0 || len > sizeof(pending.list)) {
+    return 0;
+  }
+  if(tsch_get_lock()) {
+    pending.asn = *asn;
+    pending.len = len;
+    memcpy(pending.list, list, len);
+    pending.valid = 1;
+    tsch_release_lock();
+    return 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Coordinator: announce the default sequence without the blacklisted channels */
+static void
+announce(uint32_t new_blacklist)
+{
+  uint8_t list[TSCH_HOPPING_SEQUENCE_MAX_LEN];
+  uint8_t len = 0;
+  struct asn_t switch_asn;
+  int i;
+
+  for(i = 0; i < BASE_LEN && len < sizeof(list); i++) {
+    if(base[i] >= TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL
+       || !(new_blacklist & CHANNEL_BIT(base[i]))) {
+      list[len++] = base[i];
+    }
+  }
+
+  /* Convert the delay per second to avoid overflowing the tick count */
+  switch_asn = current_asn;
+  ASN_INC(switch_asn, (TSCH_ADAPTIVE_HOPPING_SWITCH_DELAY + CLOCK_SECOND - 1) / CLOCK_SECOND
+          * TSCH_CLOCK_TO_SLOTS(CLOCK_SECOND, tsch_timing[tsch_ts_timeslot_length]));
+
+  if(set_pending(&switch_asn, list, len)) {
+    blacklist = new_blacklist;
+    PRINTF("TSCH-hopping: blacklist %08lx, switch to %u channels at asn-%x.%lx\n",
+           (unsigned long)blacklist, len, switch_asn.ms1b, (unsigned long)switch_asn.ls4b);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Coordinator: periodic channel evaluation */
+static void
+evaluate(void *ptr)
+{
+  uint32_t new_blacklist;
+  int allowed;
+  int i;
+
+  ctimer_reset(&evaluate_timer);
+
+  if(!tsch_is_coordinator || !tsch_is_associated || pending.valid) {
+    return;
+  }
+
+  /* Give channels that were blacklisted long enough a new chance */
+  new_blacklist = blacklist;
+  for(i = 0; i < TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL; i++) {
+    if((blacklist & CHANNEL_BIT(i))
+       && ++blacklist_age[i] >= TSCH_ADAPTIVE_HOPPING_BLACKLIST_PERIODS) {
+      new_blacklist &= ~CHANNEL_BIT(i);
+      reset_channel(i);
+    }
+  }
+
+  /* Blacklist bad channels, worst first, as long as enough remain */
+  allowed = 0;
+  for(i = 0; i < BASE_LEN; i++) {
+    if(base[i] >= TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL
+       || !(new_blacklist & CHANNEL_BIT(base[i]))) {
+      allowed++;
+    }
+  }
+  while(1) {
+    int worst = -1;
+    int worst_count = 0;
+    for(i = 0; i < BASE_LEN; i++) {
+      uint8_t c = base[i];
+      if(c < TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL
+         && !((new_blacklist | whitelist) & CHANNEL_BIT(c))
+         && stats[c].samples >= TSCH_ADAPTIVE_HOPPING_MIN_TX
+         && (uint32_t)stats[c].pdr * 100 < (uint32_t)TSCH_ADAPTIVE_HOPPING_PDR_THRESHOLD * PDR_FULL
+         && (worst == -1 || stats[c].pdr < stats[worst].pdr)) {
+        worst = c;
+      }
+    }
+    if(worst == -1) {
+      break;
+    }
+    /* A channel may appear several times in the sequence */
+    for(i = 0; i < BASE_LEN; i++) {
+      if(base[i] == worst) {
+        worst_count++;
+      }
+    }
+    if(allowed - worst_count < TSCH_ADAPTIVE_HOPPING_MIN_CHANNELS) {
+      break;
+    }
+    allowed -= worst_count;
+    new_blacklist |= CHANNEL_BIT(worst);
+    blacklist_age[worst] = 0;
+  }
+
+  if(new_blacklist != blacklist) {
+    announce(new_blacklist);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_adaptive_hopping_tx_outcome(uint8_t channel, uint8_t mac_tx_status)
+{
+  struct tsch_channel_stats *s;
+  if(channel >= TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL
+     || (mac_tx_status != MAC_TX_OK && mac_tx_status != MAC_TX_NOACK
+         && mac_tx_status != MAC_TX_COLLISION)) {
+    return;
+  }
+  s = &stats[channel];
+  s->pdr -= s->pdr >> EWMA_SHIFT;
+  if(mac_tx_status == MAC_TX_OK) {
+    s->pdr += PDR_FULL >> EWMA_SHIFT;
+    s->tx_ok++;
+  }
+  s->tx_count++;
+  if(s->samples < 0xff) {
+    s->samples++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_adaptive_hopping_rx(uint8_t channel, int8_t rssi)
+{
+  struct tsch_channel_stats *s;
+  if(channel >= TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL) {
+    return;
+  }
+  s = &stats[channel];
+  if(s->rx_count == 0) {
+    s->rssi = rssi;
+  } else {
+    s->rssi += ((int)rssi - s->rssi) / (1 << EWMA_SHIFT);
+  }
+  if(s->rx_count < 0xffff) {
+    s->rx_count++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_adaptive_hopping_check_switch(void)
+{
+  if(pending.valid && (int32_t)ASN_DIFF(current_asn, pending.asn) >= 0) {
+    memcpy(tsch_hopping_sequence, pending.list, pending.len);
+    ASN_DIVISOR_INIT(tsch_hopping_sequence_length, pending.len);
+    pending.valid = 0;
+    TSCH_LOG_ADD(tsch_log_message,
+        snprintf(log->message, sizeof(log->message),
+            "hopping sequence switched, %u channels", pending.len);
+    );
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_adaptive_hopping_eb_input(const struct ieee802154_ies *ies)
+{
+  if(ies->ie_hopping_switch_len == 0 || tsch_is_coordinator) {
+    return;
+  }
+  if(pending.valid && ASN_DIFF(pending.asn, ies->ie_hopping_switch_asn) == 0
+     && pending.asn.ms1b == ies->ie_hopping_switch_asn.ms1b) {
+    /* Already known */
+    return;
+  }
+  if(set_pending(&ies->ie_hopping_switch_asn, ies->ie_hopping_switch_list,
+                 ies->ie_hopping_switch_len)) {
+    PRINTF("TSCH-hopping: switch to %u channels at asn-%x.%lx\n",
+           pending.len, pending.asn.ms1b, (unsigned long)pending.asn.ls4b);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_adaptive_hopping_eb_output(struct ieee802154_ies *ies)
+{
+  if(pending.valid) {
+    ies->ie_hopping_switch_asn = pending.asn;
+    ies->ie_hopping_switch_len = pending.len;
+    memcpy(ies->ie_hopping_switch_list, pending.list, pending.len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_adaptive_hopping_set_whitelist(uint32_t channel_map)
+{
+  whitelist = channel_map;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+tsch_adaptive_hopping_get_blacklist(void)
+{
+  return blacklist;
+}
+/*---------------------------------------------------------------------------*/
+const struct tsch_channel_stats *
+tsch_adaptive_hopping_get_stats(uint8_t channel)
+{
+  return channel < TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL ? &stats[channel] : NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_adaptive_hopping_reset(void)
+{
+  int i;
+  pending.valid = 0;
+  blacklist = 0;
+  memset(stats, 0, sizeof(stats));
+  for(i = 0; i < TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL; i++) {
+    reset_channel(i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_adaptive_hopping_init(void)
+{
+  tsch_adaptive_hopping_reset();
+  ctimer_set(&evaluate_timer, TSCH_ADAPTIVE_HOPPING_PERIOD, evaluate, NULL);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_ADAPTIVE_HOPPING */
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         TSCH adaptive channel hopping: per-channel link quality and
+ *         coordinator-driven channel blacklisting
+ */
+
+#ifndef __TSCH_ADAPTIVE_HOPPING_H__
+#define __TSCH_ADAPTIVE_HOPPING_H__
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch-asn.h"
+#include "net/mac/frame802154e-ie.h"
+
+/******** Configuration *******/
+
+/* Track the outcome of unicast transmissions per channel, and let the
+ * coordinator remove persistently bad channels from the hopping sequence.
+ * The new sequence is announced in EBs together with the ASN at which all
+ * nodes switch to it. Nodes without this feature do not understand the
+ * announcement, so it must be enabled network-wide. EBs also always carry
+ * the sequence in use, for nodes that join after a switch. */
+#ifdef TSCH_CONF_ADAPTIVE_HOPPING
+#define TSCH_ADAPTIVE_HOPPING TSCH_CONF_ADAPTIVE_HOPPING
+#else
+#define TSCH_ADAPTIVE_HOPPING 0
+#endif
+
+/* Channels are tracked by number, from 0 to TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL - 1.
+ * Channels outside this range are never blacklisted. */
+#define TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL 32
+
+/* A channel is blacklisted when its PDR (in percent) falls below this */
+#ifdef TSCH_ADAPTIVE_HOPPING_CONF_PDR_THRESHOLD
+#define TSCH_ADAPTIVE_HOPPING_PDR_THRESHOLD TSCH_ADAPTIVE_HOPPING_CONF_PDR_THRESHOLD
+#else
+#define TSCH_ADAPTIVE_HOPPING_PDR_THRESHOLD 50
+#endif
+
+/* Minimum number of transmissions on a channel before judging it (max 255) */
+#ifdef TSCH_ADAPTIVE_HOPPING_CONF_MIN_TX
+#define TSCH_ADAPTIVE_HOPPING_MIN_TX TSCH_ADAPTIVE_HOPPING_CONF_MIN_TX
+#else
+#define TSCH_ADAPTIVE_HOPPING_MIN_TX 16
+#endif
+
+/* Never shrink the hopping sequence below this many entries */
+#ifdef TSCH_ADAPTIVE_HOPPING_CONF_MIN_CHANNELS
+#define TSCH_ADAPTIVE_HOPPING_MIN_CHANNELS TSCH_ADAPTIVE_HOPPING_CONF_MIN_CHANNELS
+#else
+#define TSCH_ADAPTIVE_HOPPING_MIN_CHANNELS 2
+#endif
+
+/* How often the coordinator re-evaluates the channels */
+#ifdef TSCH_ADAPTIVE_HOPPING_CONF_PERIOD
+#define TSCH_ADAPTIVE_HOPPING_PERIOD TSCH_ADAPTIVE_HOPPING_CONF_PERIOD
+#else
+#define TSCH_ADAPTIVE_HOPPING_PERIOD (60 * CLOCK_SECOND)
+#endif
+
+/* Number of periods after which a blacklisted channel is tried again */
+#ifdef TSCH_ADAPTIVE_HOPPING_CONF_BLACKLIST_PERIODS
+#define TSCH_ADAPTIVE_HOPPING_BLACKLIST_PERIODS TSCH_ADAPTIVE_HOPPING_CONF_BLACKLIST_PERIODS
+#else
+#define TSCH_ADAPTIVE_HOPPING_BLACKLIST_PERIODS 10
+#endif
+
+/* Time between announcing a new sequence and switching to it. Must leave
+ * enough EB periods for the announcement to reach the whole network. */
+#ifdef TSCH_ADAPTIVE_HOPPING_CONF_SWITCH_DELAY
+#define TSCH_ADAPTIVE_HOPPING_SWITCH_DELAY TSCH_ADAPTIVE_HOPPING_CONF_SWITCH_DELAY
+#else
+#define TSCH_ADAPTIVE_HOPPING_SWITCH_DELAY (8 * TSCH_EB_PERIOD)
+#endif
+
+/************ Types ***********/
+
+/* Link quality of a channel, as seen by this node */
+struct tsch_channel_stats {
+  /* EWMA of unicast Tx success, 0xffff is 100% */
+  uint16_t pdr;
+  /* Number of unicast transmissions with an outcome, and how many of them
+   * were acknowledged. Both wrap around, use differences */
+  uint16_t tx_count;
+  uint16_t tx_ok;
+  /* Number of outcomes since the channel was last (re)admitted, saturating */
+  uint8_t samples;
+  /* EWMA of the RSSI of received frames */
+  int8_t rssi;
+  /* Number of frames received, saturating */
+  uint16_t rx_count;
+};
+
+#if !TSCH_ADAPTIVE_HOPPING
+
+#define tsch_adaptive_hopping_init()
+#define tsch_adaptive_hopping_reset()
+#define tsch_adaptive_hopping_tx_outcome(channel, status)
+#define tsch_adaptive_hopping_rx(channel, rssi)
+#define tsch_adaptive_hopping_check_switch()
+#define tsch_adaptive_hopping_eb_input(ies)
+#define tsch_adaptive_hopping_eb_output(ies)
+
+#else /* TSCH_ADAPTIVE_HOPPING */
+
+/********** Functions *********/
+
+/* Initialize the module, called from tsch_init */
+void tsch_adaptive_hopping_init(void);
+/* Forget all statistics and any pending switch, called on TSCH reset */
+void tsch_adaptive_hopping_reset(void);
+/* Record the outcome of a unicast transmission (slot operation) */
+void tsch_adaptive_hopping_tx_outcome(uint8_t channel, uint8_t mac_tx_status);
+/* Record a received frame (slot operation) */
+void tsch_adaptive_hopping_rx(uint8_t channel, int8_t rssi);
+/* Switch to the announced hopping sequence if its ASN is reached
+ * (slot operation, before computing the channel) */
+void tsch_adaptive_hopping_check_switch(void);
+/* Adopt the sequence switch announced in an EB, if any */
+void tsch_adaptive_hopping_eb_input(const struct ieee802154_ies *ies);
+/* Fill in the pending sequence switch for an outgoing EB */
+void tsch_adaptive_hopping_eb_output(struct ieee802154_ies *ies);
+/* Channels that are never blacklisted (bitmap over channel numbers) */
+void tsch_adaptive_hopping_set_whitelist(uint32_t channel_map);
+/* Channels blacklisted by this node, only non-zero on the coordinator */
+uint32_t tsch_adaptive_hopping_get_blacklist(void);
+/* Link quality of a channel as seen by this node, NULL if out of range */
+const struct tsch_channel_stats *tsch_adaptive_hopping_get_stats(uint8_t channel);
+
+#endif /* TSCH_ADAPTIVE_HOPPING */
+
+#endif /* __TSCH_ADAPTIVE_HOPPING_H__ */
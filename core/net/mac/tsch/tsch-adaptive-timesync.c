@@ -38,10 +38,25 @@
  *
  */
 
-#include "tsch-adaptive-timesync.h"
-#include "tsch-log.h"
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-adaptive-timesync.h"
+#include "net/mac/tsch/tsch-log.h"
 #include <stdio.h>
 
+/* Units in which drift is stored: ppm * 256 */
+#define TSCH_DRIFT_UNIT (1000L * 1000 * 256)
+
+#if TSCH_ADAPTIVE_GUARD_TIME
+/* Ticks by which our timeslot boundaries were moved so far, by time
+ * corrections and drift compensation. Offsets of neighbors are stored
+ * without it, so that they can be predicted across our own corrections. */
+static int32_t slot_boundary_shift;
+#define GUARD_TIME_SHIFT(ticks) (slot_boundary_shift += (ticks))
+#else /* TSCH_ADAPTIVE_GUARD_TIME */
+#define GUARD_TIME_SHIFT(ticks)
+#endif /* TSCH_ADAPTIVE_GUARD_TIME */
+
 #if TSCH_ADAPTIVE_TIMESYNC
 
 /* Estimated drift of the time-source neighbor. Can be negative.
@@ -54,9 +69,6 @@ static uint8_t timesync_entry_count;
 /* Since last learning of the  drift; may be more than time since last timesync */
 static uint32_t asn_since_last_learning;
 
-/* Units in which drift is stored: ppm * 256 */
-#define TSCH_DRIFT_UNIT (1000L * 1000 * 256)
-
 /*---------------------------------------------------------------------------*/
 /* Add a value to a moving average estimator */
 static int32_t
@@ -98,6 +110,7 @@ timesync_learn_drift_ticks(uint32_t time_delta_asn, int32_t drift_ticks)
 void
 tsch_timesync_update(struct tsch_neighbor *n, uint16_t time_delta_asn, int32_t drift_correction)
 {
+  GUARD_TIME_SHIFT(drift_correction);
   /* Account the drift if either this is a new timesource,
    * or the timedelta is not too small, as smaller timedelta
    * means proportionally larger measurement error. */
@@ -167,6 +180,7 @@ tsch_timesync_adaptive_compensate(rtimer_clock_t time_delta_ticks)
         &base_drift_remainder, &base_drift_tick_conversion_error);
   }
 
+  GUARD_TIME_SHIFT(result);
   return result;
 }
 /*---------------------------------------------------------------------------*/
@@ -175,6 +189,7 @@ tsch_timesync_adaptive_compensate(rtimer_clock_t time_delta_ticks)
 void
 tsch_timesync_update(struct tsch_neighbor *n, uint16_t time_delta_asn, int32_t drift_correction)
 {
+  GUARD_TIME_SHIFT(drift_correction);
 }
 /*---------------------------------------------------------------------------*/
 int32_t
@@ -184,3 +199,224 @@ tsch_timesync_adaptive_compensate(rtimer_clock_t delta_ticks)
 }
 /*---------------------------------------------------------------------------*/
 #endif /* TSCH_ADAPTIVE_TIMESYNC */
+/*---------------------------------------------------------------------------*/
+#if TSCH_ADAPTIVE_GUARD_TIME
+/*---------------------------------------------------------------------------*/
+/* Beyond this age, the margin exceeds the default guard time anyway */
+#define GUARD_TIME_MAX_AGE (60L * TSCH_SLOTS_PER_SECOND)
+/* Minimum time between two drift estimations of a neighbor */
+#define GUARD_TIME_LEARNING_PERIOD (4 * TSCH_SLOTS_PER_SECOND)
+/* Good predictions needed to go down one widening level */
+#define GUARD_TIME_NARROW_AFTER 8
+
+/*---------------------------------------------------------------------------*/
+/* Ticks elapsed since the neighbor's last reception */
+static int64_t
+elapsed_ticks(const struct tsch_neighbor *n)
+{
+  return (int64_t)ASN_DIFF(current_asn, n->rx_asn) * tsch_timing[tsch_ts_timeslot_length];
+}
+/*---------------------------------------------------------------------------*/
+/* Offset of the neighbor's next frame, without slot_boundary_shift */
+static int32_t
+predicted_offset(const struct tsch_neighbor *n)
+{
+  return n->rx_offset + (int32_t)(elapsed_ticks(n) * n->drift_ppm / TSCH_DRIFT_UNIT);
+}
+/*---------------------------------------------------------------------------*/
+/* Guard time on either side of the predicted offset */
+static int32_t
+guard_time(const struct tsch_neighbor *n)
+{
+  return ((int32_t)US_TO_RTIMERTICKS(TSCH_GUARD_TIME_MIN) << n->guard_level)
+    + (int32_t)(elapsed_ticks(n) * TSCH_GUARD_TIME_MARGIN_PPM / 1000000);
+}
+/*---------------------------------------------------------------------------*/
+/* Is the neighbor's timing known well enough to predict its next frame? */
+static int
+timing_is_known(const struct tsch_neighbor *n)
+{
+  return n != NULL && !n->is_broadcast && n->drift_count > 0
+    && ASN_DIFF(current_asn, n->rx_asn) <= GUARD_TIME_MAX_AGE;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_timesync_rx_window(const struct tsch_link *link,
+                        rtimer_clock_t *rx_offset, rtimer_clock_t *rx_wait)
+{
+  struct tsch_neighbor *n;
+  int32_t arrival;
+  int32_t guard;
+  int32_t start;
+  int32_t end;
+  int32_t default_start = tsch_timing[tsch_ts_rx_offset];
+  int32_t default_end = default_start + tsch_timing[tsch_ts_rx_wait];
+
+  if(link == NULL || linkaddr_cmp(&link->addr, &tsch_broadcast_address)) {
+    return 0;
+  }
+  n = tsch_queue_get_nbr(&link->addr);
+  if(!timing_is_known(n)) {
+    return 0;
+  }
+
+  /* Expected start of the frame, and a guard time on either side of it.
+   * The end of the window also covers the radio detection delay. */
+  arrival = (int32_t)tsch_timing[tsch_ts_tx_offset]
+    - (predicted_offset(n) + slot_boundary_shift);
+  guard = guard_time(n);
+  start = MAX(arrival - guard, default_start);
+  end = MIN(arrival + guard + (int32_t)RADIO_DELAY_BEFORE_DETECT, default_end);
+
+  if(end - start >= default_end - default_start || end <= start) {
+    return 0;
+  }
+  *rx_offset = start;
+  *rx_wait = end - start;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_timesync_rx_update(struct tsch_neighbor *n, int32_t estimated_drift,
+                        uint8_t seqno, int is_unicast, int frame_pending)
+{
+  int32_t offset;
+  int is_retransmission;
+
+  if(n == NULL || n->is_broadcast) {
+    return;
+  }
+
+  offset = estimated_drift - slot_boundary_shift;
+
+  if(n->rx_count > 0 && ASN_DIFF(current_asn, n->rx_asn) > GUARD_TIME_MAX_AGE) {
+    /* Too long ago to compare with, learn again */
+    n->rx_count = 0;
+  }
+
+  n->guard_miss_count = 0;
+  is_retransmission = is_unicast && n->rx_count > 0 && seqno == n->last_seqno;
+  /* A sender that has more for us, or that has to retry, will send again */
+  n->rx_pending = frame_pending || is_retransmission;
+
+  if(timing_is_known(n)) {
+    int32_t error = offset - predicted_offset(n);
+    if(ABS(error) > (int32_t)tsch_timing[tsch_ts_rx_wait] / 2) {
+      /* Way off, e.g. after a resynchronization: learn again */
+      TSCH_LOG_ADD(tsch_log_message,
+          snprintf(log->message, sizeof(log->message),
+              "!guard time: reset, error %ld", (long)error));
+      n->rx_count = 0;
+    } else if(ABS(error) > guard_time(n) / 2 || is_retransmission) {
+      /* Close to the window edge, or a retransmission, i.e. the previous
+       * attempt was likely missed: widen the window */
+      if(n->guard_level < TSCH_GUARD_TIME_MAX_LEVEL) {
+        n->guard_level++;
+      }
+      n->guard_ok_count = 0;
+    } else if(++n->guard_ok_count >= GUARD_TIME_NARROW_AFTER) {
+      if(n->guard_level > 0) {
+        n->guard_level--;
+      }
+      n->guard_ok_count = 0;
+    }
+  }
+
+  if(n->rx_count == 0) {
+    /* Start learning from this reception */
+    n->learn_asn = current_asn;
+    n->learn_offset = offset;
+    n->drift_count = 0;
+    n->guard_ok_count = 0;
+  } else if(ASN_DIFF(current_asn, n->learn_asn) >= GUARD_TIME_LEARNING_PERIOD) {
+    /* Learn the drift relative to us, as a moving average */
+    int64_t delta_ticks = (int64_t)ASN_DIFF(current_asn, n->learn_asn)
+      * tsch_timing[tsch_ts_timeslot_length];
+    int32_t last_drift_ppm = (int32_t)((int64_t)(offset - n->learn_offset)
+        * TSCH_DRIFT_UNIT / delta_ticks);
+    if(n->drift_count == 0) {
+      n->drift_ppm = last_drift_ppm;
+    } else {
+      n->drift_ppm = (3 * n->drift_ppm + last_drift_ppm) / 4;
+    }
+    if(n->drift_count < 0xff) {
+      n->drift_count++;
+    }
+    n->learn_asn = current_asn;
+    n->learn_offset = offset;
+  }
+
+  n->rx_asn = current_asn;
+  n->rx_offset = offset;
+  if(n->rx_count < 0xff) {
+    n->rx_count++;
+  }
+  if(is_unicast) {
+    n->last_seqno = seqno;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_timesync_rx_miss(const struct tsch_link *link)
+{
+  struct tsch_neighbor *n;
+
+  if(link == NULL) {
+    return;
+  }
+  n = tsch_queue_get_nbr(&link->addr);
+  /* An empty window only tells something if the neighbor had more to send:
+   * otherwise, it may just have had nothing for us */
+  if(n == NULL || !n->rx_pending || ++n->guard_miss_count < TSCH_GUARD_TIME_MISSES) {
+    return;
+  }
+  /* We are likely missing the neighbor's frames. Good predictions will
+   * narrow the window again */
+  n->guard_miss_count = 0;
+  n->guard_ok_count = 0;
+  if(n->guard_level < TSCH_GUARD_TIME_MAX_LEVEL) {
+    n->guard_level++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_timesync_rx_reset(void)
+{
+  struct tsch_neighbor *n;
+
+  for(n = tsch_queue_get_nbr_next(NULL); n != NULL; n = tsch_queue_get_nbr_next(n)) {
+    n->rx_count = 0;
+    n->drift_count = 0;
+    n->guard_level = 0;
+    n->guard_ok_count = 0;
+    n->guard_miss_count = 0;
+    n->rx_pending = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+#else /* TSCH_ADAPTIVE_GUARD_TIME */
+/*---------------------------------------------------------------------------*/
+int
+tsch_timesync_rx_window(const struct tsch_link *link,
+                        rtimer_clock_t *rx_offset, rtimer_clock_t *rx_wait)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_timesync_rx_update(struct tsch_neighbor *n, int32_t estimated_drift,
+                        uint8_t seqno, int is_unicast, int frame_pending)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_timesync_rx_miss(const struct tsch_link *link)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_timesync_rx_reset(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_ADAPTIVE_GUARD_TIME */
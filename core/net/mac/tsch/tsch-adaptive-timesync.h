@@ -37,6 +37,7 @@
 
 #include "contiki.h"
 #include "net/mac/tsch/tsch-private.h"
+#include "net/mac/tsch/tsch-schedule.h"
 
 /******** Configuration *******/
 
@@ -75,6 +76,40 @@
 /* The approximate number of slots per second */
 #define TSCH_SLOTS_PER_SECOND (1000000 / TSCH_DEFAULT_TS_TIMESLOT_LENGTH)
 
+/* With TSCH_ADAPTIVE_GUARD_TIME: the narrowest Rx guard time, in usec,
+ * on either side of the predicted arrival time of a neighbor's frame.
+ * Doubled at every widening level after a missed prediction. */
+#ifdef TSCH_CONF_GUARD_TIME_MIN
+#define TSCH_GUARD_TIME_MIN TSCH_CONF_GUARD_TIME_MIN
+#else
+#define TSCH_GUARD_TIME_MIN 250
+#endif
+
+/* With TSCH_ADAPTIVE_GUARD_TIME: the uncertainty of a learned drift, in ppm.
+ * The guard time grows by this much with the time since the last reception. */
+#ifdef TSCH_CONF_GUARD_TIME_MARGIN_PPM
+#define TSCH_GUARD_TIME_MARGIN_PPM TSCH_CONF_GUARD_TIME_MARGIN_PPM
+#else
+#define TSCH_GUARD_TIME_MARGIN_PPM 20
+#endif
+
+/* With TSCH_ADAPTIVE_GUARD_TIME: the highest widening level */
+#ifdef TSCH_CONF_GUARD_TIME_MAX_LEVEL
+#define TSCH_GUARD_TIME_MAX_LEVEL TSCH_CONF_GUARD_TIME_MAX_LEVEL
+#else
+#define TSCH_GUARD_TIME_MAX_LEVEL 3
+#endif
+
+/* With TSCH_ADAPTIVE_GUARD_TIME: widen the window by one level after this
+ * many narrowed windows in a row without a frame, while the neighbor is known
+ * to have more to send (its last frame had the frame-pending bit set, or was
+ * a retransmission) */
+#ifdef TSCH_CONF_GUARD_TIME_MISSES
+#define TSCH_GUARD_TIME_MISSES TSCH_CONF_GUARD_TIME_MISSES
+#else
+#define TSCH_GUARD_TIME_MISSES 2
+#endif
+
 /***** External Variables *****/
 
 /* The neighbor last used as our time source */
@@ -86,4 +121,21 @@ void tsch_timesync_update(struct tsch_neighbor *n, uint16_t time_delta_asn, int3
 
 int32_t tsch_timesync_adaptive_compensate(rtimer_clock_t delta_ticks);
 
+/* Get the Rx window for a link dedicated to a neighbor whose drift we know.
+ * Returns 1 and sets offset and length (from the slot start) if the window
+ * is narrower than the default one, 0 otherwise. */
+int tsch_timesync_rx_window(const struct tsch_link *link,
+                            rtimer_clock_t *rx_offset, rtimer_clock_t *rx_wait);
+
+/* Learn from a frame received from a neighbor, estimated_drift ticks early.
+ * Must be called before tsch_timesync_update for that same frame. */
+void tsch_timesync_rx_update(struct tsch_neighbor *n, int32_t estimated_drift,
+                             uint8_t seqno, int is_unicast, int frame_pending);
+
+/* Nothing was received in the window returned by tsch_timesync_rx_window */
+void tsch_timesync_rx_miss(const struct tsch_link *link);
+
+/* Forget the timing learned from all neighbors, e.g. after a resynchronization */
+void tsch_timesync_rx_reset(void);
+
 #endif /* __TSCH_ADAPTIVE_TIMESYNC_H__ */
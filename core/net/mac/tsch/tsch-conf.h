@@ -168,6 +168,14 @@
 #define TSCH_WITH_LINK_SELECTOR 0
 #endif /* TSCH_CONF_WITH_LINK_SELECTOR */
 
+/* Account the energest radio time of every timeslot to its link and
+ * slotframe (see tsch-energest.h). Requires ENERGEST_CONF_ON. */
+#ifdef TSCH_CONF_WITH_ENERGEST
+#define TSCH_WITH_ENERGEST TSCH_CONF_WITH_ENERGEST
+#else /* TSCH_CONF_WITH_ENERGEST */
+#define TSCH_WITH_ENERGEST 0
+#endif /* TSCH_CONF_WITH_ENERGEST */
+
 /* Estimate the drift of the time-source neighbor and compensate for it? */
 #ifdef TSCH_CONF_ADAPTIVE_TIMESYNC
 #define TSCH_ADAPTIVE_TIMESYNC TSCH_CONF_ADAPTIVE_TIMESYNC
@@ -175,4 +183,12 @@
 #define TSCH_ADAPTIVE_TIMESYNC 0
 #endif
 
+/* Learn the clock drift of every neighbor we receive from, and use it to
+ * narrow the Rx guard time on links dedicated to that neighbor? */
+#ifdef TSCH_CONF_ADAPTIVE_GUARD_TIME
+#define TSCH_ADAPTIVE_GUARD_TIME TSCH_CONF_ADAPTIVE_GUARD_TIME
+#else
+#define TSCH_ADAPTIVE_GUARD_TIME 0
+#endif
+
 #endif /* __TSCH_CONF_H__ */
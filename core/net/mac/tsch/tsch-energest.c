@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         TSCH radio time accounting per link and slotframe, from energest
+ *
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-energest.h"
+
+#if TSCH_WITH_ENERGEST
+
+#if !ENERGEST_CONF_ON
+#error "TSCH_WITH_ENERGEST requires ENERGEST_CONF_ON"
+#endif
+
+/* Energest radio times at the start of the current timeslot */
+static unsigned long slot_start_tx;
+static unsigned long slot_start_rx;
+
+/*---------------------------------------------------------------------------*/
+/* Energest time of a type, including a period still in progress */
+static unsigned long
+radio_time(int type)
+{
+  unsigned long t = energest_total_time[type].current;
+  if(energest_current_mode[type]) {
+    t += (rtimer_clock_t)(RTIMER_NOW() - energest_current_time[type]);
+  }
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stats_add(struct tsch_energest_stats *s, uint32_t tx, uint32_t rx, int is_idle_rx)
+{
+  if(s != NULL) {
+    s->tx_ticks += tx;
+    s->rx_ticks += rx;
+    s->slots++;
+    if(is_idle_rx) {
+      s->idle_rx++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_energest_slot_start(void)
+{
+  slot_start_tx = radio_time(ENERGEST_TYPE_TRANSMIT);
+  slot_start_rx = radio_time(ENERGEST_TYPE_LISTEN);
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_energest_slot_end(struct tsch_energest_stats *link_stats,
+                       struct tsch_energest_stats *slotframe_stats,
+                       int is_idle_rx)
+{
+  uint32_t tx = radio_time(ENERGEST_TYPE_TRANSMIT) - slot_start_tx;
+  uint32_t rx = radio_time(ENERGEST_TYPE_LISTEN) - slot_start_rx;
+
+  /* Skip timeslots where the radio stayed off, e.g. Tx links
+   * with nothing to send */
+  if(tx != 0 || rx != 0 || is_idle_rx) {
+    stats_add(link_stats, tx, rx, is_idle_rx);
+    stats_add(slotframe_stats, tx, rx, is_idle_rx);
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+tsch_energest_uj(const struct tsch_energest_stats *s)
+{
+  return (uint32_t)(((uint64_t)s->tx_ticks * TSCH_ENERGEST_TX_POWER_UW
+                     + (uint64_t)s->rx_ticks * TSCH_ENERGEST_RX_POWER_UW)
+                    / RTIMER_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+tsch_energest_ms(uint32_t ticks)
+{
+  return (uint32_t)((uint64_t)ticks * 1000 / RTIMER_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_WITH_ENERGEST */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+#ifndef __TSCH_ENERGEST_H__
+#define __TSCH_ENERGEST_H__
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "sys/energest.h"
+
+/******** Configuration *******/
+
+/* With TSCH_WITH_ENERGEST: radio power draw when transmitting, in
+ * microwatts. Default: CC2420 at 0 dBm (17.4 mA) and 3 V. */
+#ifdef TSCH_ENERGEST_CONF_TX_POWER_UW
+#define TSCH_ENERGEST_TX_POWER_UW TSCH_ENERGEST_CONF_TX_POWER_UW
+#else
+#define TSCH_ENERGEST_TX_POWER_UW 52200
+#endif
+
+/* With TSCH_WITH_ENERGEST: radio power draw when listening, in
+ * microwatts. Default: CC2420 (18.8 mA) at 3 V. */
+#ifdef TSCH_ENERGEST_CONF_RX_POWER_UW
+#define TSCH_ENERGEST_RX_POWER_UW TSCH_ENERGEST_CONF_RX_POWER_UW
+#else
+#define TSCH_ENERGEST_RX_POWER_UW 56400
+#endif
+
+/************ Types ***********/
+
+/* Radio usage of a link or slotframe. Counters wrap around. */
+struct tsch_energest_stats {
+  uint32_t tx_ticks; /* Radio time transmitting, in rtimer ticks */
+  uint32_t rx_ticks; /* Radio time listening, including for ACKs */
+  uint32_t slots; /* Timeslots in which the radio was used */
+  uint32_t idle_rx; /* Rx timeslots in which no frame was detected */
+};
+
+/********** Functions *********/
+
+/* Snapshot the energest radio times at the start of a timeslot */
+void tsch_energest_slot_start(void);
+/* Add the radio time since tsch_energest_slot_start to the stats of
+ * a link and of its slotframe (either may be NULL) */
+void tsch_energest_slot_end(struct tsch_energest_stats *link_stats,
+                            struct tsch_energest_stats *slotframe_stats,
+                            int is_idle_rx);
+/* Energy spent by the radio, in microjoules */
+uint32_t tsch_energest_uj(const struct tsch_energest_stats *s);
+/* Convert a radio time to milliseconds */
+uint32_t tsch_energest_ms(uint32_t ticks);
+
+#endif /* __TSCH_ENERGEST_H__ */
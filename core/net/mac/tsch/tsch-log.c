@@ -69,6 +69,85 @@ PROCESS_NAME(tsch_pending_events_process);
 static struct ringbufindex log_ringbuf;
 static struct tsch_log_t log_array[TSCH_LOG_QUEUE_LEN];
 static int log_dropped = 0;
+#if TSCH_LOG_BINARY
+/* Number of logs output so far. Only used from tsch_log_process_pending,
+ * the sequence number of a log is this plus the logs dropped before it. */
+static uint16_t log_output_count;
+
+#define SLIP_END     0300
+#define SLIP_ESC     0333
+#define SLIP_ESC_END 0334
+#define SLIP_ESC_ESC 0335
+
+/*---------------------------------------------------------------------------*/
+static void
+slip_putc(uint8_t c)
+{
+  if(c == SLIP_END) {
+    putchar(SLIP_ESC);
+    c = SLIP_ESC_END;
+  } else if(c == SLIP_ESC) {
+    putchar(SLIP_ESC);
+    c = SLIP_ESC_ESC;
+  }
+  putchar(c);
+}
+/*---------------------------------------------------------------------------*/
+static void
+slip_put16(uint16_t v)
+{
+  slip_putc(v & 0xff);
+  slip_putc(v >> 8);
+}
+/*---------------------------------------------------------------------------*/
+/* Write a log as one SLIP frame, see tsch-log.h for the record format */
+static void
+log_output_binary(struct tsch_log_t *log, struct tsch_slotframe *sf)
+{
+  const char *c;
+
+  putchar(SLIP_END);
+  slip_putc(TSCH_LOG_BINARY_MAGIC);
+  slip_putc(log->type);
+  slip_put16(log_output_count++ + log->dropped);
+  slip_put16(log->asn.ls4b & 0xffff);
+  slip_put16(log->asn.ls4b >> 16);
+  slip_putc(log->asn.ms1b);
+  slip_putc(log->link->slotframe_handle);
+  slip_put16(sf ? sf->size.val : 0);
+  slip_put16(log->link->timeslot);
+  slip_put16(log->link->channel_offset);
+  slip_putc(tsch_calculate_channel(&log->asn, log->link->channel_offset));
+  switch(log->type) {
+    case tsch_log_tx:
+      slip_putc(log->tx.mac_tx_status);
+      slip_put16(log->tx.dest);
+      slip_put16(log->tx.drift);
+      slip_putc(log->tx.num_tx);
+      slip_putc(log->tx.datalen);
+      slip_putc(log->tx.is_data);
+      slip_putc(log->tx.sec_level);
+      slip_putc(log->tx.drift_used);
+      break;
+    case tsch_log_rx:
+      slip_put16(log->rx.src);
+      slip_put16(log->rx.drift);
+      slip_put16(log->rx.estimated_drift);
+      slip_putc(log->rx.datalen);
+      slip_putc(log->rx.is_unicast);
+      slip_putc(log->rx.is_data);
+      slip_putc(log->rx.sec_level);
+      slip_putc(log->rx.drift_used);
+      break;
+    case tsch_log_message:
+      for(c = log->message; c < log->message + sizeof(log->message) && *c != '\0'; c++) {
+        slip_putc(*c);
+      }
+      break;
+  }
+  putchar(SLIP_END);
+}
+#endif /* TSCH_LOG_BINARY */
 
 /*---------------------------------------------------------------------------*/
 /* Process pending log messages */
@@ -85,6 +164,9 @@ tsch_log_process_pending(void)
   while((log_index = ringbufindex_peek_get(&log_ringbuf)) != -1) {
     struct tsch_log_t *log = &log_array[log_index];
     struct tsch_slotframe *sf = tsch_schedule_get_slotframe_by_handle(log->link->slotframe_handle);
+#if TSCH_LOG_BINARY
+    log_output_binary(log, sf);
+#else /* TSCH_LOG_BINARY */
     printf("TSCH: {asn-%x.%lx link-%u-%u-%u-%u ch-%u} ",
         log->asn.ms1b, log->asn.ls4b,
         log->link->slotframe_handle, sf ? sf->size.val : 0, log->link->timeslot, log->link->channel_offset,
@@ -115,6 +197,7 @@ tsch_log_process_pending(void)
         printf("%s\n", log->message);
         break;
     }
+#endif /* TSCH_LOG_BINARY */
     /* Remove input from ringbuf */
     ringbufindex_get(&log_ringbuf);
   }
@@ -130,6 +213,9 @@ tsch_log_prepare_add(void)
     struct tsch_log_t *log = &log_array[log_index];
     log->asn = current_asn;
     log->link = current_link;
+#if TSCH_LOG_BINARY
+    log->dropped = log_dropped;
+#endif /* TSCH_LOG_BINARY */
     return log;
   } else {
     log_dropped++;
@@ -65,6 +65,36 @@
 #define TSCH_LOG_LEVEL 0
 #endif /* TSCH_LOG_CONF_LEVEL */
 
+/* Output pending logs as SLIP-framed binary records instead of text.
+ * Each record is a few tens of bytes rather than a ~80-byte printf line,
+ * carries a sequence number so that dropped logs show up as gaps, and
+ * can be turned back into text on the host with tools/tsch-log-decode.
+ * Regular printf output on the same line is left untouched. */
+#ifdef TSCH_LOG_CONF_BINARY
+#define TSCH_LOG_BINARY TSCH_LOG_CONF_BINARY
+#else /* TSCH_LOG_CONF_BINARY */
+#define TSCH_LOG_BINARY 0
+#endif /* TSCH_LOG_CONF_BINARY */
+
+/* Binary log record format, all fields little endian:
+ *  0  magic (TSCH_LOG_BINARY_MAGIC)
+ *  1  log type (tsch_log_tx, tsch_log_rx or tsch_log_message)
+ *  2  sequence number (2 bytes), incremented for every log, dropped or not
+ *  4  ASN (5 bytes, ls4b first)
+ *  9  slotframe handle
+ * 10  slotframe size (2 bytes)
+ * 12  timeslot (2 bytes)
+ * 14  channel offset (2 bytes)
+ * 16  channel
+ * 17  type-specific body:
+ *     tx: mac_tx_status, dest (2), drift (2), num_tx, datalen, is_data,
+ *         sec_level, drift_used
+ *     rx: src (2), drift (2), estimated drift (2), datalen, is_unicast,
+ *         is_data, sec_level, drift_used
+ *     message: the string, without terminating zero */
+#define TSCH_LOG_BINARY_MAGIC 0xa5
+#define TSCH_LOG_BINARY_HEADER_LEN 17
+
 #if TSCH_LOG_LEVEL < 2 /* For log level 0 or 1, the logging functions do nothing */
 
 #define tsch_log_init()
@@ -83,6 +113,9 @@ struct tsch_log_t {
   } type;
   struct asn_t asn;
   struct tsch_link *link;
+#if TSCH_LOG_BINARY
+  uint16_t dropped; /* Logs dropped before this one */
+#endif /* TSCH_LOG_BINARY */
   union {
     char message[48];
     struct {
@@ -46,6 +46,7 @@
 #include "net/mac/tsch/tsch-schedule.h"
 #include "net/mac/tsch/tsch-security.h"
 #include "net/mac/tsch/tsch-log.h"
+#include "net/mac/tsch/tsch-adaptive-hopping.h"
 #include "net/mac/frame802154.h"
 #include "net/mac/framer-802154.h"
 #include "net/netstack.h"
@@ -251,14 +252,19 @@ tsch_packet_create_eb(uint8_t *buf, int buf_size, uint8_t seqno,
   }
 #endif /* TSCH_PACKET_EB_WITH_TIMESLOT_TIMING */
 
-  /* Add TSCH hopping sequence IE */
-#if TSCH_PACKET_EB_WITH_HOPPING_SEQUENCE
+  /* Add TSCH hopping sequence IE. With adaptive hopping, the sequence in
+   * use may no longer be the default one, and nodes joining after a switch
+   * can only learn it from here. */
+#if TSCH_PACKET_EB_WITH_HOPPING_SEQUENCE || TSCH_ADAPTIVE_HOPPING
   if(tsch_hopping_sequence_length.val <= sizeof(ies.ie_hopping_sequence_list)) {
     ies.ie_channel_hopping_sequence_id = 1;
     ies.ie_hopping_sequence_len = tsch_hopping_sequence_length.val;
     memcpy(ies.ie_hopping_sequence_list, tsch_hopping_sequence, ies.ie_hopping_sequence_len);
   }
-#endif /* TSCH_PACKET_EB_WITH_HOPPING_SEQUENCE */
+#endif /* TSCH_PACKET_EB_WITH_HOPPING_SEQUENCE || TSCH_ADAPTIVE_HOPPING */
+
+  /* Add the upcoming hopping sequence, if any */
+  tsch_adaptive_hopping_eb_output(&ies);
 
   /* Add Slotframe and Link IE */
 #if TSCH_PACKET_EB_WITH_SLOTFRAME_AND_LINK
@@ -318,6 +324,11 @@ tsch_packet_create_eb(uint8_t *buf, int buf_size, uint8_t seqno,
   }
   curr_len += ret;
 
+  if((ret = frame80215e_create_ie_tsch_hopping_switch(buf + curr_len, buf_size - curr_len, &ies)) == -1) {
+    return -1;
+  }
+  curr_len += ret;
+
   ies.ie_mlme_len = curr_len - mlme_ie_offset - 2;
   if((ret = frame80215e_create_ie_mlme(buf + mlme_ie_offset, buf_size - mlme_ie_offset, &ies)) == -1) {
     return -1;
@@ -77,6 +77,122 @@ LIST(neighbor_list);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+/* Neighbors are identified by their index in neighbor_memb, both in the
+ * address index and in the maps below */
+#if TSCH_QUEUE_MAX_NEIGHBOR_QUEUES < 0xff
+typedef uint8_t nbr_index_t;
+#else
+typedef uint16_t nbr_index_t;
+#endif
+
+#if TSCH_QUEUE_HASH_SIZE
+/* Index of the neighbors by MAC address. Each bucket is a chain of neighbor
+ * indexes linked through hash_next[]. Only changed with the lock held.
+ * Entries hold index + 1, so that the zero-initialized tables are valid
+ * even before tsch_queue_init (e.g. if TSCH init was aborted). */
+static nbr_index_t hash_heads[TSCH_QUEUE_HASH_SIZE];
+static nbr_index_t hash_next[TSCH_QUEUE_MAX_NEIGHBOR_QUEUES];
+#endif /* TSCH_QUEUE_HASH_SIZE */
+
+/* Bitmaps over neighbor indexes, used to pick a unicast packet for a shared
+ * link without walking neighbor_list from within the slot operation.
+ * Each map has a single writer outside of the lock, so that a concurrent
+ * read-modify-write can never lose an update that matters:
+ * - queued_map: unicast neighbors that had a packet added. Set from process
+ * context, cleared by the slot operation once it finds the queue empty. A bit
+ * may thus be set for an empty queue, but never clear for a non-empty one.
+ * - backoff_map: neighbors with a non-zero backoff window. Written by the
+ * slot operation (or with the lock held).
+ * - tx_links_map: neighbors we have a Tx link to, which are not eligible for
+ * "any" packet selection. Written from process context only. */
+#define NBR_MAP_WORDS ((TSCH_QUEUE_MAX_NEIGHBOR_QUEUES + 31) / 32)
+static uint32_t queued_map[NBR_MAP_WORDS];
+static uint32_t backoff_map[NBR_MAP_WORDS];
+static uint32_t tx_links_map[NBR_MAP_WORDS];
+#define NBR_MAP_SET(map, i) ((map)[(i) / 32] |= (uint32_t)1 << ((i) % 32))
+#define NBR_MAP_CLEAR(map, i) ((map)[(i) / 32] &= ~((uint32_t)1 << ((i) % 32)))
+/* Where the next round-robin search for a unicast packet starts */
+static nbr_index_t rr_next;
+
+/*---------------------------------------------------------------------------*/
+/* Get the index of a neighbor */
+static int
+index_from_nbr(const struct tsch_neighbor *n)
+{
+  return n - (struct tsch_neighbor *)neighbor_memb.mem;
+}
+/*---------------------------------------------------------------------------*/
+/* Get a neighbor from its index */
+static struct tsch_neighbor *
+nbr_from_index(int index)
+{
+  return &((struct tsch_neighbor *)neighbor_memb.mem)[index];
+}
+/*---------------------------------------------------------------------------*/
+/* Find the first neighbor index >= from that has a queued packet, no backoff
+ * and no Tx link. Returns -1 if there is none. */
+static int
+next_ready_index(int from)
+{
+  int w;
+  for(w = from / 32; w < NBR_MAP_WORDS; w++) {
+    uint32_t ready = queued_map[w] & ~backoff_map[w] & ~tx_links_map[w];
+    int bit = 0;
+    if(w == from / 32) {
+      ready &= ~(uint32_t)0 << (from % 32);
+    }
+    if(ready == 0) {
+      continue;
+    }
+    while(!(ready & 1)) {
+      ready >>= 1;
+      bit++;
+    }
+    return w * 32 + bit;
+  }
+  return -1;
+}
+#if TSCH_QUEUE_HASH_SIZE
+/*---------------------------------------------------------------------------*/
+/* Get the hash bucket of a MAC address */
+static nbr_index_t *
+hash_bucket(const linkaddr_t *addr)
+{
+  uint8_t h = 0;
+  int i;
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h ^= addr->u8[i];
+  }
+  return &hash_heads[h % TSCH_QUEUE_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+/* Add a neighbor to the address index */
+static void
+hash_add(struct tsch_neighbor *n)
+{
+  nbr_index_t *bucket = hash_bucket(&n->addr);
+  int index = index_from_nbr(n);
+
+  hash_next[index] = *bucket;
+  *bucket = index + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a neighbor from the address index */
+static void
+hash_remove(struct tsch_neighbor *n)
+{
+  nbr_index_t *link = hash_bucket(&n->addr);
+  int index = index_from_nbr(n);
+
+  for(; *link != 0; link = &hash_next[*link - 1]) {
+    if(*link == index + 1) {
+      *link = hash_next[index];
+      return;
+    }
+  }
+}
+#endif /* TSCH_QUEUE_HASH_SIZE */
+
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -97,8 +213,13 @@ tsch_queue_add_nbr(const linkaddr_t *addr)
         n->is_broadcast = linkaddr_cmp(addr, &tsch_eb_address)
           || linkaddr_cmp(addr, &tsch_broadcast_address);
         tsch_queue_backoff_reset(n);
+        NBR_MAP_CLEAR(queued_map, index_from_nbr(n));
+        NBR_MAP_CLEAR(tx_links_map, index_from_nbr(n));
         /* Add neighbor to the list */
         list_add(neighbor_list, n);
+#if TSCH_QUEUE_HASH_SIZE
+        hash_add(n);
+#endif /* TSCH_QUEUE_HASH_SIZE */
       }
       tsch_release_lock();
     }
@@ -111,6 +232,16 @@ struct tsch_neighbor *
 tsch_queue_get_nbr(const linkaddr_t *addr)
 {
   if(!tsch_is_locked()) {
+#if TSCH_QUEUE_HASH_SIZE
+    nbr_index_t index;
+    for(index = *hash_bucket(addr); index != 0;
+        index = hash_next[index - 1]) {
+      struct tsch_neighbor *n = nbr_from_index(index - 1);
+      if(linkaddr_cmp(&n->addr, addr)) {
+        return n;
+      }
+    }
+#else /* TSCH_QUEUE_HASH_SIZE */
     struct tsch_neighbor *n = list_head(neighbor_list);
     while(n != NULL) {
       if(linkaddr_cmp(&n->addr, addr)) {
@@ -118,6 +249,7 @@ tsch_queue_get_nbr(const linkaddr_t *addr)
       }
       n = list_item_next(n);
     }
+#endif /* TSCH_QUEUE_HASH_SIZE */
   }
   return NULL;
 }
@@ -222,6 +354,12 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
 
       /* Remove neighbor from list */
       list_remove(neighbor_list, n);
+#if TSCH_QUEUE_HASH_SIZE
+      hash_remove(n);
+#endif /* TSCH_QUEUE_HASH_SIZE */
+      NBR_MAP_CLEAR(queued_map, index_from_nbr(n));
+      NBR_MAP_CLEAR(backoff_map, index_from_nbr(n));
+      NBR_MAP_CLEAR(tx_links_map, index_from_nbr(n));
 
       tsch_release_lock();
 
@@ -261,6 +399,11 @@ tsch_queue_add_packet(const linkaddr_t *addr, mac_callback_t sent, void *ptr)
             /* Add to ringbuf (actual add committed through atomic operation) */
             n->tx_array[put_index] = p;
             ringbufindex_put(&n->tx_ringbuf);
+            /* Only after the put is committed, so that the slot operation
+             * never clears the bit of a non-empty queue */
+            if(!n->is_broadcast) {
+              NBR_MAP_SET(queued_map, index_from_nbr(n));
+            }
 #ifdef TSCH_CALLBACK_QUEUE_CHANGED
             TSCH_CALLBACK_QUEUE_CHANGED(TSCH_QUEUE_EVENT_GROW, n);
 #endif
@@ -296,13 +439,16 @@ tsch_queue_remove_packet_from_queue(struct tsch_neighbor *n)
 {
   if(!tsch_is_locked()) {
     if(n != NULL) {
-      /* Get and remove packet from ringbuf (remove committed through an atomic operation */
-      int16_t get_index = ringbufindex_get(&n->tx_ringbuf);
+      /* Get and remove packet from ringbuf (remove committed through an atomic operation).
+       * ringbufindex_get returns the index before the one it removes, peek first */
+      int16_t get_index = ringbufindex_peek_get(&n->tx_ringbuf);
       if(get_index != -1) {
+        struct tsch_packet *p = n->tx_array[get_index];
+        ringbufindex_get(&n->tx_ringbuf);
 #ifdef TSCH_CALLBACK_QUEUE_CHANGED
         TSCH_CALLBACK_QUEUE_CHANGED(TSCH_QUEUE_EVENT_SHRINK, n);
 #endif
-        return n->tx_array[get_index];
+        return p;
       } else {
         return NULL;
       }
@@ -369,6 +515,24 @@ tsch_queue_is_empty(const struct tsch_neighbor *n)
   return !tsch_is_locked() && n != NULL && ringbufindex_empty(&n->tx_ringbuf);
 }
 /*---------------------------------------------------------------------------*/
+/* May the packet be sent over the link, as far as the link selector is
+ * concerned? */
+static int
+packet_fits_link(const struct tsch_packet *p, const struct tsch_link *link)
+{
+#if TSCH_WITH_LINK_SELECTOR
+  int packet_attr_slotframe = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
+  int packet_attr_timeslot = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
+  if(packet_attr_slotframe != 0xffff && packet_attr_slotframe != link->slotframe_handle) {
+    return 0;
+  }
+  if(packet_attr_timeslot != 0xffff && packet_attr_timeslot != link->timeslot) {
+    return 0;
+  }
+#endif
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 /* Returns the first packet from a neighbor queue */
 struct tsch_packet *
 tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *link)
@@ -380,16 +544,9 @@ tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *l
       if(get_index != -1 &&
           !(is_shared_link && !tsch_queue_backoff_expired(n))) {    /* If this is a shared link,
                                                                     make sure the backoff has expired */
-#if TSCH_WITH_LINK_SELECTOR
-        int packet_attr_slotframe = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
-        int packet_attr_timeslot = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
-        if(packet_attr_slotframe != 0xffff && packet_attr_slotframe != link->slotframe_handle) {
+        if(!packet_fits_link(n->tx_array[get_index], link)) {
           return NULL;
         }
-        if(packet_attr_timeslot != 0xffff && packet_attr_timeslot != link->timeslot) {
-          return NULL;
-        }
-#endif
         return n->tx_array[get_index];
       }
     }
@@ -397,6 +554,22 @@ tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *l
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+/* Returns the packet queued after the head packet of a neighbor, if it may be
+ * sent over the given link. Backoff is not checked. */
+struct tsch_packet *
+tsch_queue_get_second_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *link)
+{
+  if(!tsch_is_locked() && n != NULL
+     && ringbufindex_elements(&n->tx_ringbuf) > 1) {
+    int16_t get_index = (ringbufindex_peek_get(&n->tx_ringbuf) + 1)
+      & (ringbufindex_size(&n->tx_ringbuf) - 1);
+    if(packet_fits_link(n->tx_array[get_index], link)) {
+      return n->tx_array[get_index];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
 /* Returns the head packet from a neighbor queue (from neighbor address) */
 struct tsch_packet *
 tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *link)
@@ -407,25 +580,44 @@ tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *li
   return NULL;
 }
 /* Returns the head packet of any neighbor queue with zero backoff counter.
- * Writes pointer to the neighbor in *n */
+ * Neighbors are served round-robin. Writes pointer to the neighbor in *n */
 struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
-    struct tsch_neighbor *curr_nbr = list_head(neighbor_list);
-    struct tsch_packet *p = NULL;
-    while(curr_nbr != NULL) {
-      if(!curr_nbr->is_broadcast && curr_nbr->tx_links_count == 0) {
-        /* Only look up for non-broadcast neighbors we do not have a tx link to */
+    int start = rr_next;
+    int wrapped = 0;
+    int index = start;
+    while(1) {
+      struct tsch_neighbor *curr_nbr;
+      struct tsch_packet *p;
+      index = next_ready_index(index);
+      if(index == -1) {
+        if(wrapped || start == 0) {
+          break;
+        }
+        /* Continue from the first neighbor up to where we started */
+        wrapped = 1;
+        index = next_ready_index(0);
+      }
+      if(index == -1 || (wrapped && index >= start)) {
+        break;
+      }
+      curr_nbr = nbr_from_index(index);
+      if(ringbufindex_empty(&curr_nbr->tx_ringbuf)) {
+        /* Stale entry, the queue was emptied since the packet was added */
+        NBR_MAP_CLEAR(queued_map, index);
+      } else if(curr_nbr->tx_links_count == 0) {
         p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
         if(p != NULL) {
           if(n != NULL) {
             *n = curr_nbr;
           }
+          rr_next = (index + 1) % TSCH_QUEUE_MAX_NEIGHBOR_QUEUES;
           return p;
         }
       }
-      curr_nbr = list_item_next(curr_nbr);
+      index++;
     }
   }
   return NULL;
@@ -444,6 +636,7 @@ tsch_queue_backoff_reset(struct tsch_neighbor *n)
 {
   n->backoff_window = 0;
   n->backoff_exponent = TSCH_MAC_MIN_BE;
+  NBR_MAP_CLEAR(backoff_map, index_from_nbr(n));
 }
 /*---------------------------------------------------------------------------*/
 /* Increment backoff exponent, pick a new window */
@@ -459,6 +652,17 @@ tsch_queue_backoff_inc(struct tsch_neighbor *n)
   /* Add one to the window as we will decrement it at the end of the current slot
    * through tsch_queue_update_all_backoff_windows */
   n->backoff_window++;
+  NBR_MAP_SET(backoff_map, index_from_nbr(n));
+}
+/*---------------------------------------------------------------------------*/
+/* Decrement the backoff window of a neighbor, and drop it from backoff_map
+ * once it reaches zero */
+static void
+backoff_window_dec(struct tsch_neighbor *n)
+{
+  if(n->backoff_window != 0 && --n->backoff_window == 0) {
+    NBR_MAP_CLEAR(backoff_map, index_from_nbr(n));
+  }
 }
 /*---------------------------------------------------------------------------*/
 /* Decrement backoff window for all queues directed at dest_addr */
@@ -467,14 +671,42 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
 {
   if(!tsch_is_locked()) {
     int is_broadcast = linkaddr_cmp(dest_addr, &tsch_broadcast_address);
-    struct tsch_neighbor *n = list_head(neighbor_list);
-    while(n != NULL) {
-      if(n->backoff_window != 0 /* Is the queue in backoff state? */
-         && ((n->tx_links_count == 0 && is_broadcast)
-             || (n->tx_links_count > 0 && linkaddr_cmp(dest_addr, &n->addr)))) {
-        n->backoff_window--;
+    if(is_broadcast) {
+      /* All neighbors in backoff that we have no Tx link to */
+      int w;
+      for(w = 0; w < NBR_MAP_WORDS; w++) {
+        uint32_t pending = backoff_map[w];
+        int bit = 0;
+        while(pending != 0) {
+          if(pending & 1) {
+            struct tsch_neighbor *n = nbr_from_index(w * 32 + bit);
+            if(n->tx_links_count == 0) {
+              backoff_window_dec(n);
+            }
+          }
+          pending >>= 1;
+          bit++;
+        }
       }
-      n = list_item_next(n);
+    } else {
+      /* Only the neighbor the link is dedicated to */
+      struct tsch_neighbor *n = tsch_queue_get_nbr(dest_addr);
+      if(n != NULL && n->tx_links_count > 0) {
+        backoff_window_dec(n);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Update the neighbor maps after adding or removing a Tx link to n */
+void
+tsch_queue_update_tx_links(struct tsch_neighbor *n)
+{
+  if(n != NULL) {
+    if(n->tx_links_count > 0) {
+      NBR_MAP_SET(tx_links_map, index_from_nbr(n));
+    } else {
+      NBR_MAP_CLEAR(tx_links_map, index_from_nbr(n));
     }
   }
 }
@@ -486,6 +718,13 @@ tsch_queue_init(void)
   list_init(neighbor_list);
   memb_init(&neighbor_memb);
   memb_init(&packet_memb);
+#if TSCH_QUEUE_HASH_SIZE
+  memset(hash_heads, 0, sizeof(hash_heads));
+#endif /* TSCH_QUEUE_HASH_SIZE */
+  memset(queued_map, 0, sizeof(queued_map));
+  memset(backoff_map, 0, sizeof(backoff_map));
+  memset(tx_links_map, 0, sizeof(tx_links_map));
+  rr_next = 0;
   /* Add virtual EB and the broadcast neighbors */
   n_eb = tsch_queue_add_nbr(&tsch_eb_address);
   n_broadcast = tsch_queue_add_nbr(&tsch_broadcast_address);
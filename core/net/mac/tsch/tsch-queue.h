@@ -76,6 +76,14 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Number of buckets of the index of neighbor queues by MAC address.
+ * Set to 0 to look neighbors up by walking the neighbor list instead. */
+#ifdef TSCH_QUEUE_CONF_HASH_SIZE
+#define TSCH_QUEUE_HASH_SIZE TSCH_QUEUE_CONF_HASH_SIZE
+#else
+#define TSCH_QUEUE_HASH_SIZE TSCH_QUEUE_MAX_NEIGHBOR_QUEUES
+#endif
+
 /* TSCH CSMA-CA parameters, see IEEE 802.15.4e-2012 */
 /* Min backoff exponent */
 #ifdef TSCH_CONF_MAC_MIN_BE
@@ -154,6 +162,22 @@ struct tsch_neighbor {
   struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
   /* Circular buffer of pointers to packet. */
   struct ringbufindex tx_ringbuf;
+#if TSCH_ADAPTIVE_GUARD_TIME
+  /* Timing of the neighbor's frames, used to narrow the Rx guard time.
+   * Offsets are in rtimer ticks, see tsch-adaptive-timesync.c */
+  struct asn_t rx_asn; /* ASN of the last reception */
+  struct asn_t learn_asn; /* ASN of the last drift learning */
+  int32_t rx_offset; /* Offset of the last reception */
+  int32_t learn_offset; /* Offset at the last drift learning */
+  int32_t drift_ppm; /* Drift relative to us, ppm multiplied by 256 */
+  uint8_t rx_count; /* Receptions since the timing was (re)learned, saturates */
+  uint8_t drift_count; /* Drift estimations since then, saturates */
+  uint8_t guard_level; /* Guard time widening level, 0: narrowest */
+  uint8_t guard_ok_count; /* Good predictions since the last level change */
+  uint8_t guard_miss_count; /* Consecutive narrowed windows without a frame */
+  uint8_t last_seqno; /* Sequence number of the last unicast frame */
+  uint8_t rx_pending; /* Is the neighbor known to have more to send us? */
+#endif /* TSCH_ADAPTIVE_GUARD_TIME */
 };
 
 /***** External Variables *****/
@@ -191,10 +215,13 @@ void tsch_queue_free_unused_neighbors(void);
 int tsch_queue_is_empty(const struct tsch_neighbor *n);
 /* Returns the first packet from a neighbor queue */
 struct tsch_packet *tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *link);
+/* Returns the packet queued after the head packet of a neighbor, if it may be
+ * sent over the given link. Backoff is not checked */
+struct tsch_packet *tsch_queue_get_second_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *link);
 /* Returns the head packet from a neighbor queue (from neighbor address) */
 struct tsch_packet *tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *link);
 /* Returns the head packet of any neighbor queue with zero backoff counter.
- * Writes pointer to the neighbor in *n */
+ * Neighbors are served round-robin. Writes pointer to the neighbor in *n */
 struct tsch_packet *tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link);
 /* May the neighbor transmit over a share link? */
 int tsch_queue_backoff_expired(const struct tsch_neighbor *n);
@@ -204,6 +231,8 @@ void tsch_queue_backoff_reset(struct tsch_neighbor *n);
 void tsch_queue_backoff_inc(struct tsch_neighbor *n);
 /* Decrement backoff window for all queues directed at dest_addr */
 void tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr);
+/* Update the neighbor maps after adding or removing a Tx link to n */
+void tsch_queue_update_tx_links(struct tsch_neighbor *n);
 /* Initialize TSCH queue module */
 void tsch_queue_init(void);
 
@@ -89,6 +89,9 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_WITH_ENERGEST
+      memset(&sf->energest, 0, sizeof(sf->energest));
+#endif /* TSCH_WITH_ENERGEST */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -191,6 +194,7 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
       l = memb_alloc(&link_memb);
       if(l == NULL) {
         PRINTF("TSCH-schedule:! add_link memb_alloc failed\n");
+        tsch_release_lock();
       } else {
         static int current_link_handle = 0;
         struct tsch_neighbor *n;
@@ -204,6 +208,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
         l->timeslot = timeslot;
         l->channel_offset = channel_offset;
         l->data = NULL;
+#if TSCH_WITH_ENERGEST
+        memset(&l->energest, 0, sizeof(l->energest));
+#endif /* TSCH_WITH_ENERGEST */
         if(address == NULL) {
           address = &linkaddr_null;
         }
@@ -223,6 +230,7 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
             if(!(l->link_options & LINK_OPTION_SHARED)) {
               n->dedicated_tx_links_count++;
             }
+            tsch_queue_update_tx_links(n);
           }
         }
       }
@@ -270,6 +278,7 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
           if(!(link_options & LINK_OPTION_SHARED)) {
             n->dedicated_tx_links_count--;
           }
+          tsch_queue_update_tx_links(n);
         }
       }
 
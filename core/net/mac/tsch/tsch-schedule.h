@@ -40,6 +40,7 @@
 #include "net/mac/tsch/tsch-private.h"
 #include "net/mac/tsch/tsch-queue.h"
 #include "net/mac/tsch/tsch-slot-operation.h"
+#include "net/mac/tsch/tsch-energest.h"
 #include "net/linkaddr.h"
 
 /******** Configuration *******/
@@ -114,6 +115,10 @@ struct tsch_link {
   enum link_type link_type;
   /* Any other data for upper layers */
   void *data;
+#if TSCH_WITH_ENERGEST
+  /* Radio usage in this link's timeslots */
+  struct tsch_energest_stats energest;
+#endif /* TSCH_WITH_ENERGEST */
 };
 
 struct tsch_slotframe {
@@ -126,6 +131,10 @@ struct tsch_slotframe {
   struct asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_WITH_ENERGEST
+  /* Radio usage in this slotframe's timeslots, including of removed links */
+  struct tsch_energest_stats energest;
+#endif /* TSCH_WITH_ENERGEST */
 };
 
 /********** Functions *********/
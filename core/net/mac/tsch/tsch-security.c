@@ -70,6 +70,30 @@ static aes_key keys[] = {
 };
 #define N_KEYS (sizeof(keys) / sizeof(aes_key))
 
+/* Handles of the keys in the AES-128 key cache, or -1 */
+static int key_handles[N_KEYS];
+static uint8_t keys_cached;
+
+/*---------------------------------------------------------------------------*/
+static void
+tsch_security_set_key(uint8_t key_index)
+{
+  uint8_t i;
+
+  if(!keys_cached) {
+    for(i = 0; i < N_KEYS; i++) {
+      key_handles[i] = aes_128_add_key(keys[i]);
+    }
+    keys_cached = 1;
+  }
+
+  if(key_handles[key_index - 1] >= 0) {
+    ccm_star_use_key(key_handles[key_index - 1]);
+  } else {
+    CCM_STAR.set_key(keys[key_index - 1]);
+  }
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 tsch_security_init_nonce(uint8_t *nonce,
@@ -187,7 +211,7 @@ tsch_security_secure_frame(uint8_t *hdr, uint8_t *outbuf,
     memcpy(outbuf, hdr, a_len + m_len);
   }
 
-  CCM_STAR.set_key(keys[key_index - 1]);
+  tsch_security_set_key(key_index);
 
   CCM_STAR.aead(nonce,
       outbuf + a_len, m_len,
@@ -245,7 +269,7 @@ tsch_security_parse_frame(const uint8_t *hdr, int hdrlen, int datalen,
     m_len = 0;
   }
 
-  CCM_STAR.set_key(keys[key_index - 1]);
+  tsch_security_set_key(key_index);
 
   CCM_STAR.aead(nonce,
        (uint8_t *)hdr + a_len, m_len,
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         A 6P scheduling function that follows the per-neighbor queue
+ *         occupancy. Every TSCH_SF_QUEUE_PERIOD, the length of each neighbor
+ *         queue is sampled into an average. When the average is high, one
+ *         more dedicated Tx cell is negotiated with the neighbor, when it is
+ *         (almost) zero, one is released.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-private.h"
+#include "net/mac/tsch/tsch-queue.h"
+#include "net/mac/tsch/tsch-schedule.h"
+#include "net/mac/tsch/tsch-log.h"
+#include "net/mac/tsch/tsch-sixtop.h"
+#include "net/mac/tsch/tsch-sf-queue.h"
+#include <string.h>
+
+#if TSCH_LOG_LEVEL >= 1
+#define DEBUG DEBUG_PRINT
+#else /* TSCH_LOG_LEVEL */
+#define DEBUG DEBUG_NONE
+#endif /* TSCH_LOG_LEVEL */
+#include "net/ip/uip-debug.h"
+
+#if TSCH_WITH_SIXTOP
+
+/* Weight of the previous average: avg = (7 * avg + sample) / 8 */
+#define AVG_WEIGHT 7
+
+struct sf_nbr {
+  linkaddr_t addr;
+  /* Average queue length, in 1/16 of a packet */
+  uint16_t avg;
+  /* Periods left before the next transaction */
+  uint8_t holdoff;
+  uint8_t in_use;
+};
+
+static struct sf_nbr nbrs[TSCH_SF_QUEUE_MAX_NEIGHBORS];
+static struct ctimer timer;
+
+/*---------------------------------------------------------------------------*/
+static struct sf_nbr *
+nbr_get(const linkaddr_t *addr, int create)
+{
+  int i;
+  struct sf_nbr *free_slot = NULL;
+  for(i = 0; i < TSCH_SF_QUEUE_MAX_NEIGHBORS; i++) {
+    if(nbrs[i].in_use) {
+      if(linkaddr_cmp(&nbrs[i].addr, addr)) {
+        return &nbrs[i];
+      }
+    } else if(free_slot == NULL) {
+      free_slot = &nbrs[i];
+    }
+  }
+  if(create && free_slot != NULL) {
+    memset(free_slot, 0, sizeof(struct sf_nbr));
+    linkaddr_copy(&free_slot->addr, addr);
+    free_slot->in_use = 1;
+    return free_slot;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Our negotiated Tx cells to a neighbor: returns how many, and the first one */
+static int
+tx_cells(struct tsch_slotframe *slotframe, const linkaddr_t *addr, struct tsch_link **first)
+{
+  int count = 0;
+  struct tsch_link *l;
+  *first = NULL;
+  for(l = tsch_schedule_get_link_next(slotframe, NULL); l != NULL;
+      l = tsch_schedule_get_link_next(slotframe, l)) {
+    if(l->link_options == LINK_OPTION_TX && linkaddr_cmp(&l->addr, addr)) {
+      if(*first == NULL) {
+        *first = l;
+      }
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_cell(struct sf_nbr *n, struct tsch_slotframe *slotframe)
+{
+  struct tsch_sixtop_cell candidates[TSCH_SF_QUEUE_NUM_CANDIDATES];
+  int num = 0;
+  int tries;
+
+  /* Offer random timeslots that are free on our side */
+  for(tries = 0; tries < 4 * TSCH_SF_QUEUE_NUM_CANDIDATES
+      && num < TSCH_SF_QUEUE_NUM_CANDIDATES; tries++) {
+    uint16_t timeslot = random_rand() % TSCH_SF_QUEUE_SLOTFRAME_LENGTH;
+    int i;
+    if(tsch_schedule_get_link_by_timeslot(slotframe, timeslot) != NULL) {
+      continue;
+    }
+    for(i = 0; i < num && candidates[i].timeslot != timeslot; i++);
+    if(i == num) {
+      candidates[num].timeslot = timeslot;
+      candidates[num].channel_offset = tsch_hopping_sequence_length.val > 0
+        ? random_rand() % tsch_hopping_sequence_length.val : 0;
+      num++;
+    }
+  }
+
+  if(num > 0 && tsch_sixtop_request_add(TSCH_SF_QUEUE_SFID, &n->addr, 0,
+        TSCH_SIXTOP_CELL_OPTION_TX, 1, candidates, num)) {
+    PRINTF("TSCH-SF-queue: add cell to %u, queue avg %u/16\n",
+           TSCH_LOG_ID_FROM_LINKADDR(&n->addr), n->avg);
+    n->holdoff = TSCH_SF_QUEUE_HOLDOFF;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+delete_cell(struct sf_nbr *n, struct tsch_link *l)
+{
+  struct tsch_sixtop_cell cell;
+  cell.timeslot = l->timeslot;
+  cell.channel_offset = l->channel_offset;
+  if(tsch_sixtop_request_delete(TSCH_SF_QUEUE_SFID, &n->addr, 0,
+        TSCH_SIXTOP_CELL_OPTION_TX, &cell, 1)) {
+    PRINTF("TSCH-SF-queue: delete cell to %u, queue avg %u/16\n",
+           TSCH_LOG_ID_FROM_LINKADDR(&n->addr), n->avg);
+    n->holdoff = TSCH_SF_QUEUE_HOLDOFF;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+periodic(void *ptr)
+{
+  struct tsch_slotframe *slotframe = tsch_schedule_get_slotframe_by_handle(TSCH_SF_QUEUE_SLOTFRAME_HANDLE);
+  struct tsch_neighbor *tn;
+  int i;
+
+  ctimer_reset(&timer);
+  if(slotframe == NULL || !tsch_is_associated) {
+    return;
+  }
+
+  /* Start tracking new unicast neighbors */
+  for(tn = tsch_queue_get_nbr_next(NULL); tn != NULL; tn = tsch_queue_get_nbr_next(tn)) {
+    if(!tn->is_broadcast && !tsch_queue_is_empty(tn)) {
+      nbr_get(&tn->addr, 1);
+    }
+  }
+
+  for(i = 0; i < TSCH_SF_QUEUE_MAX_NEIGHBORS; i++) {
+    struct sf_nbr *n = &nbrs[i];
+    struct tsch_link *first;
+    int queue_len = 0;
+    int num_cells;
+
+    if(!n->in_use) {
+      continue;
+    }
+    tn = tsch_queue_get_nbr(&n->addr);
+    if(tn != NULL) {
+      queue_len = ringbufindex_elements(&tn->tx_ringbuf);
+    }
+    n->avg = (AVG_WEIGHT * n->avg + (queue_len << 4)) / (AVG_WEIGHT + 1);
+    num_cells = tx_cells(slotframe, &n->addr, &first);
+
+    if(n->holdoff > 0) {
+      n->holdoff--;
+    } else if(!tsch_sixtop_is_busy(&n->addr)) {
+      if(n->avg >= TSCH_SF_QUEUE_ADD_THRESHOLD && num_cells < TSCH_SF_QUEUE_MAX_CELLS) {
+        add_cell(n, slotframe);
+      } else if(n->avg < TSCH_SF_QUEUE_DELETE_THRESHOLD && num_cells > 0) {
+        delete_cell(n, first);
+      } else if(num_cells == 0 && n->avg == 0 && tn == NULL) {
+        /* Nothing left to do with this neighbor */
+        n->in_use = 0;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a Tx cell on our side only */
+static void
+remove_local_cell(const linkaddr_t *peer, const struct tsch_sixtop_cell *cell)
+{
+  struct tsch_slotframe *slotframe = tsch_schedule_get_slotframe_by_handle(TSCH_SF_QUEUE_SLOTFRAME_HANDLE);
+  struct tsch_link *l;
+  if(slotframe != NULL
+     && (l = tsch_schedule_get_link_by_timeslot(slotframe, cell->timeslot)) != NULL
+     && l->link_options == LINK_OPTION_TX && linkaddr_cmp(&l->addr, peer)) {
+    tsch_schedule_remove_link(slotframe, l);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+response(const linkaddr_t *peer, uint8_t cmd, uint8_t rc,
+    const struct tsch_sixtop_cell *cells, uint8_t num_cells, uint16_t count)
+{
+  int i;
+  PRINTF("TSCH-SF-queue: cmd %u with %u: rc %u, %u cells\n",
+         cmd, TSCH_LOG_ID_FROM_LINKADDR(peer), rc, num_cells);
+  switch(rc) {
+    case TSCH_SIXTOP_RC_ERR_SEQNUM:
+      /* Schedules are out of sync (e.g. the peer rebooted): start over */
+      tsch_sixtop_request_clear(TSCH_SF_QUEUE_SFID, peer, 0);
+      break;
+    case TSCH_SIXTOP_RC_TIMEOUT:
+    case TSCH_SIXTOP_RC_ERR_CELLLIST:
+      /* The peer is gone or does not know the cell, release it anyway */
+      if(cmd == TSCH_SIXTOP_CMD_DELETE) {
+        for(i = 0; i < num_cells; i++) {
+          remove_local_cell(peer, &cells[i]);
+        }
+      }
+      break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+  if(tsch_schedule_get_slotframe_by_handle(TSCH_SF_QUEUE_SLOTFRAME_HANDLE) == NULL) {
+    tsch_schedule_add_slotframe(TSCH_SF_QUEUE_SLOTFRAME_HANDLE, TSCH_SF_QUEUE_SLOTFRAME_LENGTH);
+  }
+  memset(nbrs, 0, sizeof(nbrs));
+  ctimer_set(&timer, TSCH_SF_QUEUE_PERIOD, periodic, NULL);
+}
+/*---------------------------------------------------------------------------*/
+const struct tsch_sixtop_sf tsch_sf_queue = {
+  TSCH_SF_QUEUE_SFID,
+  TSCH_SF_QUEUE_SLOTFRAME_HANDLE,
+  0,
+  init,
+  NULL,
+  response,
+};
+/*---------------------------------------------------------------------------*/
+
+#endif /* TSCH_WITH_SIXTOP */
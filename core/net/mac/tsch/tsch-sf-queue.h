@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         A 6P scheduling function that follows the load: it negotiates
+ *         dedicated Tx cells to a neighbor while packets pile up in the
+ *         neighbor's TSCH queue, and gives them back when the queue stays
+ *         empty
+ */
+
+#ifndef __TSCH_SF_QUEUE_H__
+#define __TSCH_SF_QUEUE_H__
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch-sixtop.h"
+
+/******** Configuration *******/
+
+/* SF identifier, by default from the range for experimental use */
+#ifdef TSCH_SF_QUEUE_CONF_SFID
+#define TSCH_SF_QUEUE_SFID TSCH_SF_QUEUE_CONF_SFID
+#else
+#define TSCH_SF_QUEUE_SFID 0xf0
+#endif
+
+/* Handle and length of the slotframe holding the negotiated cells.
+ * Must be the same on all nodes. */
+#ifdef TSCH_SF_QUEUE_CONF_SLOTFRAME_HANDLE
+#define TSCH_SF_QUEUE_SLOTFRAME_HANDLE TSCH_SF_QUEUE_CONF_SLOTFRAME_HANDLE
+#else
+#define TSCH_SF_QUEUE_SLOTFRAME_HANDLE 3
+#endif
+
+#ifdef TSCH_SF_QUEUE_CONF_SLOTFRAME_LENGTH
+#define TSCH_SF_QUEUE_SLOTFRAME_LENGTH TSCH_SF_QUEUE_CONF_SLOTFRAME_LENGTH
+#else
+#define TSCH_SF_QUEUE_SLOTFRAME_LENGTH 11
+#endif
+
+/* How often queues are sampled */
+#ifdef TSCH_SF_QUEUE_CONF_PERIOD
+#define TSCH_SF_QUEUE_PERIOD TSCH_SF_QUEUE_CONF_PERIOD
+#else
+#define TSCH_SF_QUEUE_PERIOD CLOCK_SECOND
+#endif
+
+/* Add a cell when the average queue length reaches this, and delete one
+ * when it falls below that. Both in 1/16 of a packet. */
+#ifdef TSCH_SF_QUEUE_CONF_ADD_THRESHOLD
+#define TSCH_SF_QUEUE_ADD_THRESHOLD TSCH_SF_QUEUE_CONF_ADD_THRESHOLD
+#else
+#define TSCH_SF_QUEUE_ADD_THRESHOLD (2 * 16)
+#endif
+
+#ifdef TSCH_SF_QUEUE_CONF_DELETE_THRESHOLD
+#define TSCH_SF_QUEUE_DELETE_THRESHOLD TSCH_SF_QUEUE_CONF_DELETE_THRESHOLD
+#else
+#define TSCH_SF_QUEUE_DELETE_THRESHOLD 2
+#endif
+
+/* Max number of negotiated Tx cells per neighbor */
+#ifdef TSCH_SF_QUEUE_CONF_MAX_CELLS
+#define TSCH_SF_QUEUE_MAX_CELLS TSCH_SF_QUEUE_CONF_MAX_CELLS
+#else
+#define TSCH_SF_QUEUE_MAX_CELLS 4
+#endif
+
+/* Number of candidate cells offered in an ADD request */
+#ifdef TSCH_SF_QUEUE_CONF_NUM_CANDIDATES
+#define TSCH_SF_QUEUE_NUM_CANDIDATES TSCH_SF_QUEUE_CONF_NUM_CANDIDATES
+#else
+#define TSCH_SF_QUEUE_NUM_CANDIDATES MIN(3, TSCH_SIXTOP_MAX_CELLS)
+#endif
+
+/* Number of periods to wait after a transaction before the next one with
+ * the same neighbor, to let the queue react to the new schedule */
+#ifdef TSCH_SF_QUEUE_CONF_HOLDOFF
+#define TSCH_SF_QUEUE_HOLDOFF TSCH_SF_QUEUE_CONF_HOLDOFF
+#else
+#define TSCH_SF_QUEUE_HOLDOFF 8
+#endif
+
+/* Max number of neighbors tracked */
+#ifdef TSCH_SF_QUEUE_CONF_MAX_NEIGHBORS
+#define TSCH_SF_QUEUE_MAX_NEIGHBORS TSCH_SF_QUEUE_CONF_MAX_NEIGHBORS
+#else
+#define TSCH_SF_QUEUE_MAX_NEIGHBORS NBR_TABLE_CONF_MAX_NEIGHBORS
+#endif
+
+/***** External Variables *****/
+
+/* Register with tsch_sixtop_add_sf(&tsch_sf_queue) on every node */
+extern const struct tsch_sixtop_sf tsch_sf_queue;
+
+#endif /* __TSCH_SF_QUEUE_H__ */
@@ -0,0 +1,1081 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         6top protocol (6P, RFC 8480). 6P messages are carried in the IETF
+ *         payload IE of data frames. Only 2-step transactions are
+ *         supported: the responder applies the schedule change once its
+ *         response is acknowledged, the initiator when it receives it.
+ */
+
+#include "contiki.h"
+#include "lib/list.h"
+#include "lib/memb.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "net/mac/frame802154e-ie.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-private.h"
+#include "net/mac/tsch/tsch-schedule.h"
+#include "net/mac/tsch/tsch-log.h"
+#include "net/mac/tsch/tsch-sixtop.h"
+#include <string.h>
+
+#if TSCH_LOG_LEVEL >= 1
+#define DEBUG DEBUG_PRINT
+#else /* TSCH_LOG_LEVEL */
+#define DEBUG DEBUG_NONE
+#endif /* TSCH_LOG_LEVEL */
+#include "net/ip/uip-debug.h"
+
+#if TSCH_WITH_SIXTOP
+
+/* 6P header: version (b0-3) and type (b4-5), code, SFID, sequence number */
+#define SIXP_VERSION            0
+#define SIXP_TYPE_REQUEST       0
+#define SIXP_TYPE_RESPONSE      1
+#define SIXP_TYPE_CONFIRMATION  2
+#define SIXP_HDR_LEN            4
+#define SIXP_CELL_LEN           4
+/* Longest message we build: a RELOCATE request */
+#define SIXP_MAX_LEN (SIXP_HDR_LEN + 4 + 2 * TSCH_SIXTOP_MAX_CELLS * SIXP_CELL_LEN)
+
+#define CELL_OPTIONS_MASK (TSCH_SIXTOP_CELL_OPTION_TX | TSCH_SIXTOP_CELL_OPTION_RX \
+    | TSCH_SIXTOP_CELL_OPTION_SHARED)
+
+#define WRITE16(buf, val) \
+  do { ((uint8_t *)(buf))[0] = (val) & 0xff; \
+       ((uint8_t *)(buf))[1] = ((val) >> 8) & 0xff; } while(0)
+
+#define READ16(buf) \
+  ((uint16_t)((const uint8_t *)(buf))[0] | (uint16_t)((const uint8_t *)(buf))[1] << 8)
+
+/* Sequence number state per neighbor */
+struct sixtop_nbr {
+  struct sixtop_nbr *next;
+  linkaddr_t addr;
+  uint8_t seqnum;
+};
+
+enum transaction_state {
+  /* Initiator: request in the TSCH queue */
+  STATE_REQUEST_QUEUED,
+  /* Initiator: request sent, waiting for the response */
+  STATE_WAIT_RESPONSE,
+  /* Responder: response in the TSCH queue */
+  STATE_RESPONSE_QUEUED,
+  /* Over, only waiting for the MAC callback of our request */
+  STATE_DONE,
+};
+
+struct transaction {
+  struct transaction *next;
+  linkaddr_t peer;
+  const struct tsch_sixtop_sf *sf;
+  struct ctimer timer;
+  enum transaction_state state;
+  uint8_t cmd;
+  uint8_t seqnum;
+  /* Responder: the return code we sent */
+  uint8_t rc;
+  /* Cell options of the cells on this node's side */
+  uint8_t cell_options;
+  /* Initiator: number of cells asked for in an ADD */
+  uint8_t num_cells;
+  /* Schedule change: cells to remove, then cells to add. The initiator
+   * keeps the cells of its DELETE or RELOCATE request in 'del', and the
+   * candidates of its ADD or RELOCATE request in 'add' */
+  uint8_t num_del;
+  uint8_t num_add;
+  struct tsch_sixtop_cell del[TSCH_SIXTOP_MAX_CELLS];
+  struct tsch_sixtop_cell add[TSCH_SIXTOP_MAX_CELLS];
+};
+
+static const struct tsch_sixtop_sf *sfs[TSCH_SIXTOP_MAX_SFS];
+
+MEMB(nbr_memb, struct sixtop_nbr, TSCH_SIXTOP_MAX_NEIGHBORS);
+LIST(nbr_list);
+MEMB(transaction_memb, struct transaction, TSCH_SIXTOP_MAX_TRANSACTIONS);
+LIST(transaction_list);
+
+/* The message being built */
+static uint8_t msg[SIXP_MAX_LEN];
+static uint8_t msg_len;
+
+/*---------------------------------------------------------------------------*/
+/* Get the 6P state of a neighbor, most recently used first */
+static struct sixtop_nbr *
+nbr_get(const linkaddr_t *addr, int create)
+{
+  struct sixtop_nbr *n;
+  for(n = list_head(nbr_list); n != NULL; n = list_item_next(n)) {
+    if(linkaddr_cmp(&n->addr, addr)) {
+      list_remove(nbr_list, n);
+      list_push(nbr_list, n);
+      return n;
+    }
+  }
+  if(!create) {
+    return NULL;
+  }
+  n = memb_alloc(&nbr_memb);
+  if(n == NULL) {
+    /* Forget the least recently used neighbor */
+    n = list_chop(nbr_list);
+  }
+  linkaddr_copy(&n->addr, addr);
+  n->seqnum = 0;
+  list_push(nbr_list, n);
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+seqnum_get(const linkaddr_t *addr)
+{
+  struct sixtop_nbr *n = nbr_get(addr, 0);
+  return n != NULL ? n->seqnum : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Move on to the next sequence number after a transaction. 0 is only used
+ * after a reset (boot or CLEAR) */
+static void
+seqnum_next(const linkaddr_t *addr)
+{
+  struct sixtop_nbr *n = nbr_get(addr, 1);
+  n->seqnum = n->seqnum == 0xff ? 1 : n->seqnum + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+seqnum_reset(const linkaddr_t *addr)
+{
+  struct sixtop_nbr *n = nbr_get(addr, 0);
+  if(n != NULL) {
+    n->seqnum = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The ongoing transaction with a neighbor, if any */
+static struct transaction *
+transaction_get(const linkaddr_t *peer)
+{
+  struct transaction *t;
+  for(t = list_head(transaction_list); t != NULL; t = list_item_next(t)) {
+    if(t->state != STATE_DONE && linkaddr_cmp(&t->peer, peer)) {
+      return t;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Check that a MAC callback parameter is still one of our transactions */
+static int
+transaction_is_valid(struct transaction *t)
+{
+  struct transaction *curr;
+  for(curr = list_head(transaction_list); curr != NULL; curr = list_item_next(curr)) {
+    if(curr == t) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+transaction_free(struct transaction *t)
+{
+  ctimer_stop(&t->timer);
+  list_remove(transaction_list, t);
+  memb_free(&transaction_memb, t);
+}
+/*---------------------------------------------------------------------------*/
+/* Our TX cells are the peer's RX cells */
+static uint8_t
+reverse_cell_options(uint8_t cell_options)
+{
+  uint8_t ret = cell_options & TSCH_SIXTOP_CELL_OPTION_SHARED;
+  if(cell_options & TSCH_SIXTOP_CELL_OPTION_TX) {
+    ret |= TSCH_SIXTOP_CELL_OPTION_RX;
+  }
+  if(cell_options & TSCH_SIXTOP_CELL_OPTION_RX) {
+    ret |= TSCH_SIXTOP_CELL_OPTION_TX;
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+static int
+link_matches(const struct tsch_link *l, const linkaddr_t *peer, uint8_t cell_options)
+{
+  return linkaddr_cmp(&l->addr, peer)
+    && (l->link_options & CELL_OPTIONS_MASK) == cell_options;
+}
+/*---------------------------------------------------------------------------*/
+/* The link installed for a cell with a peer, if any */
+static struct tsch_link *
+cell_get_link(struct tsch_slotframe *slotframe, const struct tsch_sixtop_cell *cell,
+    const linkaddr_t *peer, uint8_t cell_options)
+{
+  struct tsch_link *l = tsch_schedule_get_link_by_timeslot(slotframe, cell->timeslot);
+  if(l != NULL && l->channel_offset == cell->channel_offset
+     && link_matches(l, peer, cell_options)) {
+    return l;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Are all cells part of a list? */
+static int
+cells_in_list(const struct tsch_sixtop_cell *cells, uint8_t num_cells,
+    const struct tsch_sixtop_cell *list, uint8_t num_list)
+{
+  int i, j;
+  for(i = 0; i < num_cells; i++) {
+    for(j = 0; j < num_list; j++) {
+      if(cells[i].timeslot == list[j].timeslot
+         && cells[i].channel_offset == list[j].channel_offset) {
+        break;
+      }
+    }
+    if(j == num_list) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Can a schedule change be applied as a whole? Every cell to add needs a
+ * timeslot of its own that is free, or freed by the cells to remove. We
+ * never overwrite a link we have with someone else. */
+static int
+cells_are_free(struct tsch_slotframe *slotframe, const linkaddr_t *peer, uint8_t cell_options,
+    const struct tsch_sixtop_cell *del, uint8_t num_del,
+    const struct tsch_sixtop_cell *add, uint8_t num_add)
+{
+  int i, j;
+  for(i = 0; i < num_add; i++) {
+    struct tsch_link *l = tsch_schedule_get_link_by_timeslot(slotframe, add[i].timeslot);
+    if(l != NULL) {
+      for(j = 0; j < num_del; j++) {
+        if(del[j].timeslot == add[i].timeslot
+           && cell_get_link(slotframe, &del[j], peer, cell_options) == l) {
+          break;
+        }
+      }
+      if(j == num_del) {
+        PRINTF("TSCH-6P:! timeslot %u already in use\n", add[i].timeslot);
+        return 0;
+      }
+    }
+    for(j = 0; j < i; j++) {
+      if(add[j].timeslot == add[i].timeslot) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Apply a schedule change: remove then add cells. Returns 0, leaving the
+ * schedule unchanged, if a cell to add is in use */
+static int
+apply_cells(struct tsch_slotframe *slotframe, const linkaddr_t *peer, uint8_t cell_options,
+    const struct tsch_sixtop_cell *del, uint8_t num_del,
+    const struct tsch_sixtop_cell *add, uint8_t num_add)
+{
+  int i;
+  int ret = 1;
+  if(!cells_are_free(slotframe, peer, cell_options, del, num_del, add, num_add)) {
+    return 0;
+  }
+  for(i = 0; i < num_del; i++) {
+    struct tsch_link *l = cell_get_link(slotframe, &del[i], peer, cell_options);
+    if(l != NULL) {
+      tsch_schedule_remove_link(slotframe, l);
+    }
+  }
+  for(i = 0; i < num_add; i++) {
+    if(tsch_schedule_add_link(slotframe, cell_options, LINK_TYPE_NORMAL, peer,
+        add[i].timeslot, add[i].channel_offset) == NULL) {
+      PRINTF("TSCH-6P:! cannot add link at timeslot %u\n", add[i].timeslot);
+      ret = 0;
+    }
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove all cells with a peer */
+static void
+clear_cells(struct tsch_slotframe *slotframe, const linkaddr_t *peer)
+{
+  struct tsch_link *l = tsch_schedule_get_link_next(slotframe, NULL);
+  while(l != NULL) {
+    struct tsch_link *next = tsch_schedule_get_link_next(slotframe, l);
+    if(linkaddr_cmp(&l->addr, peer)) {
+      tsch_schedule_remove_link(slotframe, l);
+    }
+    l = next;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_cells(const uint8_t *buf, int len, struct tsch_sixtop_cell *cells, int max)
+{
+  int i;
+  int num = len / SIXP_CELL_LEN;
+  if(num > max) {
+    num = max;
+  }
+  for(i = 0; i < num; i++) {
+    cells[i].timeslot = READ16(buf + i * SIXP_CELL_LEN);
+    cells[i].channel_offset = READ16(buf + i * SIXP_CELL_LEN + 2);
+  }
+  return num;
+}
+/*---------------------------------------------------------------------------*/
+static void
+msg_init(uint8_t type, uint8_t code, uint8_t sfid, uint8_t seqnum)
+{
+  msg[0] = SIXP_VERSION | (type << 4);
+  msg[1] = code;
+  msg[2] = sfid;
+  msg[3] = seqnum;
+  msg_len = SIXP_HDR_LEN;
+}
+/*---------------------------------------------------------------------------*/
+static void
+msg_put8(uint8_t val)
+{
+  msg[msg_len++] = val;
+}
+/*---------------------------------------------------------------------------*/
+static void
+msg_put16(uint16_t val)
+{
+  WRITE16(msg + msg_len, val);
+  msg_len += 2;
+}
+/*---------------------------------------------------------------------------*/
+static void
+msg_put_cells(const struct tsch_sixtop_cell *cells, uint8_t num)
+{
+  int i;
+  for(i = 0; i < num; i++) {
+    msg_put16(cells[i].timeslot);
+    msg_put16(cells[i].channel_offset);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Send the message to a peer, as a data frame with IEs and no payload */
+static void
+msg_send(const linkaddr_t *peer, mac_callback_t sent, void *ptr)
+{
+  struct ieee802154_ies ies;
+  uint8_t *buf;
+  int len;
+  int ret;
+
+  packetbuf_clear();
+  buf = packetbuf_dataptr();
+  memset(&ies, 0, sizeof(ies));
+  ies.ie_sixtop = msg;
+  ies.ie_sixtop_len = msg_len;
+  len = frame80215e_create_ie_header_list_termination_1(buf, PACKETBUF_SIZE, &ies);
+  if(len < 0 || (ret = frame80215e_create_ie_sixtop(buf + len, PACKETBUF_SIZE - len, &ies)) < 0) {
+    mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 0);
+    return;
+  }
+  len += ret;
+  packetbuf_set_datalen(len);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, peer);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_IE_LIST_PRESENT, 1);
+  PRINTF("TSCH-6P: send type %u code %u seqnum %u to %u\n",
+         msg[0] >> 4, msg[1], msg[3], TSCH_LOG_ID_FROM_LINKADDR(peer));
+  NETSTACK_MAC.send(sent, ptr);
+}
+/*---------------------------------------------------------------------------*/
+/* Initiator: end of a transaction, notify the SF */
+static void
+transaction_finish(struct transaction *t, uint8_t rc,
+    const struct tsch_sixtop_cell *cells, uint8_t num_cells, uint16_t count)
+{
+  const struct tsch_sixtop_sf *sf = t->sf;
+  uint8_t cmd = t->cmd;
+  linkaddr_t peer;
+
+  PRINTF("TSCH-6P: transaction %u with %u done, rc %u\n",
+         cmd, TSCH_LOG_ID_FROM_LINKADDR(&t->peer), rc);
+  linkaddr_copy(&peer, &t->peer);
+  ctimer_stop(&t->timer);
+  if(t->state == STATE_REQUEST_QUEUED) {
+    /* The MAC callback of the request will free it */
+    t->state = STATE_DONE;
+  } else {
+    transaction_free(t);
+  }
+  if(sf->response != NULL) {
+    sf->response(&peer, cmd, rc, cells, num_cells, count);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Initiator: the request could not be sent or was not answered */
+static void
+transaction_fail(struct transaction *t)
+{
+  if(t->cmd == TSCH_SIXTOP_CMD_CLEAR) {
+    /* CLEAR takes effect whatever the outcome */
+    struct tsch_slotframe *slotframe = tsch_schedule_get_slotframe_by_handle(t->sf->slotframe_handle);
+    if(slotframe != NULL) {
+      clear_cells(slotframe, &t->peer);
+    }
+    seqnum_reset(&t->peer);
+  }
+  transaction_finish(t, TSCH_SIXTOP_RC_TIMEOUT, t->del, t->num_del, 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+request_timeout(void *ptr)
+{
+  struct transaction *t = ptr;
+  PRINTF("TSCH-6P:! timeout with %u\n", TSCH_LOG_ID_FROM_LINKADDR(&t->peer));
+  transaction_fail(t);
+}
+/*---------------------------------------------------------------------------*/
+static void
+request_sent(void *ptr, int status, int transmissions)
+{
+  struct transaction *t = ptr;
+  if(!transaction_is_valid(t)) {
+    return;
+  }
+  if(t->state == STATE_DONE) {
+    transaction_free(t);
+  } else if(t->state == STATE_REQUEST_QUEUED) {
+    t->state = STATE_WAIT_RESPONSE;
+    if(status != MAC_TX_OK) {
+      PRINTF("TSCH-6P:! request to %u not sent, status %u\n",
+             TSCH_LOG_ID_FROM_LINKADDR(&t->peer), status);
+      transaction_fail(t);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+response_sent(void *ptr, int status, int transmissions)
+{
+  struct transaction *t = ptr;
+  struct tsch_slotframe *slotframe;
+
+  if(!transaction_is_valid(t) || t->state != STATE_RESPONSE_QUEUED) {
+    return;
+  }
+  slotframe = tsch_schedule_get_slotframe_by_handle(t->sf->slotframe_handle);
+  if(status == MAC_TX_OK && slotframe != NULL
+     && (t->rc == TSCH_SIXTOP_RC_SUCCESS || t->rc == TSCH_SIXTOP_RC_EOL)) {
+    if(t->cmd == TSCH_SIXTOP_CMD_CLEAR) {
+      clear_cells(slotframe, &t->peer);
+      seqnum_reset(&t->peer);
+    } else {
+      if(!apply_cells(slotframe, &t->peer, t->cell_options,
+          t->del, t->num_del, t->add, t->num_add)) {
+        PRINTF("TSCH-6P:! schedule with %u changed since the request\n",
+               TSCH_LOG_ID_FROM_LINKADDR(&t->peer));
+      }
+      seqnum_next(&t->peer);
+    }
+  } else {
+    PRINTF("TSCH-6P:! response to %u not applied, status %u\n",
+           TSCH_LOG_ID_FROM_LINKADDR(&t->peer), status);
+  }
+  transaction_free(t);
+}
+/*---------------------------------------------------------------------------*/
+/* Default responder policy: the first candidates that are free on our side */
+static int
+select_free_cells(struct tsch_slotframe *slotframe, uint8_t num_cells,
+    const struct tsch_sixtop_cell *candidates, uint8_t num_candidates,
+    struct tsch_sixtop_cell *selected)
+{
+  int i, j;
+  int num = 0;
+  for(i = 0; i < num_candidates && num < num_cells; i++) {
+    if(tsch_schedule_get_link_by_timeslot(slotframe, candidates[i].timeslot) != NULL) {
+      continue;
+    }
+    for(j = 0; j < num; j++) {
+      if(selected[j].timeslot == candidates[i].timeslot) {
+        break;
+      }
+    }
+    if(j == num) {
+      selected[num++] = candidates[i];
+    }
+  }
+  return num;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+select_cells(struct transaction *t, struct tsch_slotframe *slotframe, uint16_t metadata,
+    uint8_t num_cells, const struct tsch_sixtop_cell *candidates, uint8_t num_candidates)
+{
+  int num;
+  if(t->sf->select_cells != NULL) {
+    num = t->sf->select_cells(&t->peer, metadata, t->cell_options, num_cells,
+        candidates, num_candidates, t->add);
+  } else {
+    num = select_free_cells(slotframe, num_cells, candidates, num_candidates, t->add);
+  }
+  if(num < 0) {
+    num = 0;
+  } else if(num > num_cells) {
+    num = num_cells;
+  }
+  t->num_add = num;
+  return num;
+}
+/*---------------------------------------------------------------------------*/
+/* Responder: check that the cells to delete or relocate are all installed */
+static int
+check_cells(struct transaction *t, struct tsch_slotframe *slotframe,
+    const struct tsch_sixtop_cell *cells, uint8_t num_cells)
+{
+  int i;
+  for(i = 0; i < num_cells; i++) {
+    if(cell_get_link(slotframe, &cells[i], &t->peer, t->cell_options) == NULL) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Responder: process a request. Fills in the schedule change of the
+ * transaction and the body of the response, returns the return code */
+static uint8_t
+request_process(struct transaction *t, struct tsch_slotframe *slotframe,
+    const uint8_t *body, int body_len)
+{
+  struct tsch_sixtop_cell cells[TSCH_SIXTOP_MAX_CELLS];
+  uint16_t metadata;
+  uint8_t num_cells;
+  int num_list;
+  struct tsch_link *l;
+  int i;
+
+  if(body_len < 2) {
+    return TSCH_SIXTOP_RC_ERR;
+  }
+  metadata = READ16(body);
+  if(t->cmd == TSCH_SIXTOP_CMD_CLEAR) {
+    return TSCH_SIXTOP_RC_SUCCESS;
+  }
+  if(body_len < 3) {
+    return TSCH_SIXTOP_RC_ERR;
+  }
+  t->cell_options = reverse_cell_options(body[2]);
+
+  switch(t->cmd) {
+    case TSCH_SIXTOP_CMD_ADD:
+    case TSCH_SIXTOP_CMD_DELETE:
+      if(body_len < 4 || (body_len - 4) % SIXP_CELL_LEN != 0) {
+        return TSCH_SIXTOP_RC_ERR;
+      }
+      num_cells = body[3];
+      num_list = read_cells(body + 4, body_len - 4, cells, TSCH_SIXTOP_MAX_CELLS);
+      if(num_cells > TSCH_SIXTOP_MAX_CELLS || num_list < num_cells) {
+        return TSCH_SIXTOP_RC_ERR_CELLLIST;
+      }
+      if(t->cmd == TSCH_SIXTOP_CMD_ADD) {
+        select_cells(t, slotframe, metadata, num_cells, cells, num_list);
+        if(!cells_in_list(t->add, t->num_add, cells, num_list)
+           || !cells_are_free(slotframe, &t->peer, t->cell_options,
+               NULL, 0, t->add, t->num_add)) {
+          t->num_add = 0;
+          return TSCH_SIXTOP_RC_ERR;
+        }
+        msg_put_cells(t->add, t->num_add);
+      } else {
+        /* Delete the first 'num_cells' cells of the list we have */
+        for(i = 0; i < num_list && t->num_del < num_cells; i++) {
+          if(cell_get_link(slotframe, &cells[i], &t->peer, t->cell_options) != NULL) {
+            t->del[t->num_del++] = cells[i];
+          }
+        }
+        if(t->num_del < num_cells) {
+          t->num_del = 0;
+          return TSCH_SIXTOP_RC_ERR_CELLLIST;
+        }
+        msg_put_cells(t->del, t->num_del);
+      }
+      return TSCH_SIXTOP_RC_SUCCESS;
+
+    case TSCH_SIXTOP_CMD_RELOCATE:
+      if(body_len < 4 || (body_len - 4) % SIXP_CELL_LEN != 0) {
+        return TSCH_SIXTOP_RC_ERR;
+      }
+      num_cells = body[3];
+      if(num_cells > TSCH_SIXTOP_MAX_CELLS
+         || body_len - 4 < num_cells * SIXP_CELL_LEN) {
+        return TSCH_SIXTOP_RC_ERR_CELLLIST;
+      }
+      read_cells(body + 4, num_cells * SIXP_CELL_LEN, t->del, num_cells);
+      if(!check_cells(t, slotframe, t->del, num_cells)) {
+        return TSCH_SIXTOP_RC_ERR_CELLLIST;
+      }
+      num_list = read_cells(body + 4 + num_cells * SIXP_CELL_LEN,
+          body_len - 4 - num_cells * SIXP_CELL_LEN, cells, TSCH_SIXTOP_MAX_CELLS);
+      /* The first relocated cells move to the selected ones */
+      t->num_del = select_cells(t, slotframe, metadata, num_cells, cells, num_list);
+      if(!cells_in_list(t->add, t->num_add, cells, num_list)
+         || !cells_are_free(slotframe, &t->peer, t->cell_options,
+             t->del, t->num_del, t->add, t->num_add)) {
+        t->num_del = t->num_add = 0;
+        return TSCH_SIXTOP_RC_ERR;
+      }
+      msg_put_cells(t->add, t->num_add);
+      return TSCH_SIXTOP_RC_SUCCESS;
+
+    case TSCH_SIXTOP_CMD_COUNT:
+      num_list = 0;
+      for(l = tsch_schedule_get_link_next(slotframe, NULL); l != NULL;
+          l = tsch_schedule_get_link_next(slotframe, l)) {
+        if(link_matches(l, &t->peer, t->cell_options)) {
+          num_list++;
+        }
+      }
+      msg_put16(num_list);
+      return TSCH_SIXTOP_RC_SUCCESS;
+
+    case TSCH_SIXTOP_CMD_LIST: {
+      uint16_t offset;
+      uint16_t max_cells;
+      uint16_t index = 0;
+      if(body_len < 8) {
+        return TSCH_SIXTOP_RC_ERR;
+      }
+      offset = READ16(body + 4);
+      max_cells = READ16(body + 6);
+      if(max_cells > TSCH_SIXTOP_MAX_CELLS) {
+        max_cells = TSCH_SIXTOP_MAX_CELLS;
+      }
+      num_list = 0;
+      for(l = tsch_schedule_get_link_next(slotframe, NULL); l != NULL;
+          l = tsch_schedule_get_link_next(slotframe, l)) {
+        if(link_matches(l, &t->peer, t->cell_options) && index++ >= offset) {
+          if(num_list == max_cells) {
+            /* There are more */
+            return TSCH_SIXTOP_RC_SUCCESS;
+          }
+          msg_put16(l->timeslot);
+          msg_put16(l->channel_offset);
+          num_list++;
+        }
+      }
+      return TSCH_SIXTOP_RC_EOL;
+    }
+
+    default:
+      return TSCH_SIXTOP_RC_ERR;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+request_input(const linkaddr_t *peer, uint8_t version, uint8_t cmd, uint8_t sfid,
+    uint8_t seqnum, const uint8_t *body, int body_len)
+{
+  const struct tsch_sixtop_sf *sf = tsch_sixtop_get_sf(sfid);
+  struct tsch_slotframe *slotframe = NULL;
+  struct transaction *t = NULL;
+  uint8_t rc;
+
+  msg_init(SIXP_TYPE_RESPONSE, 0, sfid, seqnum);
+
+  if(version != SIXP_VERSION) {
+    rc = TSCH_SIXTOP_RC_ERR_VERSION;
+  } else if(sf == NULL) {
+    rc = TSCH_SIXTOP_RC_ERR_SFID;
+  } else if(transaction_get(peer) != NULL) {
+    rc = TSCH_SIXTOP_RC_ERR_BUSY;
+  } else if(cmd != TSCH_SIXTOP_CMD_CLEAR && seqnum != seqnum_get(peer)) {
+    PRINTF("TSCH-6P:! seqnum %u from %u, expected %u\n",
+           seqnum, TSCH_LOG_ID_FROM_LINKADDR(peer), seqnum_get(peer));
+    rc = TSCH_SIXTOP_RC_ERR_SEQNUM;
+  } else if((slotframe = tsch_schedule_get_slotframe_by_handle(sf->slotframe_handle)) == NULL) {
+    rc = TSCH_SIXTOP_RC_ERR;
+  } else if((t = memb_alloc(&transaction_memb)) == NULL) {
+    rc = TSCH_SIXTOP_RC_ERR_BUSY;
+  } else {
+    memset(t, 0, sizeof(struct transaction));
+    linkaddr_copy(&t->peer, peer);
+    t->sf = sf;
+    t->state = STATE_RESPONSE_QUEUED;
+    t->cmd = cmd;
+    t->seqnum = seqnum;
+    list_add(transaction_list, t);
+    rc = t->rc = request_process(t, slotframe, body, body_len);
+    if(rc != TSCH_SIXTOP_RC_SUCCESS && rc != TSCH_SIXTOP_RC_EOL) {
+      /* Error responses carry no body */
+      msg_len = SIXP_HDR_LEN;
+    }
+  }
+
+  PRINTF("TSCH-6P: request %u from %u seqnum %u, rc %u\n",
+         cmd, TSCH_LOG_ID_FROM_LINKADDR(peer), seqnum, rc);
+  msg[1] = rc;
+  if(t != NULL) {
+    msg_send(peer, response_sent, t);
+  } else {
+    msg_send(peer, NULL, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+response_input(const linkaddr_t *peer, uint8_t rc, uint8_t sfid,
+    uint8_t seqnum, const uint8_t *body, int body_len)
+{
+  struct transaction *t = transaction_get(peer);
+  struct tsch_slotframe *slotframe;
+  struct tsch_sixtop_cell cells[TSCH_SIXTOP_MAX_CELLS];
+  uint8_t num_cells = 0;
+  uint16_t count = 0;
+  int valid = 1;
+
+  if(t == NULL || t->state == STATE_RESPONSE_QUEUED
+     || t->sf->sfid != sfid || t->seqnum != seqnum) {
+    PRINTF("TSCH-6P:! unexpected response from %u seqnum %u\n",
+           TSCH_LOG_ID_FROM_LINKADDR(peer), seqnum);
+    return;
+  }
+
+  if(t->cmd == TSCH_SIXTOP_CMD_COUNT) {
+    if(body_len >= 2) {
+      count = READ16(body);
+    }
+  } else if(body_len % SIXP_CELL_LEN != 0
+            || body_len > TSCH_SIXTOP_MAX_CELLS * SIXP_CELL_LEN) {
+    valid = 0;
+  } else {
+    num_cells = read_cells(body, body_len, cells, TSCH_SIXTOP_MAX_CELLS);
+  }
+
+  slotframe = tsch_schedule_get_slotframe_by_handle(t->sf->slotframe_handle);
+  if(slotframe != NULL) {
+    if(t->cmd == TSCH_SIXTOP_CMD_CLEAR) {
+      /* CLEAR takes effect whatever the outcome */
+      clear_cells(slotframe, peer);
+      seqnum_reset(peer);
+    } else if(rc == TSCH_SIXTOP_RC_SUCCESS || rc == TSCH_SIXTOP_RC_EOL) {
+      /* The cells must come from our request, and be free on our side.
+       * Otherwise the schedule is left unchanged and the transaction
+       * fails; the peer may have applied it, so the SF should CLEAR. */
+      switch(t->cmd) {
+        case TSCH_SIXTOP_CMD_ADD:
+          valid = valid && num_cells <= t->num_cells
+            && cells_in_list(cells, num_cells, t->add, t->num_add)
+            && apply_cells(slotframe, peer, t->cell_options, NULL, 0, cells, num_cells);
+          break;
+        case TSCH_SIXTOP_CMD_DELETE:
+          valid = valid && cells_in_list(cells, num_cells, t->del, t->num_del)
+            && apply_cells(slotframe, peer, t->cell_options, cells, num_cells, NULL, 0);
+          break;
+        case TSCH_SIXTOP_CMD_RELOCATE:
+          /* The first relocated cells move to the ones in the response */
+          valid = valid && num_cells <= t->num_del
+            && cells_in_list(cells, num_cells, t->add, t->num_add)
+            && apply_cells(slotframe, peer, t->cell_options,
+                t->del, num_cells, cells, num_cells);
+          break;
+      }
+      /* The transaction is over for the peer, valid or not */
+      seqnum_next(peer);
+      if(!valid) {
+        PRINTF("TSCH-6P:! invalid response from %u\n", TSCH_LOG_ID_FROM_LINKADDR(peer));
+        rc = TSCH_SIXTOP_RC_ERR;
+        num_cells = 0;
+      }
+    }
+  }
+
+  if(rc != TSCH_SIXTOP_RC_SUCCESS && rc != TSCH_SIXTOP_RC_EOL && t->num_del > 0) {
+    /* Failed DELETE or RELOCATE: tell the SF which cells it was about */
+    transaction_finish(t, rc, t->del, t->num_del, 0);
+  } else {
+    transaction_finish(t, rc, cells, num_cells, count);
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_input(void)
+{
+  struct ieee802154_ies ies;
+  linkaddr_t peer;
+  const uint8_t *m;
+
+  memset(&ies, 0, sizeof(ies));
+  if(frame802154e_parse_information_elements(packetbuf_dataptr(), packetbuf_datalen(), &ies) < 0
+     || ies.ie_sixtop == NULL) {
+    /* No 6top sub-IE, the frame is for upper layers */
+    return 0;
+  }
+  if(ies.ie_sixtop_len < SIXP_HDR_LEN) {
+    PRINTF("TSCH-6P:! 6P message too short\n");
+    return 1;
+  }
+  if(linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &linkaddr_null)) {
+    /* 6P messages are unicast only */
+    return 1;
+  }
+
+  linkaddr_copy(&peer, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  m = ies.ie_sixtop;
+  switch((m[0] >> 4) & 0x03) {
+    case SIXP_TYPE_REQUEST:
+      request_input(&peer, m[0] & 0x0f, m[1], m[2], m[3],
+          m + SIXP_HDR_LEN, ies.ie_sixtop_len - SIXP_HDR_LEN);
+      break;
+    case SIXP_TYPE_RESPONSE:
+      if((m[0] & 0x0f) == SIXP_VERSION) {
+        response_input(&peer, m[1], m[2], m[3],
+            m + SIXP_HDR_LEN, ies.ie_sixtop_len - SIXP_HDR_LEN);
+      }
+      break;
+    default:
+      /* No 3-step transactions, thus no confirmations */
+      PRINTF("TSCH-6P:! unsupported message type\n");
+      break;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Initiator: allocate a transaction and start building the request */
+static struct transaction *
+request_new(uint8_t sfid, const linkaddr_t *peer, uint8_t cmd, uint16_t metadata)
+{
+  const struct tsch_sixtop_sf *sf = tsch_sixtop_get_sf(sfid);
+  struct transaction *t;
+
+  if(sf == NULL || peer == NULL || !tsch_is_associated
+     || transaction_get(peer) != NULL
+     || tsch_schedule_get_slotframe_by_handle(sf->slotframe_handle) == NULL) {
+    return NULL;
+  }
+  t = memb_alloc(&transaction_memb);
+  if(t == NULL) {
+    return NULL;
+  }
+  memset(t, 0, sizeof(struct transaction));
+  linkaddr_copy(&t->peer, peer);
+  t->sf = sf;
+  t->state = STATE_REQUEST_QUEUED;
+  t->cmd = cmd;
+  t->seqnum = nbr_get(peer, 1)->seqnum;
+  list_add(transaction_list, t);
+
+  msg_init(SIXP_TYPE_REQUEST, cmd, sfid, t->seqnum);
+  msg_put16(metadata);
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+static int
+request_send(struct transaction *t)
+{
+  PRINTF("TSCH-6P: request %u to %u seqnum %u\n",
+         t->cmd, TSCH_LOG_ID_FROM_LINKADDR(&t->peer), t->seqnum);
+  ctimer_set(&t->timer, t->sf->timeout != 0 ? t->sf->timeout : TSCH_SIXTOP_TIMEOUT,
+      request_timeout, t);
+  msg_send(&t->peer, request_sent, t);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_request_add(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options, uint8_t num_cells,
+    const struct tsch_sixtop_cell *candidates, uint8_t num_candidates)
+{
+  struct transaction *t;
+  if(num_cells == 0 || num_candidates < num_cells
+     || num_candidates > TSCH_SIXTOP_MAX_CELLS
+     || (t = request_new(sfid, peer, TSCH_SIXTOP_CMD_ADD, metadata)) == NULL) {
+    return 0;
+  }
+  t->cell_options = cell_options & CELL_OPTIONS_MASK;
+  t->num_cells = num_cells;
+  memcpy(t->add, candidates, num_candidates * sizeof(struct tsch_sixtop_cell));
+  t->num_add = num_candidates;
+  msg_put8(t->cell_options);
+  msg_put8(num_cells);
+  msg_put_cells(candidates, num_candidates);
+  return request_send(t);
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_request_delete(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options,
+    const struct tsch_sixtop_cell *cells, uint8_t num_cells)
+{
+  struct transaction *t;
+  if(num_cells == 0 || num_cells > TSCH_SIXTOP_MAX_CELLS
+     || (t = request_new(sfid, peer, TSCH_SIXTOP_CMD_DELETE, metadata)) == NULL) {
+    return 0;
+  }
+  t->cell_options = cell_options & CELL_OPTIONS_MASK;
+  memcpy(t->del, cells, num_cells * sizeof(struct tsch_sixtop_cell));
+  t->num_del = num_cells;
+  msg_put8(t->cell_options);
+  msg_put8(num_cells);
+  msg_put_cells(cells, num_cells);
+  return request_send(t);
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_request_relocate(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options,
+    const struct tsch_sixtop_cell *cells, uint8_t num_cells,
+    const struct tsch_sixtop_cell *candidates, uint8_t num_candidates)
+{
+  struct transaction *t;
+  if(num_cells == 0 || num_cells > TSCH_SIXTOP_MAX_CELLS
+     || num_candidates < num_cells || num_candidates > TSCH_SIXTOP_MAX_CELLS
+     || (t = request_new(sfid, peer, TSCH_SIXTOP_CMD_RELOCATE, metadata)) == NULL) {
+    return 0;
+  }
+  t->cell_options = cell_options & CELL_OPTIONS_MASK;
+  memcpy(t->del, cells, num_cells * sizeof(struct tsch_sixtop_cell));
+  t->num_del = num_cells;
+  memcpy(t->add, candidates, num_candidates * sizeof(struct tsch_sixtop_cell));
+  t->num_add = num_candidates;
+  msg_put8(t->cell_options);
+  msg_put8(num_cells);
+  msg_put_cells(cells, num_cells);
+  msg_put_cells(candidates, num_candidates);
+  return request_send(t);
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_request_count(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options)
+{
+  struct transaction *t = request_new(sfid, peer, TSCH_SIXTOP_CMD_COUNT, metadata);
+  if(t == NULL) {
+    return 0;
+  }
+  t->cell_options = cell_options & CELL_OPTIONS_MASK;
+  msg_put8(t->cell_options);
+  return request_send(t);
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_request_list(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options, uint16_t offset, uint16_t max_cells)
+{
+  struct transaction *t = request_new(sfid, peer, TSCH_SIXTOP_CMD_LIST, metadata);
+  if(t == NULL) {
+    return 0;
+  }
+  t->cell_options = cell_options & CELL_OPTIONS_MASK;
+  msg_put8(t->cell_options);
+  msg_put8(0); /* reserved */
+  msg_put16(offset);
+  msg_put16(max_cells);
+  return request_send(t);
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_request_clear(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata)
+{
+  struct transaction *t = request_new(sfid, peer, TSCH_SIXTOP_CMD_CLEAR, metadata);
+  if(t == NULL) {
+    return 0;
+  }
+  return request_send(t);
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_is_busy(const linkaddr_t *peer)
+{
+  return transaction_get(peer) != NULL;
+}
+/*---------------------------------------------------------------------------*/
+const struct tsch_sixtop_sf *
+tsch_sixtop_get_sf(uint8_t sfid)
+{
+  int i;
+  for(i = 0; i < TSCH_SIXTOP_MAX_SFS; i++) {
+    if(sfs[i] != NULL && sfs[i]->sfid == sfid) {
+      return sfs[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_sixtop_add_sf(const struct tsch_sixtop_sf *sf)
+{
+  int i;
+  if(sf == NULL || tsch_sixtop_get_sf(sf->sfid) != NULL) {
+    return 0;
+  }
+  for(i = 0; i < TSCH_SIXTOP_MAX_SFS; i++) {
+    if(sfs[i] == NULL) {
+      sfs[i] = sf;
+      if(sf->init != NULL) {
+        sf->init();
+      }
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_sixtop_reset(void)
+{
+  struct transaction *t = list_head(transaction_list);
+  while(t != NULL) {
+    struct transaction *next = list_item_next(t);
+    if(t->state == STATE_REQUEST_QUEUED || t->state == STATE_WAIT_RESPONSE) {
+      transaction_fail(t);
+    }
+    t = next;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_sixtop_init(void)
+{
+  memb_init(&nbr_memb);
+  list_init(nbr_list);
+  memb_init(&transaction_memb);
+  list_init(transaction_list);
+}
+/*---------------------------------------------------------------------------*/
+
+#endif /* TSCH_WITH_SIXTOP */
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         6top protocol (6P, RFC 8480): negotiation of dedicated cells between
+ *         neighbors, driven by pluggable scheduling functions (SF)
+ */
+
+#ifndef __TSCH_SIXTOP_H__
+#define __TSCH_SIXTOP_H__
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "net/linkaddr.h"
+
+/******** Configuration *******/
+
+/* Enable 6P. 6P messages are data frames carrying a payload IE; they are
+ * sent and received through the TSCH queues like any other unicast frame */
+#ifdef TSCH_CONF_WITH_SIXTOP
+#define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
+#else
+#define TSCH_WITH_SIXTOP 0
+#endif
+
+/* Max number of scheduling functions registered at the same time */
+#ifdef TSCH_SIXTOP_CONF_MAX_SFS
+#define TSCH_SIXTOP_MAX_SFS TSCH_SIXTOP_CONF_MAX_SFS
+#else
+#define TSCH_SIXTOP_MAX_SFS 2
+#endif
+
+/* Max number of concurrent transactions (with different neighbors) */
+#ifdef TSCH_SIXTOP_CONF_MAX_TRANSACTIONS
+#define TSCH_SIXTOP_MAX_TRANSACTIONS TSCH_SIXTOP_CONF_MAX_TRANSACTIONS
+#else
+#define TSCH_SIXTOP_MAX_TRANSACTIONS 2
+#endif
+
+/* Max number of neighbors we keep a 6P sequence number for. When full,
+ * the least recently used one is forgotten */
+#ifdef TSCH_SIXTOP_CONF_MAX_NEIGHBORS
+#define TSCH_SIXTOP_MAX_NEIGHBORS TSCH_SIXTOP_CONF_MAX_NEIGHBORS
+#else
+#define TSCH_SIXTOP_MAX_NEIGHBORS NBR_TABLE_CONF_MAX_NEIGHBORS
+#endif
+
+/* Max number of cells in a cell list (per list, a RELOCATE carries two) */
+#ifdef TSCH_SIXTOP_CONF_MAX_CELLS
+#define TSCH_SIXTOP_MAX_CELLS TSCH_SIXTOP_CONF_MAX_CELLS
+#else
+#define TSCH_SIXTOP_MAX_CELLS 5
+#endif
+
+/* Time an initiator waits for a response, unless the SF sets its own */
+#ifdef TSCH_SIXTOP_CONF_TIMEOUT
+#define TSCH_SIXTOP_TIMEOUT TSCH_SIXTOP_CONF_TIMEOUT
+#else
+#define TSCH_SIXTOP_TIMEOUT (30 * CLOCK_SECOND)
+#endif
+
+/********** Constants *********/
+
+/* 6P commands */
+#define TSCH_SIXTOP_CMD_ADD           1
+#define TSCH_SIXTOP_CMD_DELETE        2
+#define TSCH_SIXTOP_CMD_RELOCATE      3
+#define TSCH_SIXTOP_CMD_COUNT         4
+#define TSCH_SIXTOP_CMD_LIST          5
+#define TSCH_SIXTOP_CMD_SIGNAL        6
+#define TSCH_SIXTOP_CMD_CLEAR         7
+
+/* 6P return codes */
+#define TSCH_SIXTOP_RC_SUCCESS        0
+#define TSCH_SIXTOP_RC_EOL            1
+#define TSCH_SIXTOP_RC_ERR            2
+#define TSCH_SIXTOP_RC_RESET          3
+#define TSCH_SIXTOP_RC_ERR_VERSION    4
+#define TSCH_SIXTOP_RC_ERR_SFID       5
+#define TSCH_SIXTOP_RC_ERR_SEQNUM     6
+#define TSCH_SIXTOP_RC_ERR_CELLLIST   7
+#define TSCH_SIXTOP_RC_ERR_BUSY       8
+#define TSCH_SIXTOP_RC_ERR_LOCKED     9
+/* Not sent over the air: the request could not be sent or no response came */
+#define TSCH_SIXTOP_RC_TIMEOUT        0xff
+
+/* 6P cell options, from the point of view of the node sending the request.
+ * Same bits as LINK_OPTION_TX/RX/SHARED. */
+#define TSCH_SIXTOP_CELL_OPTION_TX     1
+#define TSCH_SIXTOP_CELL_OPTION_RX     2
+#define TSCH_SIXTOP_CELL_OPTION_SHARED 4
+
+/************ Types ***********/
+
+struct tsch_sixtop_cell {
+  uint16_t timeslot;
+  uint16_t channel_offset;
+};
+
+/* A scheduling function. It decides when to negotiate which cells; 6P
+ * runs the transactions and installs the agreed cells as links to the peer
+ * in the slotframe 'slotframe_handle', which the SF must have created. */
+struct tsch_sixtop_sf {
+  /* SF identifier, as in the 6P header */
+  uint8_t sfid;
+  /* Slotframe holding the cells negotiated by this SF */
+  uint16_t slotframe_handle;
+  /* Response timeout, 0 for TSCH_SIXTOP_TIMEOUT */
+  clock_time_t timeout;
+  /* Called when the SF is registered */
+  void (*init)(void);
+  /* Responder side of ADD and RELOCATE: pick up to 'num_cells' cells among
+   * the candidates, write them to 'selected' and return how many.
+   * If NULL, the first candidates that are free in the slotframe are taken.
+   * Selecting a cell that is not a candidate, or that is in use, fails the
+   * request with TSCH_SIXTOP_RC_ERR. */
+  int (*select_cells)(const linkaddr_t *peer, uint16_t metadata, uint8_t cell_options,
+      uint8_t num_cells, const struct tsch_sixtop_cell *candidates,
+      uint8_t num_candidates, struct tsch_sixtop_cell *selected);
+  /* Initiator side: a transaction is over. 'cells' is the cell list of the
+   * response (for a failed DELETE or RELOCATE: the cells of the request),
+   * 'count' the result of a COUNT. The schedule is already updated when
+   * this is called. A response with cells that were not in the request,
+   * or that are in use on our side, is not applied and reported as
+   * TSCH_SIXTOP_RC_ERR; as the peer may have applied it, the SF should
+   * then CLEAR. May be NULL. */
+  void (*response)(const linkaddr_t *peer, uint8_t cmd, uint8_t rc,
+      const struct tsch_sixtop_cell *cells, uint8_t num_cells, uint16_t count);
+};
+
+#if !TSCH_WITH_SIXTOP
+
+#define tsch_sixtop_init()
+#define tsch_sixtop_reset()
+
+#else /* TSCH_WITH_SIXTOP */
+
+/********** Functions *********/
+
+/* Initialize the module, called from tsch_init */
+void tsch_sixtop_init(void);
+/* Abort all transactions, called on TSCH reset */
+void tsch_sixtop_reset(void);
+/* Handle an incoming frame with IEs, packetbuf points after the MAC header.
+ * Returns 1 if the frame carried a 6P message, 0 if it is for upper layers */
+int tsch_sixtop_input(void);
+
+/* Register a scheduling function and call its init. Returns 1 if success */
+int tsch_sixtop_add_sf(const struct tsch_sixtop_sf *sf);
+/* Look up a registered scheduling function */
+const struct tsch_sixtop_sf *tsch_sixtop_get_sf(uint8_t sfid);
+/* Is there an ongoing transaction with a neighbor? */
+int tsch_sixtop_is_busy(const linkaddr_t *peer);
+
+/* Start a transaction with a neighbor. All return 1 if the request was
+ * queued, in which case the SF's response callback will be called, and 0
+ * if not (unknown SF, too many cells, ongoing transaction with the peer,
+ * no memory). 'cell_options' are as seen from this node, the peer installs
+ * the reverse (our TX cells are its RX cells). */
+
+/* Add 'num_cells' cells, picked by the peer among the candidates */
+int tsch_sixtop_request_add(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options, uint8_t num_cells,
+    const struct tsch_sixtop_cell *candidates, uint8_t num_candidates);
+/* Delete the given cells */
+int tsch_sixtop_request_delete(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options,
+    const struct tsch_sixtop_cell *cells, uint8_t num_cells);
+/* Move the given cells to cells picked by the peer among the candidates */
+int tsch_sixtop_request_relocate(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options,
+    const struct tsch_sixtop_cell *cells, uint8_t num_cells,
+    const struct tsch_sixtop_cell *candidates, uint8_t num_candidates);
+/* Ask the peer how many cells it has with us */
+int tsch_sixtop_request_count(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options);
+/* Ask the peer for its cells with us, from 'offset' on */
+int tsch_sixtop_request_list(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata, uint8_t cell_options, uint16_t offset, uint16_t max_cells);
+/* Remove all cells with the peer and restart sequence numbering */
+int tsch_sixtop_request_clear(uint8_t sfid, const linkaddr_t *peer,
+    uint16_t metadata);
+
+#endif /* TSCH_WITH_SIXTOP */
+
+#endif /* __TSCH_SIXTOP_H__ */
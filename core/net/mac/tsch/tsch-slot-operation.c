@@ -53,6 +53,10 @@
 #include "net/mac/tsch/tsch-packet.h"
 #include "net/mac/tsch/tsch-security.h"
 #include "net/mac/tsch/tsch-adaptive-timesync.h"
+#include "net/mac/tsch/tsch-adaptive-hopping.h"
+#include "net/mac/tsch/tsch-slot-profile.h"
+#include "net/mac/tsch/tsch-energest.h"
+#include <string.h>
 
 #if TSCH_LOG_LEVEL >= 1
 #define DEBUG DEBUG_PRINT
@@ -150,6 +154,37 @@ struct tsch_link *current_link = NULL;
 static struct tsch_link *backup_link = NULL;
 static struct tsch_packet *current_packet = NULL;
 static struct tsch_neighbor *current_neighbor = NULL;
+static uint8_t current_channel;
+
+#if TSCH_SLOT_PROFILE
+/* Start time of the slot phase being profiled */
+static rtimer_clock_t profile_start;
+#endif /* TSCH_SLOT_PROFILE */
+
+#if TSCH_WITH_ENERGEST
+/* Set when the radio listened in the current slot and detected nothing */
+static uint8_t energest_idle_rx;
+#endif /* TSCH_WITH_ENERGEST */
+
+#if TSCH_BURST_MAX_LEN > 1
+/* Frame pending bit, in the first byte of the frame control field */
+#define FRAME_PENDING_FLAG 0x10
+/* Set when the current link is to be run again in the next timeslot */
+static uint8_t burst_link_scheduled = 0;
+/* Timeslots of the ongoing burst after the first one, 0 when not in a burst */
+static uint8_t burst_count = 0;
+/* Is the ongoing burst ours, and to which neighbor */
+static uint8_t burst_is_tx;
+static linkaddr_t burst_addr;
+/* May the current slot start or extend a burst? Set at slot start */
+static uint8_t burst_allowed;
+/* Is there no link in the timeslot after the current one? Set when scheduling
+ * the current slot, out of the timing-critical part, and cleared whenever the
+ * schedule may change */
+static uint8_t burst_next_timeslot_free;
+/* Number of bursts per length, received [0] and sent [1] */
+static uint32_t burst_stats[2][TSCH_BURST_MAX_LEN + 1];
+#endif /* TSCH_BURST_MAX_LEN > 1 */
 
 /* Protothread for association */
 PT_THREAD(tsch_scan(struct pt *pt));
@@ -180,6 +215,10 @@ tsch_get_lock(void)
     int busy_wait = 0; /* Flag used for logging purposes */
     /* Make sure no new slot operation will start */
     tsch_lock_requested = 1;
+#if TSCH_BURST_MAX_LEN > 1
+    /* The schedule may change under the lock */
+    burst_next_timeslot_free = 0;
+#endif /* TSCH_BURST_MAX_LEN > 1 */
     /* Wait for the end of current slot operation. */
     if(tsch_in_slot_operation) {
       busy_wait = 1;
@@ -269,9 +308,18 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
                     "!dl-miss %s %d %d",
                         str, (int)(now-ref_time), (int)offset);
     );
+#if TSCH_SLOT_PROFILE
+    tsch_slot_profile_miss(current_link != NULL ? current_link->link_type : LINK_TYPE_NORMAL);
+#endif /* TSCH_SLOT_PROFILE */
 
     return 0;
   }
+#if TSCH_SLOT_PROFILE
+  /* How much earlier than the deadline we got here */
+  tsch_slot_profile_add(TSCH_SLOT_PHASE_SLACK,
+                        current_link != NULL ? current_link->link_type : LINK_TYPE_NORMAL,
+                        ref_time + offset - RTIMER_GUARD - now);
+#endif /* TSCH_SLOT_PROFILE */
   ref_time += offset;
   r = rtimer_set(tm, ref_time, 1, (void (*)(struct rtimer *, void *))tsch_slot_operation, NULL);
   if(r != RTIMER_OK) {
@@ -291,6 +339,51 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
     BUSYWAIT_UNTIL_ABS(0, ref_time, offset); \
   } while(0);
 /*---------------------------------------------------------------------------*/
+#if TSCH_BURST_MAX_LEN > 1
+/* Is there no link scheduled in the timeslot following the current one? */
+static int
+next_timeslot_is_free(void)
+{
+  uint16_t timeslot_diff;
+  struct tsch_link *backup;
+  return tsch_schedule_get_next_active_link(&current_asn, &timeslot_diff, &backup) == NULL
+    || timeslot_diff > 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Channel offset of the timeslots extending the ongoing burst. Both ends
+ * get the same, as the sum of their addresses does not depend on which end
+ * sends */
+static uint8_t
+burst_channel_offset(void)
+{
+  return TSCH_BURST_CHANNEL_OFFSET
+    + (current_link->channel_offset + linkaddr_node_addr.u8[LINKADDR_SIZE - 1]
+       + burst_addr.u8[LINKADDR_SIZE - 1]) % TSCH_BURST_CHANNEL_OFFSETS;
+}
+/*---------------------------------------------------------------------------*/
+/* Account for the end of the ongoing burst, if any */
+static void
+burst_end(void)
+{
+  if(burst_count > 0) {
+    burst_stats[burst_is_tx][burst_count + 1]++;
+    burst_count = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+tsch_burst_stats_get(int is_tx, uint8_t len)
+{
+  return len <= TSCH_BURST_MAX_LEN ? burst_stats[is_tx != 0][len] : 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_burst_stats_reset(void)
+{
+  memset(burst_stats, 0, sizeof(burst_stats));
+}
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+/*---------------------------------------------------------------------------*/
 /* Get EB, broadcast or unicast packet to be sent, and target neighbor. */
 static struct tsch_packet *
 get_packet_and_neighbor_for_link(struct tsch_link *link, struct tsch_neighbor **target_neighbor)
@@ -434,13 +527,25 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
         packet_ready = 1;
       }
 
+#if TSCH_BURST_MAX_LEN > 1
+      /* Ask the receiver to keep the link in the next timeslot if we have more
+       * for it. Done before securing, as the header is authenticated */
+      if(burst_allowed) {
+        ((uint8_t *)packet)[0] |= FRAME_PENDING_FLAG;
+      } else {
+        ((uint8_t *)packet)[0] &= ~FRAME_PENDING_FLAG;
+      }
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+
 #if TSCH_SECURITY_ENABLED
       if(tsch_is_pan_secured) {
         /* If we are going to encrypt, we need to generate the output in a separate buffer and keep
          * the original untouched. This is to allow for future retransmissions. */
         int with_encryption = queuebuf_attr(current_packet->qb, PACKETBUF_ATTR_SECURITY_LEVEL) & 0x4;
+        TSCH_SLOT_PROFILE_START(profile_start);
         packet_len += tsch_security_secure_frame(packet, with_encryption ? encrypted_packet : packet, current_packet->header_len,
             packet_len - current_packet->header_len, &current_asn);
+        TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_SECURITY, current_link, profile_start);
         if(with_encryption) {
           packet = encrypted_packet;
         }
@@ -448,7 +553,10 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
 #endif /* TSCH_SECURITY_ENABLED */
 
       /* prepare packet to send: copy to radio buffer */
-      if(packet_ready && NETSTACK_RADIO.prepare(packet, packet_len) == 0) { /* 0 means success */
+      TSCH_SLOT_PROFILE_START(profile_start);
+      packet_ready = packet_ready && NETSTACK_RADIO.prepare(packet, packet_len) == 0; /* 0 means success */
+      TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_RADIO_PREPARE, current_link, profile_start);
+      if(packet_ready) {
         static rtimer_clock_t tx_duration;
 
 #if CCA_ENABLED
@@ -525,15 +633,21 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
               /* The radio driver should return 0 if no valid packets are in the rx buffer */
               if(ack_len > 0) {
                 is_time_source = current_neighbor != NULL && current_neighbor->is_time_source;
+                TSCH_SLOT_PROFILE_START(profile_start);
                 if(tsch_packet_parse_eack(ackbuf, ack_len, seqno,
                     &frame, &ack_ies, &ack_hdrlen) == 0) {
                   ack_len = 0;
                 }
+                TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_ACK_PARSE, current_link, profile_start);
 
 #if TSCH_SECURITY_ENABLED
                 if(ack_len != 0) {
-                  if(!tsch_security_parse_frame(ackbuf, ack_hdrlen, ack_len - ack_hdrlen - tsch_security_mic_len(&frame),
-                      &frame, &current_neighbor->addr, &current_asn)) {
+                  int ack_authenticated;
+                  TSCH_SLOT_PROFILE_START(profile_start);
+                  ack_authenticated = tsch_security_parse_frame(ackbuf, ack_hdrlen, ack_len - ack_hdrlen - tsch_security_mic_len(&frame),
+                      &frame, &current_neighbor->addr, &current_asn);
+                  TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_SECURITY, current_link, profile_start);
+                  if(!ack_authenticated) {
                     TSCH_LOG_ADD(tsch_log_message,
                         snprintf(log->message, sizeof(log->message),
                         "!failed to authenticate ACK"));
@@ -570,6 +684,14 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
                   last_sync_asn = current_asn;
                   tsch_schedule_keepalive();
                 }
+#if TSCH_BURST_MAX_LEN > 1
+                /* The receiver accepted to keep the link in the next timeslot */
+                if(burst_allowed && frame.fcf.frame_pending) {
+                  burst_link_scheduled = 1;
+                  burst_is_tx = 1;
+                  linkaddr_copy(&burst_addr, &current_neighbor->addr);
+                }
+#endif /* TSCH_BURST_MAX_LEN > 1 */
                 mac_tx_status = MAC_TX_OK;
               } else {
                 mac_tx_status = MAC_TX_NOACK;
@@ -587,6 +709,11 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
     current_packet->transmissions++;
     current_packet->ret = mac_tx_status;
 
+    /* Keep track of the channel quality */
+    if(!current_neighbor->is_broadcast) {
+      tsch_adaptive_hopping_tx_outcome(current_channel, mac_tx_status);
+    }
+
 #if TSCH_WITH_LINK_STATISTICS || TSCH_LOG_LEVEL
     current_packet->timeslot = current_link->timeslot;
     current_packet->slotframe_handle = current_link->slotframe_handle;
@@ -655,16 +782,26 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
     static rtimer_clock_t rx_start_time;
     static rtimer_clock_t expected_rx_time;
     static rtimer_clock_t packet_duration;
+    /* Rx window: start of listening and guard time */
+    static rtimer_clock_t rx_offset;
+    static rtimer_clock_t rx_wait;
+    static uint8_t rx_window_narrowed;
     uint8_t packet_seen;
 
     expected_rx_time = current_slot_start + tsch_timing[tsch_ts_tx_offset];
     /* Default start time: expected Rx time */
     rx_start_time = expected_rx_time;
 
+    /* Listen only as long as the sender's clock drift requires, if known */
+    rx_window_narrowed = tsch_timesync_rx_window(current_link, &rx_offset, &rx_wait);
+    if(!rx_window_narrowed) {
+      rx_offset = tsch_timing[tsch_ts_rx_offset];
+      rx_wait = tsch_timing[tsch_ts_rx_wait];
+    }
     current_input = &input_array[input_index];
 
     /* Wait before starting to listen */
-    TSCH_SCHEDULE_AND_YIELD(pt, t, current_slot_start, tsch_timing[tsch_ts_rx_offset] - RADIO_DELAY_BEFORE_RX, "RxBeforeListen");
+    TSCH_SCHEDULE_AND_YIELD(pt, t, current_slot_start, rx_offset - RADIO_DELAY_BEFORE_RX, "RxBeforeListen");
     TSCH_DEBUG_RX_EVENT();
 
     /* Start radio for at least guard time */
@@ -673,7 +810,13 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
     if(!packet_seen) {
       /* Check if receiving within guard time */
       BUSYWAIT_UNTIL_ABS((packet_seen = NETSTACK_RADIO.receiving_packet()),
-          current_slot_start, tsch_timing[tsch_ts_rx_offset] + tsch_timing[tsch_ts_rx_wait]);
+          current_slot_start, rx_offset + rx_wait);
+    }
+#if TSCH_WITH_ENERGEST
+    energest_idle_rx = !packet_seen;
+#endif /* TSCH_WITH_ENERGEST */
+    if(rx_window_narrowed && !packet_seen) {
+      tsch_timesync_rx_miss(current_link);
     }
     if(packet_seen) {
       TSCH_DEBUG_RX_EVENT();
@@ -686,7 +829,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
     } else {
       /* Wait until packet is received, turn radio off */
       BUSYWAIT_UNTIL_ABS(!NETSTACK_RADIO.receiving_packet(),
-          current_slot_start, tsch_timing[tsch_ts_rx_offset] + tsch_timing[tsch_ts_rx_wait] + tsch_timing[tsch_ts_max_tx]);
+          current_slot_start, rx_offset + rx_wait + tsch_timing[tsch_ts_max_tx]);
       TSCH_DEBUG_RX_EVENT();
       NETSTACK_RADIO.off();
 
@@ -706,10 +849,15 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
         current_input->len = NETSTACK_RADIO.read((void *)current_input->payload, TSCH_PACKET_MAX_LEN);
         current_input->rx_asn = current_asn;
         current_input->rssi = (signed)radio_last_rssi;
+        TSCH_SLOT_PROFILE_START(profile_start);
         header_len = frame802154_parse((uint8_t *)current_input->payload, current_input->len, &frame);
         frame_valid = header_len > 0 &&
           frame802154_check_dest_panid(&frame) &&
           frame802154_extract_linkaddr(&frame, &source_address, &destination_address);
+        TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_RX_PARSE, current_link, profile_start);
+        if(frame_valid) {
+          tsch_adaptive_hopping_rx(current_channel, current_input->rssi);
+        }
 
         packet_duration = TSCH_PACKET_DURATION(current_input->len);
 
@@ -725,9 +873,13 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
 #if TSCH_SECURITY_ENABLED
         /* Decrypt and verify incoming frame */
         if(frame_valid) {
-          if(tsch_security_parse_frame(
+          int frame_authenticated;
+          TSCH_SLOT_PROFILE_START(profile_start);
+          frame_authenticated = tsch_security_parse_frame(
                current_input->payload, header_len, current_input->len - header_len - tsch_security_mic_len(&frame),
-               &frame, &source_address, &current_asn)) {
+               &frame, &source_address, &current_asn);
+          TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_SECURITY, current_link, profile_start);
+          if(frame_authenticated) {
             current_input->len -= tsch_security_mic_len(&frame);
           } else {
             TSCH_LOG_ADD(tsch_log_message,
@@ -772,18 +924,34 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
               static int ack_len;
 
               /* Build ACK frame */
+              TSCH_SLOT_PROFILE_START(profile_start);
               ack_len = tsch_packet_create_eack(ack_buf, sizeof(ack_buf),
                   &source_address, frame.seq, (int16_t)RTIMERTICKS_TO_US(estimated_drift), do_nack);
+              TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_ACK_CREATE, current_link, profile_start);
+
+#if TSCH_BURST_MAX_LEN > 1
+              /* The sender has more for us: accept to keep the link in the next timeslot */
+              if(frame.fcf.frame_pending && burst_allowed && !do_nack && ack_len > 0) {
+                ack_buf[0] |= FRAME_PENDING_FLAG;
+                burst_link_scheduled = 1;
+                burst_is_tx = 0;
+                linkaddr_copy(&burst_addr, &source_address);
+              }
+#endif /* TSCH_BURST_MAX_LEN > 1 */
 
 #if TSCH_SECURITY_ENABLED
               if(tsch_is_pan_secured) {
                 /* Secure ACK frame. There is only header and header IEs, therefore data len == 0. */
+                TSCH_SLOT_PROFILE_START(profile_start);
                 ack_len += tsch_security_secure_frame(ack_buf, ack_buf, ack_len, 0, &current_asn);
+                TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_SECURITY, current_link, profile_start);
               }
 #endif /* TSCH_SECURITY_ENABLED */
 
               /* Copy to radio buffer */
+              TSCH_SLOT_PROFILE_START(profile_start);
               NETSTACK_RADIO.prepare((const void *)ack_buf, ack_len);
+              TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_RADIO_PREPARE, current_link, profile_start);
 
               /* Wait for time to ACK and transmit ACK */
               TSCH_SCHEDULE_AND_YIELD(pt, t, rx_start_time,
@@ -792,8 +960,12 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
               NETSTACK_RADIO.transmit(ack_len);
             }
 
-            /* If the sender is a time source, proceed to clock drift compensation */
             n = tsch_queue_get_nbr(&source_address);
+            /* Learn the sender's timing, before correcting our own clock */
+            tsch_timesync_rx_update(n, estimated_drift, frame.seq, frame.fcf.ack_required,
+                frame.fcf.frame_pending);
+
+            /* If the sender is a time source, proceed to clock drift compensation */
             if(n != NULL && n->is_time_source) {
               int32_t since_last_timesync = ASN_DIFF(current_asn, last_sync_asn);
               /* Keep track of last sync time */
@@ -870,23 +1042,57 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
       );
 
     } else {
-      uint8_t current_channel;
       TSCH_DEBUG_SLOT_START();
       tsch_in_slot_operation = 1;
       /* Get a packet ready to be sent */
-      current_packet = get_packet_and_neighbor_for_link(current_link, &current_neighbor);
-      /* There is no packet to send, and this link does not have Rx flag. Instead of doing
-       * nothing, switch to the backup link (has Rx flag) if any. */
-      if(current_packet == NULL && !(current_link->link_options & LINK_OPTION_RX) && backup_link != NULL) {
-        current_link = backup_link;
+      TSCH_SLOT_PROFILE_START(profile_start);
+#if TSCH_BURST_MAX_LEN > 1
+      if(burst_count > 0) {
+        /* Within a burst: send to the same neighbor, or listen */
+        current_neighbor = burst_is_tx ? tsch_queue_get_nbr(&burst_addr) : NULL;
+        current_packet = tsch_queue_get_packet_for_nbr(current_neighbor, current_link);
+      } else
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+      {
         current_packet = get_packet_and_neighbor_for_link(current_link, &current_neighbor);
+        /* There is no packet to send, and this link does not have Rx flag. Instead of doing
+         * nothing, switch to the backup link (has Rx flag) if any. */
+        if(current_packet == NULL && !(current_link->link_options & LINK_OPTION_RX) && backup_link != NULL) {
+          current_link = backup_link;
+          current_packet = get_packet_and_neighbor_for_link(current_link, &current_neighbor);
+        }
+      }
+      TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_PACKET_FETCH, current_link, profile_start);
+#if TSCH_BURST_MAX_LEN > 1
+      /* Check here, ahead of the timing-critical part of the slot, if we could
+       * send more to the neighbor, or receive more, in the next timeslot */
+      burst_allowed = burst_count + 1 < TSCH_BURST_MAX_LEN
+        && burst_next_timeslot_free
+        && (current_packet != NULL ?
+            !current_neighbor->is_broadcast
+            && tsch_queue_get_second_packet_for_nbr(current_neighbor, current_link) != NULL :
+            (current_link->link_options & LINK_OPTION_RX) != 0);
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+      /* Hop channel, switching to a new hopping sequence first if it is due */
+      tsch_adaptive_hopping_check_switch();
+#if TSCH_BURST_MAX_LEN > 1
+      if(burst_count > 0) {
+        /* Bursts use their own channel offsets, away from the links other
+         * nodes may have in this timeslot */
+        current_channel = tsch_calculate_channel(&current_asn, burst_channel_offset());
+      } else
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+      {
+        current_channel = tsch_calculate_channel(&current_asn, current_link->channel_offset);
       }
-      /* Hop channel */
-      current_channel = tsch_calculate_channel(&current_asn, current_link->channel_offset);
       NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, current_channel);
       /* Reset drift correction */
       drift_correction = 0;
       is_drift_correction_used = 0;
+#if TSCH_WITH_ENERGEST
+      energest_idle_rx = 0;
+      tsch_energest_slot_start();
+#endif /* TSCH_WITH_ENERGEST */
       /* Decide whether it is a TX/RX/IDLE or OFF slot */
       /* Actual slot operation */
       if(current_packet != NULL) {
@@ -902,6 +1108,12 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
         static struct pt slot_rx_pt;
         PT_SPAWN(&slot_operation_pt, &slot_rx_pt, tsch_rx_slot(&slot_rx_pt, t));
       }
+#if TSCH_WITH_ENERGEST
+      {
+        struct tsch_slotframe *sf = tsch_schedule_get_slotframe_by_handle(current_link->slotframe_handle);
+        tsch_energest_slot_end(&current_link->energest, sf != NULL ? &sf->energest : NULL, energest_idle_rx);
+      }
+#endif /* TSCH_WITH_ENERGEST */
       TSCH_DEBUG_SLOT_END();
     }
 
@@ -934,15 +1146,35 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
           tsch_queue_update_all_backoff_windows(&current_link->addr);
         }
 
-        /* Get next active link */
-        current_link = tsch_schedule_get_next_active_link(&current_asn, &timeslot_diff, &backup_link);
-        if(current_link == NULL) {
-          /* There is no next link. Fall back to default
-           * behavior: wake up at the next slot. */
+#if TSCH_BURST_MAX_LEN > 1
+        if(burst_link_scheduled) {
+          /* Run the current link again in the next timeslot, on the burst
+           * channel offset */
+          burst_link_scheduled = 0;
+          burst_count++;
           timeslot_diff = 1;
+          backup_link = NULL;
+        } else
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+        {
+#if TSCH_BURST_MAX_LEN > 1
+          burst_end();
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+          /* Get next active link */
+          TSCH_SLOT_PROFILE_START(profile_start);
+          current_link = tsch_schedule_get_next_active_link(&current_asn, &timeslot_diff, &backup_link);
+          TSCH_SLOT_PROFILE_STOP(TSCH_SLOT_PHASE_LINK_SELECT, current_link, profile_start);
+          if(current_link == NULL) {
+            /* There is no next link. Fall back to default
+             * behavior: wake up at the next slot. */
+            timeslot_diff = 1;
+          }
         }
         /* Update ASN */
         ASN_INC(current_asn, timeslot_diff);
+#if TSCH_BURST_MAX_LEN > 1
+        burst_next_timeslot_free = next_timeslot_is_free();
+#endif /* TSCH_BURST_MAX_LEN > 1 */
         /* Time to next wake up */
         time_to_next_active_slot = timeslot_diff * tsch_timing[tsch_ts_timeslot_length] + drift_correction;
         drift_correction = 0;
@@ -998,5 +1230,12 @@ tsch_slot_operation_sync(rtimer_clock_t next_slot_start,
   current_asn = *next_slot_asn;
   last_sync_asn = current_asn;
   current_link = NULL;
+  /* Neighbor timings were relative to our previous slot boundaries */
+  tsch_timesync_rx_reset();
+#if TSCH_BURST_MAX_LEN > 1
+  burst_link_scheduled = 0;
+  burst_count = 0;
+  burst_next_timeslot_free = 0;
+#endif /* TSCH_BURST_MAX_LEN > 1 */
 }
 /*---------------------------------------------------------------------------*/
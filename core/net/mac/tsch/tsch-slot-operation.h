@@ -74,6 +74,39 @@
 #define TSCH_MAX_INCOMING_PACKETS 4
 #endif
 
+/* Max length of a burst, in timeslots. A sender with more frames queued for a
+ * neighbor sets the frame-pending bit; a receiver accepts by setting it in its
+ * ACK, and both ends run the same link again in the next timeslot. Each end
+ * does so only if it has no link scheduled in that timeslot, and the sender
+ * only if its next frame may go over the same link. 0 or 1: disabled */
+#ifdef TSCH_CONF_BURST_MAX_LEN
+#define TSCH_BURST_MAX_LEN TSCH_CONF_BURST_MAX_LEN
+#else
+#define TSCH_BURST_MAX_LEN 0
+#endif
+
+/* Channel offsets of the timeslots that extend a burst: a burst uses one of
+ * TSCH_BURST_CHANNEL_OFFSETS offsets starting at TSCH_BURST_CHANNEL_OFFSET,
+ * picked from the channel offset of its link and the addresses of the two
+ * nodes, so that the bursts of different pairs tend to use different ones.
+ * Neighbors that do not take part in the burst may have links in these
+ * timeslots, so the schedule must leave these offsets free: the 6TiSCH minimal
+ * schedule uses 0, Orchestra uses its slotframe handles (0 to 3). Offsets are
+ * taken modulo the length of the hopping sequence, which must hence be longer
+ * than TSCH_BURST_CHANNEL_OFFSET + TSCH_BURST_CHANNEL_OFFSETS for bursts to
+ * stay off the scheduled links. Must be the same network-wide */
+#ifdef TSCH_CONF_BURST_CHANNEL_OFFSET
+#define TSCH_BURST_CHANNEL_OFFSET TSCH_CONF_BURST_CHANNEL_OFFSET
+#else
+#define TSCH_BURST_CHANNEL_OFFSET 7
+#endif
+
+#ifdef TSCH_CONF_BURST_CHANNEL_OFFSETS
+#define TSCH_BURST_CHANNEL_OFFSETS TSCH_CONF_BURST_CHANNEL_OFFSETS
+#else
+#define TSCH_BURST_CHANNEL_OFFSETS 4
+#endif
+
 /*********** Callbacks *********/
 
 /* Called by TSCH form interrupt after receiving a frame, enabled upper-layer to decide
@@ -127,5 +160,11 @@ void tsch_slot_operation_sync(rtimer_clock_t next_slot_start,
     struct asn_t *next_slot_asn);
 /* Start actual slot operation */
 void tsch_slot_operation_start(void);
+#if TSCH_BURST_MAX_LEN > 1
+/* Get the number of bursts of len timeslots (2..TSCH_BURST_MAX_LEN) we sent (is_tx) or received */
+uint32_t tsch_burst_stats_get(int is_tx, uint8_t len);
+/* Clear burst statistics */
+void tsch_burst_stats_reset(void);
+#endif /* TSCH_BURST_MAX_LEN > 1 */
 
 #endif /* __TSCH_SLOT_OPERATION_H__ */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         TSCH slot operation profiler: per-phase timing statistics and
+ *         histograms
+ *
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-slot-profile.h"
+#include "net/mac/tsch/tsch-log.h"
+#include <stdio.h>
+#include <string.h>
+
+#if TSCH_SLOT_PROFILE
+
+static struct tsch_slot_profile_stats stats[TSCH_SLOT_PHASE_COUNT][TSCH_SLOT_PROFILE_LINK_TYPES];
+static uint32_t deadline_misses[TSCH_SLOT_PROFILE_LINK_TYPES];
+
+static const char *phase_names[TSCH_SLOT_PHASE_COUNT] = {
+  "link", "fetch", "sec", "prep", "parse", "ack-create", "ack-parse", "slack"
+};
+
+/*---------------------------------------------------------------------------*/
+/* Record the duration of a phase. Logs every new maximum (new minimum for
+ * the slack), which is what matters when sizing a timeslot template. */
+void
+tsch_slot_profile_add(enum tsch_slot_phase phase, uint8_t link_type, rtimer_clock_t ticks)
+{
+  struct tsch_slot_profile_stats *s;
+  int is_slack = phase == TSCH_SLOT_PHASE_SLACK;
+#if TSCH_SLOT_PROFILE_BUCKETS
+  uint8_t bucket;
+#endif
+
+  if(phase >= TSCH_SLOT_PHASE_COUNT || link_type >= TSCH_SLOT_PROFILE_LINK_TYPES) {
+    return;
+  }
+  s = &stats[phase][link_type];
+  if(s->count == 0 || ticks < s->min) {
+    s->min = ticks;
+    if(is_slack && s->count != 0) {
+      TSCH_LOG_ADD(tsch_log_message,
+          snprintf(log->message, sizeof(log->message),
+              "prof min %s-%u %u", phase_names[phase], link_type, (unsigned)ticks);
+      );
+    }
+  }
+  if(s->count == 0 || ticks > s->max) {
+    s->max = ticks;
+    if(!is_slack) {
+      TSCH_LOG_ADD(tsch_log_message,
+          snprintf(log->message, sizeof(log->message),
+              "prof max %s-%u %u", phase_names[phase], link_type, (unsigned)ticks);
+      );
+    }
+  }
+  s->count++;
+  s->sum += ticks;
+#if TSCH_SLOT_PROFILE_BUCKETS
+  for(bucket = 0; bucket < TSCH_SLOT_PROFILE_BUCKETS - 1 && (ticks >> bucket) != 0; bucket++);
+  if(s->hist[bucket] != 0xffff) {
+    s->hist[bucket]++;
+  }
+#endif
+}
+/*---------------------------------------------------------------------------*/
+/* Record a missed scheduling deadline */
+void
+tsch_slot_profile_miss(uint8_t link_type)
+{
+  if(link_type < TSCH_SLOT_PROFILE_LINK_TYPES) {
+    deadline_misses[link_type]++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Get the statistics of a phase for a link type */
+const struct tsch_slot_profile_stats *
+tsch_slot_profile_get(enum tsch_slot_phase phase, uint8_t link_type)
+{
+  if(phase >= TSCH_SLOT_PHASE_COUNT || link_type >= TSCH_SLOT_PROFILE_LINK_TYPES) {
+    return NULL;
+  }
+  return &stats[phase][link_type];
+}
+/*---------------------------------------------------------------------------*/
+/* Get the number of missed deadlines for a link type */
+uint32_t
+tsch_slot_profile_misses(uint8_t link_type)
+{
+  return link_type < TSCH_SLOT_PROFILE_LINK_TYPES ? deadline_misses[link_type] : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Get a printable name for a phase */
+const char *
+tsch_slot_profile_phase_name(enum tsch_slot_phase phase)
+{
+  return phase < TSCH_SLOT_PHASE_COUNT ? phase_names[phase] : "?";
+}
+/*---------------------------------------------------------------------------*/
+/* Clear all statistics. Samples recorded by a slot operation that
+ * interrupts this may be partially lost, which is fine for profiling. */
+void
+tsch_slot_profile_reset(void)
+{
+  memset(stats, 0, sizeof(stats));
+  memset(deadline_misses, 0, sizeof(deadline_misses));
+}
+
+#endif /* TSCH_SLOT_PROFILE */
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+#ifndef __TSCH_SLOT_PROFILE_H__
+#define __TSCH_SLOT_PROFILE_H__
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch-schedule.h"
+
+/******** Configuration *******/
+
+/* Time the phases of slot operation with RTIMER_NOW() and keep min/avg/max
+ * and a histogram per phase and link type, to help tune timeslot templates. Costs a few
+ * rtimer reads per slot, off by default. */
+#ifdef TSCH_CONF_SLOT_PROFILE
+#define TSCH_SLOT_PROFILE TSCH_CONF_SLOT_PROFILE
+#else
+#define TSCH_SLOT_PROFILE 0
+#endif
+
+/* Number of buckets in the duration histogram of each phase and link type.
+ * Bucket i counts durations below 2^i ticks and, for i > 0, of at least
+ * 2^(i-1) ticks. The last bucket also counts everything longer. With 0,
+ * only min/avg/max are kept. */
+#ifdef TSCH_CONF_SLOT_PROFILE_BUCKETS
+#define TSCH_SLOT_PROFILE_BUCKETS TSCH_CONF_SLOT_PROFILE_BUCKETS
+#else
+#define TSCH_SLOT_PROFILE_BUCKETS 12
+#endif
+
+/************ Types ***********/
+
+/* Profiled phases of slot operation */
+enum tsch_slot_phase {
+  TSCH_SLOT_PHASE_LINK_SELECT,   /* Selecting the next active link */
+  TSCH_SLOT_PHASE_PACKET_FETCH,  /* Picking a packet and neighbor for the link */
+  TSCH_SLOT_PHASE_SECURITY,      /* Securing or authenticating a frame or ACK */
+  TSCH_SLOT_PHASE_RADIO_PREPARE, /* Copying a frame or ACK to the radio */
+  TSCH_SLOT_PHASE_RX_PARSE,      /* Parsing the header of an incoming frame */
+  TSCH_SLOT_PHASE_ACK_CREATE,    /* Building an enhanced ACK */
+  TSCH_SLOT_PHASE_ACK_PARSE,     /* Parsing an incoming enhanced ACK */
+  TSCH_SLOT_PHASE_SLACK,         /* Time left before each scheduling deadline */
+  TSCH_SLOT_PHASE_COUNT
+};
+
+/* Number of link types profiled separately, see enum link_type */
+#define TSCH_SLOT_PROFILE_LINK_TYPES (LINK_TYPE_ADVERTISING_ONLY + 1)
+
+/* Statistics of a phase, in rtimer ticks */
+struct tsch_slot_profile_stats {
+  uint32_t count;
+  uint32_t sum;
+  rtimer_clock_t min;
+  rtimer_clock_t max;
+#if TSCH_SLOT_PROFILE_BUCKETS
+  uint16_t hist[TSCH_SLOT_PROFILE_BUCKETS]; /* Saturates at 0xffff */
+#endif
+};
+
+/********** Functions *********/
+
+/* Record the duration of a phase, from slot operation (interrupt context) */
+void tsch_slot_profile_add(enum tsch_slot_phase phase, uint8_t link_type, rtimer_clock_t ticks);
+/* Record a missed scheduling deadline */
+void tsch_slot_profile_miss(uint8_t link_type);
+/* Get the statistics of a phase for a link type */
+const struct tsch_slot_profile_stats *tsch_slot_profile_get(enum tsch_slot_phase phase, uint8_t link_type);
+/* Get the number of missed deadlines for a link type */
+uint32_t tsch_slot_profile_misses(uint8_t link_type);
+/* Get a printable name for a phase */
+const char *tsch_slot_profile_phase_name(enum tsch_slot_phase phase);
+/* Clear all statistics */
+void tsch_slot_profile_reset(void);
+
+/************ Macros **********/
+
+/* Bracket a phase with these. t0 is an rtimer_clock_t that holds the start
+ * time; link the current link (may be NULL) */
+#if TSCH_SLOT_PROFILE
+#define TSCH_SLOT_PROFILE_START(t0) ((t0) = RTIMER_NOW())
+#define TSCH_SLOT_PROFILE_STOP(phase, link, t0) \
+  tsch_slot_profile_add((phase), (link) != NULL ? (link)->link_type : LINK_TYPE_NORMAL, \
+                        RTIMER_NOW() - (t0))
+#else /* TSCH_SLOT_PROFILE */
+#define TSCH_SLOT_PROFILE_START(t0)
+#define TSCH_SLOT_PROFILE_STOP(phase, link, t0)
+#endif /* TSCH_SLOT_PROFILE */
+
+#endif /* __TSCH_SLOT_PROFILE_H__ */
@@ -53,6 +53,9 @@
 #include "net/mac/tsch/tsch-log.h"
 #include "net/mac/tsch/tsch-packet.h"
 #include "net/mac/tsch/tsch-security.h"
+#include "net/mac/tsch/tsch-adaptive-hopping.h"
+#include "net/mac/tsch/tsch-adaptive-timesync.h"
+#include "net/mac/tsch/tsch-sixtop.h"
 #include "lib/random.h"
 
 #if FRAME802154_VERSION < FRAME802154_IEEE802154E_2012
@@ -208,6 +211,9 @@ tsch_reset(void)
   tsch_join_priority = 0xff;
   ASN_INIT(current_asn, 0, 0);
   current_link = NULL;
+  tsch_adaptive_hopping_reset();
+  tsch_sixtop_reset();
+  tsch_timesync_rx_reset();
   /* Reset timeslot timing to defaults */
   for(i = 0; i < tsch_ts_elements_count; i++) {
     tsch_timing[i] = US_TO_RTIMERTICKS(tsch_default_timing_us[i]);
@@ -313,6 +319,9 @@ eb_input(struct input_packet *current_input)
     struct tsch_neighbor *n = tsch_queue_get_time_source();
     /* Did the EB come from our time source? */
     if(n != NULL && linkaddr_cmp((linkaddr_t *)&frame.src_addr, &n->addr)) {
+      /* Follow the hopping sequence changes announced by the time source */
+      tsch_adaptive_hopping_eb_input(&eb_ies);
+
       /* Check for ASN drift */
       int32_t asn_diff = ASN_DIFF(current_input->rx_asn, eb_ies.ie_asn);
       if(asn_diff != 0) {
@@ -526,6 +535,9 @@ tsch_associate(const struct input_packet *input_eb, rtimer_clock_t timestamp)
       return 0;
     }
   }
+  /* A hopping sequence switch may be on its way or already due */
+  tsch_adaptive_hopping_reset();
+  tsch_adaptive_hopping_eb_input(&ies);
 
 #if TSCH_CHECK_TIME_AT_ASSOCIATION > 0
   /* Divide by 4k and multiply again to avoid integer overflow */
@@ -875,6 +887,8 @@ tsch_init(void)
   tsch_queue_init();
   tsch_schedule_init();
   tsch_log_init();
+  tsch_adaptive_hopping_init();
+  tsch_sixtop_init();
   ringbufindex_init(&input_ringbuf, TSCH_MAX_INCOMING_PACKETS);
   ringbufindex_init(&dequeued_ringbuf, TSCH_DEQUEUED_ARRAY_SIZE);
 
@@ -1009,6 +1023,13 @@ packet_input(void)
       PRINTF("TSCH: received from %u with seqno %u\n",
              TSCH_LOG_ID_FROM_LINKADDR(packetbuf_addr(PACKETBUF_ADDR_SENDER)),
              packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO));
+#if TSCH_WITH_SIXTOP
+      /* 6P messages are not for upper layers */
+      if(packetbuf_attr(PACKETBUF_ATTR_MAC_IE_LIST_PRESENT)
+         && tsch_sixtop_input()) {
+        return;
+      }
+#endif /* TSCH_WITH_SIXTOP */
       NETSTACK_LLSEC.input();
     }
   }
@@ -74,6 +74,21 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_HASH_SIZE
+/* Index of the keys by link-layer address. Each bucket is a chain of
+ * neighbor indexes linked through hash_next[]. A key is in the index
+ * as long as it is in nbr_table_keys. */
+#if NBR_TABLE_MAX_NEIGHBORS < 0xff
+typedef uint8_t nbr_index_t;
+#else
+typedef uint16_t nbr_index_t;
+#endif
+#define INDEX_NONE ((nbr_index_t)~0)
+static nbr_index_t hash_heads[NBR_TABLE_HASH_SIZE];
+static nbr_index_t hash_next[NBR_TABLE_MAX_NEIGHBORS];
+static uint8_t hash_initialized;
+#endif /* NBR_TABLE_HASH_SIZE */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -117,16 +132,74 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_HASH_SIZE
+/* Get the hash bucket of a link-layer address */
+static nbr_index_t *
+hash_bucket(const linkaddr_t *lladdr)
+{
+  uint8_t h = 0;
+  int i;
+
+  if(!hash_initialized) {
+    hash_initialized = 1;
+    memset(hash_heads, 0xff, sizeof(hash_heads));
+  }
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h ^= lladdr->u8[i];
+  }
+  return &hash_heads[h % NBR_TABLE_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+/* Add a key to the index */
+static void
+hash_add(nbr_table_key_t *key)
+{
+  nbr_index_t *bucket = hash_bucket(&key->lladdr);
+  int index = index_from_key(key);
+
+  hash_next[index] = *bucket;
+  *bucket = index;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a key from the index */
+static void
+hash_remove(nbr_table_key_t *key)
+{
+  nbr_index_t *link = hash_bucket(&key->lladdr);
+  int index = index_from_key(key);
+
+  for(; *link != INDEX_NONE; link = &hash_next[*link]) {
+    if(*link == index) {
+      *link = hash_next[index];
+      return;
+    }
+  }
+}
+#endif /* NBR_TABLE_HASH_SIZE */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if NBR_TABLE_HASH_SIZE
+  nbr_index_t index;
+#else /* NBR_TABLE_HASH_SIZE */
   nbr_table_key_t *key;
+#endif /* NBR_TABLE_HASH_SIZE */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_HASH_SIZE
+  for(index = *hash_bucket(lladdr); index != INDEX_NONE;
+      index = hash_next[index]) {
+    if(linkaddr_cmp(lladdr, &key_from_index(index)->lladdr)) {
+      return index;
+    }
+  }
+  return -1;
+#else /* NBR_TABLE_HASH_SIZE */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -135,6 +208,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     key = list_item_next(key);
   }
   return -1;
+#endif /* NBR_TABLE_HASH_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 /* Get bit from "used" or "locked" bitmap */
@@ -231,6 +305,9 @@ nbr_table_allocate(void)
       used_map[index_from_key(least_used_key)] = 0;
       /* Remove neighbor from list */
       list_remove(nbr_table_keys, least_used_key);
+#if NBR_TABLE_HASH_SIZE
+      hash_remove(least_used_key);
+#endif /* NBR_TABLE_HASH_SIZE */
       /* Return associated key */
       return least_used_key;
     }
@@ -318,6 +395,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr)
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_HASH_SIZE
+    hash_add(key);
+#endif /* NBR_TABLE_HASH_SIZE */
   }
 
   /* Get item in the current table */
@@ -339,6 +339,7 @@ enum {
 #endif /* NETSTACK_CONF_WITH_RIME */
   PACKETBUF_ATTR_PENDING,
   PACKETBUF_ATTR_FRAME_TYPE,
+  PACKETBUF_ATTR_MAC_IE_LIST_PRESENT,
 #if LLSEC802154_SECURITY_LEVEL
   PACKETBUF_ATTR_SECURITY_LEVEL,
 #endif /* LLSEC802154_SECURITY_LEVEL */
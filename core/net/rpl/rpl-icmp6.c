@@ -85,6 +85,17 @@ void RPL_DEBUG_DIO_INPUT(uip_ipaddr_t *, rpl_dio_t *);
 void RPL_DEBUG_DAO_OUTPUT(rpl_parent_t *);
 #endif
 
+/* Callbacks for DIO options not handled by RPL itself. The input callback
+ * gets every unknown option (type and length included), the output callback
+ * appends options to outgoing DIOs and returns the number of bytes written */
+#ifdef RPL_CALLBACK_DIO_OPTION_INPUT
+void RPL_CALLBACK_DIO_OPTION_INPUT(const uip_ipaddr_t *from, const uint8_t *option, int len);
+#endif /* RPL_CALLBACK_DIO_OPTION_INPUT */
+
+#ifdef RPL_CALLBACK_DIO_OPTION_OUTPUT
+int RPL_CALLBACK_DIO_OPTION_OUTPUT(uint8_t *buf, int max_len);
+#endif /* RPL_CALLBACK_DIO_OPTION_OUTPUT */
+
 static uint8_t dao_sequence = RPL_LOLLIPOP_INIT;
 
 extern rpl_of_t RPL_OF;
@@ -408,8 +419,12 @@ dio_input(void)
       memcpy(&dio.prefix_info.prefix, &buffer[i + 16], 16);
       break;
     default:
+#ifdef RPL_CALLBACK_DIO_OPTION_INPUT
+      RPL_CALLBACK_DIO_OPTION_INPUT(&from, &buffer[i], len);
+#else /* RPL_CALLBACK_DIO_OPTION_INPUT */
       PRINTF("RPL: Unsupported suboption type in DIO: %u\n",
 	(unsigned)subopt_type);
+#endif /* RPL_CALLBACK_DIO_OPTION_INPUT */
     }
   }
 
@@ -549,6 +564,11 @@ dio_output(rpl_instance_t *instance, uip_ipaddr_t *uc_addr)
            dag->prefix_info.length);
   }
 
+#ifdef RPL_CALLBACK_DIO_OPTION_OUTPUT
+  pos += RPL_CALLBACK_DIO_OPTION_OUTPUT(&buffer[pos],
+                                        UIP_BUFSIZE - uip_l2_l3_icmp_hdr_len - pos);
+#endif /* RPL_CALLBACK_DIO_OPTION_OUTPUT */
+
 #if RPL_LEAF_ONLY
 #if (DEBUG) & DEBUG_PRINT
   if(uc_addr == NULL) {
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *	Measures the selection throughput of Antelope. The benchmark
+ *	creates a relation with DB_BENCHMARK_TUPLES tuples and then
+ *	runs a set of queries with typical predicates over it, reporting
+ *	the number of tuples processed per second for each query.
+ *	The time taken to insert the tuples is reported as well.
+ *
+ *	The predicate interpreter can be compared with the predicate
+ *	compiler by building with "make DEFINES=LVM_USE_COMPILER=0".
+ * \author
+ * 	agent <agent@local>
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+
+#include "antelope.h"
+
+#ifndef DB_BENCHMARK_TUPLES
+#define DB_BENCHMARK_TUPLES	5000
+#endif
+
+#ifndef DB_BENCHMARK_ROUNDS
+#define DB_BENCHMARK_ROUNDS	10
+#endif
+
+static const char *queries[] = {
+  "SELECT id, val FROM bench WHERE val = 3;",
+  "SELECT id, val FROM bench WHERE val > 2 AND val < 5;",
+  "SELECT id, val, t FROM bench WHERE t > 1000 AND t < 9000 OR val = 6;",
+  "SELECT id, val, t FROM bench WHERE val * 2 + 1 > t - 100;",
+  "SELECT val, COUNT(id), MEAN(t) FROM bench GROUP BY val;",
+  NULL
+};
+
+PROCESS(db_benchmark, "DB benchmark");
+AUTOSTART_PROCESSES(&db_benchmark);
+
+static db_result_t
+run_query(const char *query, unsigned long *processed)
+{
+  static db_handle_t handle;
+  db_result_t result;
+
+  result = db_query(&handle, query);
+  if(DB_ERROR(result)) {
+    db_free(&handle);
+    return result;
+  }
+
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    switch(result) {
+    case DB_GOT_ROW:
+    case DB_OK:
+      (*processed)++;
+      break;
+    case DB_FINISHED:
+      db_free(&handle);
+      return DB_OK;
+    default:
+      db_free(&handle);
+      return result;
+    }
+  }
+
+  db_free(&handle);
+  return DB_OK;
+}
+
+PROCESS_THREAD(db_benchmark, ev, data)
+{
+  static unsigned i;
+  static unsigned round;
+  static unsigned long processed;
+  static clock_time_t start;
+  clock_time_t elapsed;
+  db_result_t result;
+
+  PROCESS_BEGIN();
+
+  db_init();
+
+  db_query(NULL, "REMOVE RELATION bench;");
+  if(DB_ERROR(db_query(NULL, "CREATE RELATION bench;")) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE id DOMAIN INT IN bench;")) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE val DOMAIN INT IN bench;")) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE t DOMAIN LONG IN bench;"))) {
+    printf("Failed to create the benchmark relation\n");
+    PROCESS_EXIT();
+  }
+
+  start = clock_time();
+  for(i = 0; i < DB_BENCHMARK_TUPLES; i++) {
+    result = db_query(NULL, "INSERT (%u, %u, %lu) INTO bench;",
+                      i, i % 7, (unsigned long)i * 3);
+    if(DB_ERROR(result)) {
+      printf("Failed to insert tuple %u: %s\n",
+             i, db_get_result_message(result));
+      PROCESS_EXIT();
+    }
+  }
+  if(DB_ERROR(db_flush())) {
+    printf("Failed to flush the inserted tuples\n");
+    PROCESS_EXIT();
+  }
+  elapsed = clock_time() - start;
+  printf("Inserted %u tuples in %lu ms\n", DB_BENCHMARK_TUPLES,
+         (unsigned long)elapsed * 1000 / CLOCK_SECOND);
+
+  printf("Benchmarking %u tuples, %u rounds per query, LVM compiler %s\n",
+         DB_BENCHMARK_TUPLES, DB_BENCHMARK_ROUNDS,
+         LVM_USE_COMPILER ? "on" : "off");
+
+  for(i = 0; queries[i] != NULL; i++) {
+    processed = 0;
+    start = clock_time();
+    for(round = 0; round < DB_BENCHMARK_ROUNDS; round++) {
+      result = run_query(queries[i], &processed);
+      if(DB_ERROR(result)) {
+        printf("Query \"%s\" failed: %s\n",
+               queries[i], db_get_result_message(result));
+        break;
+      }
+    }
+    elapsed = clock_time() - start;
+    if(elapsed == 0) {
+      elapsed = 1;
+    }
+
+    printf("%s\n  %lu tuples in %lu ms, %lu tuples/s\n",
+           queries[i], processed,
+           (unsigned long)elapsed * 1000 / CLOCK_SECOND,
+           processed * CLOCK_SECOND / elapsed);
+    PROCESS_PAUSE();
+  }
+
+  db_query(NULL, "REMOVE RELATION bench;");
+  printf("Benchmark finished\n");
+
+  PROCESS_END();
+}
@@ -39,6 +39,10 @@
 #undef UIP_CONF_BUFFER_SIZE
 #define UIP_CONF_BUFFER_SIZE    1280
 
+/* Queue received packets instead of handling them while slip waits */
+#undef UIP_CONF_BUFFER_POOL_SIZE
+#define UIP_CONF_BUFFER_POOL_SIZE 4
+
 #undef UIP_CONF_RECEIVE_WINDOW
 #define UIP_CONF_RECEIVE_WINDOW  60
 
@@ -44,6 +44,10 @@
 #if WITH_ORCHESTRA
 #include "orchestra.h"
 #endif /* WITH_ORCHESTRA */
+#if WITH_SIXTOP
+#include "net/mac/tsch/tsch-sixtop.h"
+#include "net/mac/tsch/tsch-sf-queue.h"
+#endif /* WITH_SIXTOP */
 
 #define DEBUG DEBUG_PRINT
 #include "net/ip/uip-debug.h"
@@ -196,6 +200,9 @@ PROCESS_THREAD(node_process, ev, data)
 #if WITH_ORCHESTRA
   orchestra_init();
 #endif /* WITH_ORCHESTRA */
+#if WITH_SIXTOP
+  tsch_sixtop_add_sf(&tsch_sf_queue);
+#endif /* WITH_SIXTOP */
   
   /* Print out routing tables every minute */
   etimer_set(&et, CLOCK_SECOND * 60);
@@ -45,6 +45,11 @@
 #define WITH_SECURITY 0
 #endif /* WITH_SECURITY */
 
+/* Set to negotiate cells with 6P, using the queue-based SF */
+#ifndef WITH_SIXTOP
+#define WITH_SIXTOP 0
+#endif /* WITH_SIXTOP */
+
 /*******************************************************/
 /********************* Enable TSCH *********************/
 /*******************************************************/
@@ -124,6 +129,10 @@
 
 #endif /* WITH_ORCHESTRA */
 
+#if WITH_SIXTOP
+#define TSCH_CONF_WITH_SIXTOP 1
+#endif /* WITH_SIXTOP */
+
 /*******************************************************/
 /************* Other system configuration **************/
 /*******************************************************/
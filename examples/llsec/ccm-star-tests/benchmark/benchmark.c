@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Measures the throughput of AES-128 and CCM*
+ */
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+#include <stdio.h>
+
+#define AES_BLOCKS     200000UL
+#define CCM_STAR_FRAMES 20000UL
+#define FRAME_HDR_LEN  23
+#define FRAME_DATA_LEN 90
+#define MIC_LEN        8
+
+/*---------------------------------------------------------------------------*/
+static void
+report(const char *what, unsigned long count, clock_time_t elapsed)
+{
+  if(elapsed == 0) {
+    elapsed = 1;
+  }
+  printf("%s: %lu in %lu ms (%lu/s)\n", what, count,
+         (unsigned long)(elapsed * 1000 / CLOCK_SECOND),
+         (unsigned long)(count * CLOCK_SECOND / elapsed));
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_aes_128(void)
+{
+  static const uint8_t key[AES_128_KEY_LENGTH] = { 0x00 , 0x01 , 0x02 , 0x03 ,
+                                                   0x04 , 0x05 , 0x06 , 0x07 ,
+                                                   0x08 , 0x09 , 0x0A , 0x0B ,
+                                                   0x0C , 0x0D , 0x0E , 0x0F };
+  uint8_t block[AES_128_BLOCK_SIZE] = { 0 };
+  clock_time_t start;
+  unsigned long i;
+
+  AES_128.set_key(key);
+  start = clock_time();
+  for(i = 0; i < AES_BLOCKS; i++) {
+    AES_128.encrypt(block);
+  }
+  report("AES-128 blocks", AES_BLOCKS, clock_time() - start);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_ccm_star(void)
+{
+  static const uint8_t key[AES_128_KEY_LENGTH] = { 0xC0 , 0xC1 , 0xC2 , 0xC3 ,
+                                                   0xC4 , 0xC5 , 0xC6 , 0xC7 ,
+                                                   0xC8 , 0xC9 , 0xCA , 0xCB ,
+                                                   0xCC , 0xCD , 0xCE , 0xCF };
+  uint8_t nonce[CCM_STAR_NONCE_LENGTH] = { 0 };
+  uint8_t hdr[FRAME_HDR_LEN] = { 0 };
+  uint8_t data[FRAME_DATA_LEN] = { 0 };
+  uint8_t mic[MIC_LEN];
+  clock_time_t start;
+  unsigned long i;
+
+  CCM_STAR.set_key(key);
+  start = clock_time();
+  for(i = 0; i < CCM_STAR_FRAMES; i++) {
+    nonce[12] = i;
+    CCM_STAR.aead(nonce, data, sizeof(data), hdr, sizeof(hdr),
+                  mic, sizeof(mic), 1);
+  }
+  report("CCM* frames (encrypt)", CCM_STAR_FRAMES, clock_time() - start);
+
+  start = clock_time();
+  for(i = 0; i < CCM_STAR_FRAMES; i++) {
+    nonce[12] = i;
+    CCM_STAR.aead(nonce, data, sizeof(data), hdr, sizeof(hdr),
+                  mic, sizeof(mic), 0);
+  }
+  report("CCM* frames (decrypt)", CCM_STAR_FRAMES, clock_time() - start);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(ccm_star_benchmark_process, "CCM* benchmark process");
+AUTOSTART_PROCESSES(&ccm_star_benchmark_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ccm_star_benchmark_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("AES_128_WITH_T_TABLES = %d\n", AES_128_WITH_T_TABLES);
+  bench_aes_128();
+  bench_ccm_star();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Checks uip_chksum_words() against the 16-bit reference
+ *         implementation on random buffers, lengths, alignments and
+ *         initial sums, and measures the throughput of both.
+ */
+
+#include "contiki.h"
+#include "net/ip/uip-chksum.h"
+#include "lib/random.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FUZZ_ROUNDS    200000UL
+#define BENCH_ROUNDS   50000UL
+#define BENCH_LEN      1280
+#define MAX_LEN        1300
+#define MAX_OFFSET     8
+
+static uint32_t buf_words[(MAX_LEN + MAX_OFFSET) / sizeof(uint32_t) + 1];
+static uint8_t *buf = (uint8_t *)buf_words;
+
+/*---------------------------------------------------------------------------*/
+/* The byte-at-a-time checksum from uip6.c */
+static uint16_t
+reference_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+    dataptr += 2;
+  }
+
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+static int
+check(uint16_t sum, uint16_t offset, uint16_t len)
+{
+  uint16_t expected;
+  uint16_t actual;
+
+  expected = reference_chksum(sum, buf + offset, len);
+  actual = uip_chksum_words(sum, buf + offset, len);
+  if(expected != actual) {
+    printf("Mismatch: sum 0x%04x offset %u len %u: 0x%04x != 0x%04x\n",
+           sum, offset, len, actual, expected);
+    return 0;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fuzz(void)
+{
+  unsigned long round;
+  uint16_t i;
+  uint16_t len;
+  uint16_t offset;
+  unsigned long failures;
+
+  failures = 0;
+
+  /* All ones provokes the most carries */
+  memset(buf, 0xff, MAX_LEN + MAX_OFFSET);
+  for(offset = 0; offset < MAX_OFFSET; offset++) {
+    for(len = 0; len <= 64; len++) {
+      failures += !check(0xffff, offset, len);
+      failures += !check(0, offset, len);
+    }
+    failures += !check(0xfffe, offset, MAX_LEN);
+  }
+
+  for(round = 0; round < FUZZ_ROUNDS; round++) {
+    offset = random_rand() % MAX_OFFSET;
+    len = random_rand() % (MAX_LEN + 1);
+    for(i = 0; i < len; i++) {
+      buf[offset + i] = random_rand();
+    }
+    failures += !check(random_rand(), offset, len);
+  }
+
+  if(failures == 0) {
+    printf("Fuzzing ... Success\n");
+  } else {
+    printf("Fuzzing ... Failure (%lu)\n", failures);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(const char *name, uint16_t (*f)(uint16_t, const uint8_t *, uint16_t))
+{
+  clock_time_t start;
+  clock_time_t elapsed;
+  unsigned long round;
+  volatile uint16_t sum;
+
+  sum = 0;
+  start = clock_time();
+  for(round = 0; round < BENCH_ROUNDS; round++) {
+    sum = f(sum, buf, BENCH_LEN);
+  }
+  elapsed = clock_time() - start;
+  if(elapsed == 0) {
+    elapsed = 1;
+  }
+  printf("%s: %lu x %u bytes in %lu ms (%lu MB/s)\n", name,
+         BENCH_ROUNDS, BENCH_LEN,
+         (unsigned long)(elapsed * 1000 / CLOCK_SECOND),
+         (unsigned long)(BENCH_ROUNDS * BENCH_LEN / 1000 * CLOCK_SECOND
+                         / elapsed / 1000));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(uip_chksum_test_process, "uIP checksum test process");
+AUTOSTART_PROCESSES(&uip_chksum_test_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(uip_chksum_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  fuzz();
+  bench("16-bit", reference_chksum);
+  bench("32-bit", uip_chksum_words);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
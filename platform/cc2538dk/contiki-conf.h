@@ -453,6 +453,11 @@ typedef uint32_t rtimer_clock_t;
 #define UIP_CONF_BUFFER_SIZE              1300
 #endif
 
+/* Compute the Internet checksum 32 bits at a time */
+#ifndef UIP_CONF_WORD_CHKSUM
+#define UIP_CONF_WORD_CHKSUM 1
+#endif /* UIP_CONF_WORD_CHKSUM */
+
 #define UIP_CONF_IPV6_QUEUE_PKT              0
 #define UIP_CONF_IPV6_CHECKS                 1
 #define UIP_CONF_IPV6_REASSEMBLY             0
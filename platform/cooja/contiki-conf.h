@@ -181,6 +181,16 @@
 #define QUEUEBUF_CONF_NUM 16
 #endif
 
+/* Use the 32-bit table-driven software AES */
+#ifndef AES_128_CONF_WITH_T_TABLES
+#define AES_128_CONF_WITH_T_TABLES 1
+#endif /* AES_128_CONF_WITH_T_TABLES */
+
+/* Compute the Internet checksum 32 bits at a time */
+#ifndef UIP_CONF_WORD_CHKSUM
+#define UIP_CONF_WORD_CHKSUM 1
+#endif /* UIP_CONF_WORD_CHKSUM */
+
 #define CC_CONF_REGISTER_ARGS          1
 #define CC_CONF_FUNCTION_POINTER_ARGS  1
 #define CC_CONF_VA_ARGS                1
@@ -60,4 +60,14 @@ typedef uint64_t rtimer_clock_t;
 
 typedef unsigned short uip_stats_t;
 
+/* Use the 32-bit table-driven software AES */
+#ifndef AES_128_CONF_WITH_T_TABLES
+#define AES_128_CONF_WITH_T_TABLES 1
+#endif /* AES_128_CONF_WITH_T_TABLES */
+
+/* Compute the Internet checksum 32 bits at a time */
+#ifndef UIP_CONF_WORD_CHKSUM
+#define UIP_CONF_WORD_CHKSUM 1
+#endif /* UIP_CONF_WORD_CHKSUM */
+
 #endif /* CONTIKI_CONF_H */
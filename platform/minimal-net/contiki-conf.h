@@ -52,6 +52,16 @@ int select_set_callback(int fd, const struct select_callback *callback);
 #define CCIF
 #define CLIF
 
+/* Use the 32-bit table-driven software AES */
+#ifndef AES_128_CONF_WITH_T_TABLES
+#define AES_128_CONF_WITH_T_TABLES 1
+#endif /* AES_128_CONF_WITH_T_TABLES */
+
+/* Compute the Internet checksum 32 bits at a time */
+#ifndef UIP_CONF_WORD_CHKSUM
+#define UIP_CONF_WORD_CHKSUM 1
+#endif /* UIP_CONF_WORD_CHKSUM */
+
 #ifndef EEPROM_CONF_SIZE
 #define EEPROM_CONF_SIZE				1024
 #endif
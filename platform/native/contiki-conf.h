@@ -74,6 +74,16 @@ typedef unsigned short uip_stats_t;
 #define UIP_CONF_LOGGING         0
 #define UIP_CONF_UDP_CHECKSUMS   1
 
+/* Use the 32-bit table-driven software AES */
+#ifndef AES_128_CONF_WITH_T_TABLES
+#define AES_128_CONF_WITH_T_TABLES 1
+#endif /* AES_128_CONF_WITH_T_TABLES */
+
+/* Compute the Internet checksum 32 bits at a time */
+#ifndef UIP_CONF_WORD_CHKSUM
+#define UIP_CONF_WORD_CHKSUM 1
+#endif /* UIP_CONF_WORD_CHKSUM */
+
 #ifndef NETSTACK_CONF_RDC_CHANNEL_CHECK_RATE
 #define NETSTACK_CONF_RDC_CHANNEL_CHECK_RATE 8
 #endif /* NETSTACK_CONF_RDC_CHANNEL_CHECK_RATE */
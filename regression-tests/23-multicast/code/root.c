@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Multicast benchmark seed: RPL root which sends a numbered datagram
+ *         to FF1E::89:ABCD every SEND_INTERVAL. The simulation script pairs
+ *         the "TX" lines printed here with the "RX" lines of the sinks.
+ */
+
+#include "contiki.h"
+#include "contiki-lib.h"
+#include "contiki-net.h"
+#include "net/ipv6/multicast/uip-mcast6.h"
+#include "net/rpl/rpl.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MCAST_SINK_UDP_PORT 3001 /* Host byte order */
+#define SEND_INTERVAL CLOCK_SECOND
+#define ITERATIONS 50
+#define STATS_INTERVAL (20 * CLOCK_SECOND)
+
+/* Give RPL time to converge over the largest topology before we start */
+#define START_DELAY 120
+
+static struct uip_udp_conn *mcast_conn;
+static uint32_t seq_id;
+
+#if !NETSTACK_CONF_WITH_IPV6 || !UIP_CONF_ROUTER || !UIP_CONF_IPV6_MULTICAST || !UIP_CONF_IPV6_RPL
+#error "This test can not work with the current contiki configuration"
+#endif
+/*---------------------------------------------------------------------------*/
+PROCESS(root_process, "Multicast benchmark root");
+AUTOSTART_PROCESSES(&root_process);
+/*---------------------------------------------------------------------------*/
+static void
+print_stats(void)
+{
+  printf("Stats %lu %lu %lu %lu %lu\n",
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_in_unique),
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_in_all),
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_fwd),
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_out),
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_dropped));
+}
+/*---------------------------------------------------------------------------*/
+static void
+multicast_send(void)
+{
+  uint32_t id;
+
+  id = uip_htonl(seq_id);
+  printf("TX %lu\n", (unsigned long)seq_id);
+  seq_id++;
+  uip_udp_packet_send(mcast_conn, &id, sizeof(id));
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_own_addresses(void)
+{
+  rpl_dag_t *dag;
+  uip_ipaddr_t ipaddr;
+
+  uip_ip6addr(&ipaddr, 0xaaaa, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&ipaddr, &uip_lladdr);
+  uip_ds6_addr_add(&ipaddr, 0, ADDR_AUTOCONF);
+
+  dag = rpl_set_root(RPL_DEFAULT_INSTANCE, &ipaddr);
+  if(dag != NULL) {
+    rpl_set_prefix(dag, &ipaddr, 64);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(root_process, ev, data)
+{
+  static struct etimer et;
+  static struct etimer stats;
+  uip_ipaddr_t ipaddr;
+
+  PROCESS_BEGIN();
+
+  printf("Engine %s\n", UIP_MCAST6.name);
+
+  NETSTACK_MAC.off(1);
+
+  set_own_addresses();
+
+  uip_ip6addr(&ipaddr, 0xFF1E, 0, 0, 0, 0, 0, 0x89, 0xABCD);
+  mcast_conn = udp_new(&ipaddr, UIP_HTONS(MCAST_SINK_UDP_PORT), NULL);
+
+  etimer_set(&et, START_DELAY * CLOCK_SECOND);
+  etimer_set(&stats, STATS_INTERVAL);
+  while(1) {
+    PROCESS_YIELD();
+    if(ev != PROCESS_EVENT_TIMER) {
+      continue;
+    }
+    if(data == &stats) {
+      print_stats();
+      etimer_reset(&stats);
+    } else if(data == &et) {
+      if(seq_id == ITERATIONS) {
+        printf("Done %lu\n", (unsigned long)seq_id);
+      } else {
+        multicast_send();
+        etimer_set(&et, SEND_INTERVAL);
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Multicast benchmark sink: joins FF1E::89:ABCD, forwards according
+ *         to the engine under test and logs every datagram it receives.
+ */
+
+#include "contiki.h"
+#include "contiki-lib.h"
+#include "contiki-net.h"
+#include "net/ipv6/multicast/uip-mcast6.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MCAST_SINK_UDP_PORT 3001 /* Host byte order */
+#define STATS_INTERVAL (20 * CLOCK_SECOND)
+
+#define UIP_IP_BUF   ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+static struct uip_udp_conn *sink_conn;
+
+#if !NETSTACK_CONF_WITH_IPV6 || !UIP_CONF_ROUTER || !UIP_CONF_IPV6_MULTICAST || !UIP_CONF_IPV6_RPL
+#error "This test can not work with the current contiki configuration"
+#endif
+/*---------------------------------------------------------------------------*/
+PROCESS(sink_process, "Multicast benchmark sink");
+AUTOSTART_PROCESSES(&sink_process);
+/*---------------------------------------------------------------------------*/
+static void
+print_stats(void)
+{
+  printf("Stats %lu %lu %lu %lu %lu\n",
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_in_unique),
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_in_all),
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_fwd),
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_out),
+         (unsigned long)UIP_MCAST6_STATS_GET(mcast_dropped));
+}
+/*---------------------------------------------------------------------------*/
+static void
+tcpip_handler(void)
+{
+  uint32_t id;
+
+  if(uip_newdata()) {
+    memcpy(&id, uip_appdata, sizeof(id));
+    /* Hop count, as seen by the TTL the seed started with */
+    printf("RX %lu %u\n", (unsigned long)uip_ntohl(id),
+           UIP_TTL - UIP_IP_BUF->ttl);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+join_mcast_group(void)
+{
+  uip_ipaddr_t addr;
+
+  uip_ip6addr(&addr, 0xaaaa, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&addr, &uip_lladdr);
+  uip_ds6_addr_add(&addr, 0, ADDR_AUTOCONF);
+
+  uip_ip6addr(&addr, 0xFF1E, 0, 0, 0, 0, 0, 0x89, 0xABCD);
+  return uip_ds6_maddr_add(&addr) != NULL;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sink_process, ev, data)
+{
+  static struct etimer stats;
+
+  PROCESS_BEGIN();
+
+  printf("Engine %s\n", UIP_MCAST6.name);
+
+  if(!join_mcast_group()) {
+    printf("Failed to join multicast group\n");
+    PROCESS_EXIT();
+  }
+
+  sink_conn = udp_new(NULL, UIP_HTONS(0), NULL);
+  udp_bind(sink_conn, UIP_HTONS(MCAST_SINK_UDP_PORT));
+
+  etimer_set(&stats, STATS_INTERVAL);
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == tcpip_event) {
+      tcpip_handler();
+    } else if(etimer_expired(&stats)) {
+      print_stats();
+      etimer_reset(&stats);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,98 @@
+/*
+ * Multicast engine benchmark.
+ *
+ * Mote 1 is the seed and prints "TX <seq>" for every datagram it sends and
+ * "Done <n>" after the last one. All other motes are sinks and print
+ * "RX <seq> <hops>" for every datagram they receive. Every mote periodically
+ * prints its uip_mcast6_stats as
+ * "Stats <in_unique> <in_all> <fwd> <out> <dropped>".
+ *
+ * Once the seed is done and the network has had time to drain, a single
+ * REPORT line is logged with the packet delivery ratio, the seed-to-sink
+ * latency and the number of multicast transmissions, so that the testlogs
+ * of different engines and topologies can be compared ('make mcast-report').
+ */
+
+TIMEOUT(900000); /* 15 minutes */
+
+/* The test fails if fewer than this fraction of the datagrams arrive */
+var PDR_MIN = 0.8;
+/* Time to wait after the last datagram; covers two stats intervals */
+var DRAIN_MS = 45000;
+
+var SEED_ID = 1;
+var NR_SINKS = sim.getMotesCount() - 1;
+
+var engine = "unknown";
+var sent = {};
+var nr_sent = 0;
+var received = {};
+var delivered = 0;
+var duplicates = 0;
+var latency_sum = 0;
+var latency_max = 0;
+var hops_sum = 0;
+var stats = {};
+
+while(true) {
+  YIELD();
+  if(msg.equals("report")) {
+    break;
+  }
+  if(msg.startsWith("Engine ") && id == SEED_ID) {
+    engine = msg.substring(7).replace(" ", "-");
+  } else if(msg.startsWith("TX ") && id == SEED_ID) {
+    sent[parseInt(msg.split(" ")[1])] = time;
+    nr_sent++;
+  } else if(msg.startsWith("Done") && id == SEED_ID) {
+    GENERATE_MSG(DRAIN_MS, "report");
+  } else if(msg.startsWith("RX ")) {
+    data = msg.split(" ");
+    seq = parseInt(data[1]);
+    key = id + ":" + seq;
+    if(received[key]) {
+      duplicates++;
+    } else if(sent[seq] != undefined) {
+      received[key] = true;
+      delivered++;
+      /* Simulation time is in microseconds */
+      latency = (time - sent[seq]) / 1000;
+      latency_sum += latency;
+      if(latency > latency_max) {
+        latency_max = latency;
+      }
+      hops_sum += parseInt(data[2]);
+    }
+  } else if(msg.startsWith("Stats ")) {
+    stats[id] = msg.split(" ");
+  }
+}
+
+/* Network-wide multicast transmissions: the seed's plus every forward */
+var transmissions = 0;
+var dropped = 0;
+for(var n in stats) {
+  transmissions += parseInt(stats[n][3]) + parseInt(stats[n][4]);
+  dropped += parseInt(stats[n][5]);
+}
+
+var expected = nr_sent * NR_SINKS;
+var pdr = expected > 0 ? delivered / expected : 0;
+
+log.log("REPORT engine=" + engine +
+        " nodes=" + (NR_SINKS + 1) +
+        " sent=" + nr_sent +
+        " pdr=" + pdr.toFixed(3) +
+        " lat_avg_ms=" + (delivered > 0 ? (latency_sum / delivered).toFixed(1) : "-") +
+        " lat_max_ms=" + latency_max.toFixed(1) +
+        " hops_avg=" + (delivered > 0 ? (hops_sum / delivered).toFixed(2) : "-") +
+        " dups=" + duplicates +
+        " tx=" + transmissions +
+        " tx_per_msg=" + (nr_sent > 0 ? (transmissions / nr_sent).toFixed(1) : "-") +
+        " dropped=" + dropped + "\n");
+
+if(nr_sent > 0 && pdr >= PDR_MIN) {
+  log.testOK();
+} else {
+  log.testFailed();
+}
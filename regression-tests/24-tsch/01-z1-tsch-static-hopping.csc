@@ -0,0 +1,276 @@
+<?xml version="1.0" encoding="UTF-8"?>
+<simconf>
+  <project EXPORT="discard">[APPS_DIR]/mrm</project>
+  <project EXPORT="discard">[APPS_DIR]/mspsim</project>
+  <project EXPORT="discard">[APPS_DIR]/avrora</project>
+  <project EXPORT="discard">[APPS_DIR]/serial_socket</project>
+  <project EXPORT="discard">[APPS_DIR]/collect-view</project>
+  <project EXPORT="discard">[APPS_DIR]/powertracker</project>
+  <simulation>
+    <title>TSCH static hopping under jamming</title>
+    <randomseed>123456</randomseed>
+    <motedelay_us>1000000</motedelay_us>
+    <radiomedium>
+      org.contikios.cooja.radiomediums.UDGM
+      <transmitting_range>50.0</transmitting_range>
+      <interference_range>100.0</interference_range>
+      <success_ratio_tx>1.0</success_ratio_tx>
+      <success_ratio_rx>1.0</success_ratio_rx>
+    </radiomedium>
+    <events>
+      <logoutput>40000</logoutput>
+    </events>
+    <motetype>
+      org.contikios.cooja.mspmote.Z1MoteType
+      <identifier>z11</identifier>
+      <description>TSCH node</description>
+      <source EXPORT="discard">[CONFIG_DIR]/code/node.c</source>
+      <commands EXPORT="discard">make TARGET=z1 clean
+make node.z1 TARGET=z1 HOPPING_THRESHOLD=0</commands>
+      <firmware EXPORT="copy">[CONFIG_DIR]/code/node.z1</firmware>
+      <moteinterface>org.contikios.cooja.interfaces.Position</moteinterface>
+      <moteinterface>org.contikios.cooja.interfaces.RimeAddress</moteinterface>
+      <moteinterface>org.contikios.cooja.interfaces.IPAddress</moteinterface>
+      <moteinterface>org.contikios.cooja.interfaces.Mote2MoteRelations</moteinterface>
+      <moteinterface>org.contikios.cooja.interfaces.MoteAttributes</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspClock</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspMoteID</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspButton</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.Msp802154Radio</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspDefaultSerial</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspLED</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspDebugOutput</moteinterface>
+    </motetype>
+    <motetype>
+      org.contikios.cooja.mspmote.Z1MoteType
+      <identifier>z12</identifier>
+      <description>Jammer on channel 26</description>
+      <source EXPORT="discard">[CONFIG_DIR]/code/jammer.c</source>
+      <commands EXPORT="discard">make jammer.z1 TARGET=z1</commands>
+      <firmware EXPORT="copy">[CONFIG_DIR]/code/jammer.z1</firmware>
+      <moteinterface>org.contikios.cooja.interfaces.Position</moteinterface>
+      <moteinterface>org.contikios.cooja.interfaces.RimeAddress</moteinterface>
+      <moteinterface>org.contikios.cooja.interfaces.IPAddress</moteinterface>
+      <moteinterface>org.contikios.cooja.interfaces.Mote2MoteRelations</moteinterface>
+      <moteinterface>org.contikios.cooja.interfaces.MoteAttributes</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspClock</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspMoteID</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspButton</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.Msp802154Radio</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspDefaultSerial</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspLED</moteinterface>
+      <moteinterface>org.contikios.cooja.mspmote.interfaces.MspDebugOutput</moteinterface>
+    </motetype>
+    <mote>
+      <breakpoints />
+      <interface_config>
+        org.contikios.cooja.interfaces.Position
+        <x>0.0</x>
+        <y>0.0</y>
+        <z>0.0</z>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspClock
+        <deviation>1.0</deviation>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspMoteID
+        <id>1</id>
+      </interface_config>
+      <motetype_identifier>z11</motetype_identifier>
+    </mote>
+    <mote>
+      <breakpoints />
+      <interface_config>
+        org.contikios.cooja.interfaces.Position
+        <x>30.0</x>
+        <y>0.0</y>
+        <z>0.0</z>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspClock
+        <deviation>1.0</deviation>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspMoteID
+        <id>2</id>
+      </interface_config>
+      <motetype_identifier>z11</motetype_identifier>
+    </mote>
+    <mote>
+      <breakpoints />
+      <interface_config>
+        org.contikios.cooja.interfaces.Position
+        <x>0.0</x>
+        <y>30.0</y>
+        <z>0.0</z>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspClock
+        <deviation>1.0</deviation>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspMoteID
+        <id>3</id>
+      </interface_config>
+      <motetype_identifier>z11</motetype_identifier>
+    </mote>
+    <mote>
+      <breakpoints />
+      <interface_config>
+        org.contikios.cooja.interfaces.Position
+        <x>-30.0</x>
+        <y>0.0</y>
+        <z>0.0</z>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspClock
+        <deviation>1.0</deviation>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspMoteID
+        <id>4</id>
+      </interface_config>
+      <motetype_identifier>z11</motetype_identifier>
+    </mote>
+    <mote>
+      <breakpoints />
+      <interface_config>
+        org.contikios.cooja.interfaces.Position
+        <x>0.0</x>
+        <y>-30.0</y>
+        <z>0.0</z>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspClock
+        <deviation>1.0</deviation>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspMoteID
+        <id>5</id>
+      </interface_config>
+      <motetype_identifier>z11</motetype_identifier>
+    </mote>
+    <mote>
+      <breakpoints />
+      <interface_config>
+        org.contikios.cooja.interfaces.Position
+        <x>70.0</x>
+        <y>0.0</y>
+        <z>0.0</z>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspClock
+        <deviation>1.0</deviation>
+      </interface_config>
+      <interface_config>
+        org.contikios.cooja.mspmote.interfaces.MspMoteID
+        <id>6</id>
+      </interface_config>
+      <motetype_identifier>z12</motetype_identifier>
+    </mote>
+  </simulation>
+  <plugin>
+    org.contikios.cooja.plugins.SimControl
+    <width>242</width>
+    <z>3</z>
+    <height>160</height>
+    <location_x>11</location_x>
+    <location_y>241</location_y>
+  </plugin>
+  <plugin>
+    org.contikios.cooja.plugins.Visualizer
+    <plugin_config>
+      <moterelations>true</moterelations>
+      <skin>org.contikios.cooja.plugins.skins.IDVisualizerSkin</skin>
+      <skin>org.contikios.cooja.plugins.skins.UDGMVisualizerSkin</skin>
+      <viewport>1.7405603810040515 0.0 0.0 1.7405603810040515 120.0 120.0</viewport>
+    </plugin_config>
+    <width>236</width>
+    <z>2</z>
+    <height>230</height>
+    <location_x>1</location_x>
+    <location_y>1</location_y>
+  </plugin>
+  <plugin>
+    org.contikios.cooja.plugins.LogListener
+    <plugin_config>
+      <filter>ID:1</filter>
+      <formatted_time />
+      <coloring />
+    </plugin_config>
+    <width>1031</width>
+    <z>0</z>
+    <height>394</height>
+    <location_x>273</location_x>
+    <location_y>6</location_y>
+  </plugin>
+  <plugin>
+    org.contikios.cooja.plugins.ScriptRunner
+    <plugin_config>
+      <script>TIMEOUT(660000, report()); /* 11 minutes */&#xD;
+&#xD;
+/* Node 1 starts sending at 120 s and prints its cumulative unicast Tx&#xD;
+ * attempts and successes every 30 s. Window A is before the coordinator&#xD;
+ * can have changed the hopping sequence (first evaluation with traffic at&#xD;
+ * 240 s), window B is after the announced switch. */&#xD;
+var A_START = 150; var A_END = 240;&#xD;
+var B_START = 330; var B_END = 600;&#xD;
+&#xD;
+var tx_a0 = -1, ok_a0, tx_a1 = -1, ok_a1;&#xD;
+var tx_b0 = -1, ok_b0, tx_b1 = -1, ok_b1;&#xD;
+var channels_start = 0, channels_end = 0;&#xD;
+var sent = 0, received = 0;&#xD;
+&#xD;
+function ratio(tx0, ok0, tx1, ok1) {&#xD;
+  if(tx0 &lt; 0 || tx1 &lt;= tx0) {&#xD;
+    return -1;&#xD;
+  }&#xD;
+  return ((tx1 - tx0) - (ok1 - ok0)) / (tx1 - tx0);&#xD;
+}&#xD;
+&#xD;
+function report() {&#xD;
+  var ra = ratio(tx_a0, ok_a0, tx_a1, ok_a1);&#xD;
+  var rb = ratio(tx_b0, ok_b0, tx_b1, ok_b1);&#xD;
+  var pdr = sent &gt; 0 ? received / sent : 0;&#xD;
+  log.log("REPORT static: failed Tx ratio before " + ra.toFixed(3) +&#xD;
+          " after " + rb.toFixed(3) + ", channels " + channels_start +&#xD;
+          " -&gt; " + channels_end + ", app PDR " + pdr.toFixed(3) +&#xD;
+          " (" + received + "/" + sent + ")\n");&#xD;
+  if(channels_end != channels_start || pdr &lt; 0.5) {&#xD;
+    log.testFailed();&#xD;
+  }&#xD;
+  log.testOK();&#xD;
+}&#xD;
+&#xD;
+while(true) {&#xD;
+  YIELD();&#xD;
+  var t = time / 1000000;&#xD;
+  if(id == 1) {&#xD;
+    var m = msg.match(/^Stats tx (\d+) ok (\d+) channels (\d+)/);&#xD;
+    if(m != null) {&#xD;
+      var tx = parseInt(m[1]), ok = parseInt(m[2]), ch = parseInt(m[3]);&#xD;
+      if(channels_start == 0) {&#xD;
+        channels_start = ch;&#xD;
+      }&#xD;
+      channels_end = ch;&#xD;
+      if(t &gt;= A_START &amp;&amp; tx_a0 &lt; 0) { tx_a0 = tx; ok_a0 = ok; }&#xD;
+      if(t &gt;= A_START &amp;&amp; t &lt;= A_END) { tx_a1 = tx; ok_a1 = ok; }&#xD;
+      if(t &gt;= B_START &amp;&amp; tx_b0 &lt; 0) { tx_b0 = tx; ok_b0 = ok; }&#xD;
+      if(t &gt;= B_START &amp;&amp; t &lt;= B_END) { tx_b1 = tx; ok_b1 = ok; }&#xD;
+    } else if(msg.startsWith("TX ")) {&#xD;
+      sent++;&#xD;
+    }&#xD;
+  } else if(msg.startsWith("RX ")) {&#xD;
+    received++;&#xD;
+  }&#xD;
+}</script>
+      <active>true</active>
+    </plugin_config>
+    <width>764</width>
+    <z>1</z>
+    <height>995</height>
+    <location_x>963</location_x>
+    <location_y>111</location_y>
+  </plugin>
+</simconf>
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Jammer for the TSCH scenarios: sends back-to-back frames on
+ *         JAMMER_CHANNEL without any MAC, to interfere with every TSCH slot
+ *         that hops onto this channel.
+ */
+
+#include "contiki.h"
+#include "dev/radio.h"
+#include "net/netstack.h"
+
+#include <string.h>
+
+#define JAMMER_CHANNEL 26
+#define JAMMER_FRAME_LEN 100
+
+static uint8_t frame[JAMMER_FRAME_LEN];
+
+/*---------------------------------------------------------------------------*/
+PROCESS(jammer_process, "Jammer");
+AUTOSTART_PROCESSES(&jammer_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(jammer_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  /* Not a valid 802.15.4 frame type, so that nobody parses it */
+  memset(frame, 0xff, sizeof(frame));
+  NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, JAMMER_CHANNEL);
+
+  while(1) {
+    NETSTACK_RADIO.send(frame, sizeof(frame));
+    PROCESS_PAUSE();
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         TSCH scenario node. Node 1 is the RPL root and TSCH coordinator;
+ *         it sends a numbered datagram to every node it has a route to each
+ *         SEND_INTERVAL and prints its per-channel Tx counters every
+ *         STATS_INTERVAL. The other nodes print what they receive.
+ *         Node LATE_JOINER_ID, if set, only starts TSCH after
+ *         LATE_JOIN_DELAY and prints the hopping sequence length it joined
+ *         with. With WITH_FRAGMENTS, node 1 sends a larger datagram to one
+ *         node at a time instead, and also prints how many bursts it sent.
+ *         With TSCH_ADAPTIVE_GUARD_TIME, node 1 also gets a dedicated Tx link
+ *         to every other node, which print what they learned about the
+ *         clock of node 1. With TSCH_WITH_SIXTOP, node 1 negotiates a
+ *         Tx cell to every other node with 6P instead, and all nodes print
+ *         the cells they have; node SIXTOP_BAD_ID answers with a cell that
+ *         was not offered, which must be refused.
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "node-id.h"
+#include "net/rpl/rpl.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-private.h"
+#include "net/mac/tsch/tsch-slot-operation.h"
+#include "net/mac/tsch/tsch-adaptive-hopping.h"
+#include "net/mac/tsch/tsch-adaptive-timesync.h"
+#include "net/mac/tsch/tsch-sixtop.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define UDP_PORT 4001
+
+#if WITH_FRAGMENTS
+/* Takes three frames, which node 1 may send in a burst */
+#define DATAGRAM_LEN 160
+#define SEND_INTERVAL (CLOCK_SECOND / 2)
+#else /* WITH_FRAGMENTS */
+#define DATAGRAM_LEN sizeof(uint32_t)
+#define SEND_INTERVAL (2 * CLOCK_SECOND)
+#endif /* WITH_FRAGMENTS */
+#define STATS_INTERVAL (30 * CLOCK_SECOND)
+
+/* Give TSCH and RPL time to settle before we start */
+#define START_DELAY (120 * CLOCK_SECOND)
+
+/* Late enough for the coordinator to have switched hopping sequence */
+#ifndef LATE_JOINER_ID
+#define LATE_JOINER_ID 0
+#endif
+#define LATE_JOIN_DELAY (420 * CLOCK_SECOND)
+
+#if TSCH_ADAPTIVE_GUARD_TIME
+/* Node 1 sends to node n at timeslot n - 1 of this slotframe. Adaptive guard
+ * times only narrow Rx links addressed to a neighbor, the minimal schedule
+ * has none */
+#define DEDICATED_SF_HANDLE 1
+#define DEDICATED_SF_LEN 7
+#define DEDICATED_CHANNEL_OFFSET 1
+#endif /* TSCH_ADAPTIVE_GUARD_TIME */
+
+#if TSCH_WITH_SIXTOP
+/* Node 1 offers timeslots 1 to SIXTOP_SF_LEN - 1 of this slotframe, never
+ * timeslot 0, which is what node SIXTOP_BAD_ID answers with */
+#define SIXTOP_SFID 0xf1
+#define SIXTOP_SF_HANDLE 2
+#define SIXTOP_SF_LEN 7
+#define SIXTOP_CHANNEL_OFFSET 2
+#define SIXTOP_NUM_CANDIDATES 3
+#define SIXTOP_MAX_ID 5
+#define SIXTOP_BAD_ID 3
+#endif /* TSCH_WITH_SIXTOP */
+
+static struct uip_udp_conn *conn;
+
+/*---------------------------------------------------------------------------*/
+PROCESS(node_process, "TSCH scenario node");
+AUTOSTART_PROCESSES(&node_process);
+/*---------------------------------------------------------------------------*/
+static void
+tcpip_handler(void)
+{
+  if(uip_newdata() && uip_datalen() == DATAGRAM_LEN) {
+    uint32_t seq;
+    memcpy(&seq, uip_appdata, sizeof(seq));
+    printf("RX %lu\n", (unsigned long)seq);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_to(const uip_ipaddr_t *addr)
+{
+  static uint32_t seq;
+  static uint8_t buf[DATAGRAM_LEN];
+
+  seq++;
+  memcpy(buf, &seq, sizeof(seq));
+  uip_udp_packet_sendto(conn, buf, sizeof(buf), addr, UIP_HTONS(UDP_PORT));
+  printf("TX %lu\n", (unsigned long)seq);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_all(void)
+{
+  uip_ds6_route_t *route;
+#if WITH_FRAGMENTS
+  /* One node at a time, so that its fragments fit in the queue buffers */
+  static int next;
+  int i;
+
+  for(i = 0, route = uip_ds6_route_head(); route != NULL && i < next;
+      i++, route = uip_ds6_route_next(route));
+  if(route == NULL) {
+    route = uip_ds6_route_head();
+    next = 0;
+  }
+  if(route != NULL) {
+    send_to(&route->ipaddr);
+    next++;
+  }
+#else /* WITH_FRAGMENTS */
+  for(route = uip_ds6_route_head(); route != NULL;
+      route = uip_ds6_route_next(route)) {
+    send_to(&route->ipaddr);
+  }
+#endif /* WITH_FRAGMENTS */
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_stats(void)
+{
+  unsigned long tx = 0;
+  unsigned long ok = 0;
+  int c;
+
+  for(c = 0; c < TSCH_ADAPTIVE_HOPPING_MAX_CHANNEL; c++) {
+    const struct tsch_channel_stats *s = tsch_adaptive_hopping_get_stats(c);
+    tx += s->tx_count;
+    ok += s->tx_ok;
+  }
+  printf("Stats tx %lu ok %lu channels %u\n", tx, ok,
+         tsch_hopping_sequence_length.val);
+#if TSCH_BURST_MAX_LEN > 1
+  tx = 0;
+  for(c = 2; c <= TSCH_BURST_MAX_LEN; c++) {
+    tx += tsch_burst_stats_get(1, c);
+  }
+  printf("Bursts tx %lu\n", tx);
+#endif /* TSCH_BURST_MAX_LEN > 1 */
+}
+/*---------------------------------------------------------------------------*/
+#if TSCH_ADAPTIVE_GUARD_TIME || TSCH_WITH_SIXTOP
+static void
+id_to_lladdr(linkaddr_t *addr, uint16_t id)
+{
+  /* As platform/z1 derives it from the node ID */
+  linkaddr_copy(addr, &linkaddr_node_addr);
+  addr->u8[LINKADDR_SIZE - 2] = id >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = id & 0xff;
+}
+#endif /* TSCH_ADAPTIVE_GUARD_TIME || TSCH_WITH_SIXTOP */
+/*---------------------------------------------------------------------------*/
+#if TSCH_ADAPTIVE_GUARD_TIME
+static void
+add_dedicated_links(void)
+{
+  struct tsch_slotframe *sf;
+  linkaddr_t addr;
+  uint16_t id;
+
+  /* Joining the network resets the schedule */
+  if(!tsch_is_associated
+     || tsch_schedule_get_slotframe_by_handle(DEDICATED_SF_HANDLE) != NULL) {
+    return;
+  }
+  sf = tsch_schedule_add_slotframe(DEDICATED_SF_HANDLE, DEDICATED_SF_LEN);
+  if(sf == NULL) {
+    return;
+  }
+  if(node_id == 1) {
+    for(id = 2; id <= DEDICATED_SF_LEN; id++) {
+      id_to_lladdr(&addr, id);
+      tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL, &addr,
+                             id - 1, DEDICATED_CHANNEL_OFFSET);
+    }
+  } else if(node_id <= DEDICATED_SF_LEN) {
+    id_to_lladdr(&addr, 1);
+    tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_NORMAL, &addr,
+                           node_id - 1, DEDICATED_CHANNEL_OFFSET);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_guard_time(void)
+{
+  linkaddr_t addr;
+  struct tsch_neighbor *n;
+
+  id_to_lladdr(&addr, 1);
+  n = tsch_queue_get_nbr(&addr);
+  if(n != NULL) {
+    printf("Guard drift %u level %u\n", n->drift_count, n->guard_level);
+  }
+}
+#endif /* TSCH_ADAPTIVE_GUARD_TIME */
+/*---------------------------------------------------------------------------*/
+#if TSCH_WITH_SIXTOP
+static int
+sixtop_select_cells(const linkaddr_t *peer, uint16_t metadata, uint8_t cell_options,
+                    uint8_t num_cells, const struct tsch_sixtop_cell *candidates,
+                    uint8_t num_candidates, struct tsch_sixtop_cell *selected)
+{
+  struct tsch_slotframe *sf;
+  int i;
+
+  if(node_id == SIXTOP_BAD_ID) {
+    selected[0].timeslot = 0;
+    selected[0].channel_offset = SIXTOP_CHANNEL_OFFSET;
+    return 1;
+  }
+  sf = tsch_schedule_get_slotframe_by_handle(SIXTOP_SF_HANDLE);
+  for(i = 0; i < num_candidates; i++) {
+    if(tsch_schedule_get_link_by_timeslot(sf, candidates[i].timeslot) == NULL) {
+      selected[0] = candidates[i];
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sixtop_response(const linkaddr_t *peer, uint8_t cmd, uint8_t rc,
+                const struct tsch_sixtop_cell *cells, uint8_t num_cells,
+                uint16_t count)
+{
+  printf("6P add to %u rc %u", peer->u8[LINKADDR_SIZE - 1], rc);
+  if(rc == TSCH_SIXTOP_RC_SUCCESS && num_cells > 0) {
+    printf(" cell %u %u", cells[0].timeslot, cells[0].channel_offset);
+  }
+  printf("\n");
+}
+/*---------------------------------------------------------------------------*/
+static const struct tsch_sixtop_sf sixtop_sf = {
+  SIXTOP_SFID,
+  SIXTOP_SF_HANDLE,
+  0,
+  NULL,
+  sixtop_select_cells,
+  sixtop_response,
+};
+/*---------------------------------------------------------------------------*/
+/* Node 1: ask every node without a cell yet for one */
+static void
+sixtop_negotiate(struct tsch_slotframe *sf)
+{
+  struct tsch_sixtop_cell candidates[SIXTOP_NUM_CANDIDATES];
+  struct tsch_link *l;
+  linkaddr_t addr;
+  uint16_t id;
+  uint16_t ts;
+  int num;
+
+  for(id = 2; id <= SIXTOP_MAX_ID; id++) {
+    id_to_lladdr(&addr, id);
+    for(l = tsch_schedule_get_link_next(sf, NULL); l != NULL;
+        l = tsch_schedule_get_link_next(sf, l)) {
+      if(linkaddr_cmp(&l->addr, &addr)) {
+        break;
+      }
+    }
+    if(l != NULL || tsch_sixtop_is_busy(&addr)) {
+      continue;
+    }
+    num = 0;
+    for(ts = 1; ts < SIXTOP_SF_LEN && num < SIXTOP_NUM_CANDIDATES; ts++) {
+      if(tsch_schedule_get_link_by_timeslot(sf, ts) == NULL) {
+        candidates[num].timeslot = ts;
+        candidates[num].channel_offset = SIXTOP_CHANNEL_OFFSET;
+        num++;
+      }
+    }
+    if(num > 0) {
+      tsch_sixtop_request_add(SIXTOP_SFID, &addr, 0, TSCH_SIXTOP_CELL_OPTION_TX,
+                              1, candidates, num);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Create the slotframe once joined, as joining resets the schedule. Node 1
+ * then negotiates its cells, the other nodes print theirs */
+static void
+sixtop_update(void)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *l;
+
+  if(!tsch_is_associated) {
+    return;
+  }
+  sf = tsch_schedule_get_slotframe_by_handle(SIXTOP_SF_HANDLE);
+  if(sf == NULL) {
+    sf = tsch_schedule_add_slotframe(SIXTOP_SF_HANDLE, SIXTOP_SF_LEN);
+    if(sf == NULL) {
+      return;
+    }
+  }
+  if(node_id == 1) {
+    sixtop_negotiate(sf);
+  } else {
+    for(l = tsch_schedule_get_link_next(sf, NULL); l != NULL;
+        l = tsch_schedule_get_link_next(sf, l)) {
+      printf("6P rx %u %u\n", l->timeslot, l->channel_offset);
+    }
+  }
+}
+#endif /* TSCH_WITH_SIXTOP */
+/*---------------------------------------------------------------------------*/
+static void
+rpl_root_init(void)
+{
+  uip_ipaddr_t prefix;
+  uip_ipaddr_t ipaddr;
+
+  /* Will be set as TSCH pan coordinator via the tsch-rpl module */
+  uip_ip6addr(&prefix, 0xaaaa, 0, 0, 0, 0, 0, 0, 0);
+  uip_ipaddr_copy(&ipaddr, &prefix);
+  uip_ds6_set_addr_iid(&ipaddr, &uip_lladdr);
+  uip_ds6_addr_add(&ipaddr, 0, ADDR_AUTOCONF);
+  rpl_set_root(RPL_DEFAULT_INSTANCE, &ipaddr);
+  rpl_set_prefix(rpl_get_any_dag(), &prefix, 64);
+  rpl_repair_root(RPL_DEFAULT_INSTANCE);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(node_process, ev, data)
+{
+  static struct etimer send_timer;
+  static struct etimer stats_timer;
+
+  PROCESS_BEGIN();
+
+  conn = udp_new(NULL, UIP_HTONS(UDP_PORT), NULL);
+  udp_bind(conn, UIP_HTONS(UDP_PORT));
+
+  if(node_id == 1) {
+    rpl_root_init();
+  }
+#if TSCH_WITH_SIXTOP
+  tsch_sixtop_add_sf(&sixtop_sf);
+#endif /* TSCH_WITH_SIXTOP */
+  if(node_id == LATE_JOINER_ID) {
+    etimer_set(&send_timer, LATE_JOIN_DELAY);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&send_timer));
+  }
+  NETSTACK_MAC.on();
+
+  if(node_id != 1) {
+    if(node_id == LATE_JOINER_ID) {
+      while(!tsch_is_associated) {
+        etimer_set(&send_timer, CLOCK_SECOND);
+        PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&send_timer));
+      }
+      printf("Joined channels %u\n", tsch_hopping_sequence_length.val);
+    }
+#if TSCH_ADAPTIVE_GUARD_TIME || TSCH_WITH_SIXTOP
+    etimer_set(&stats_timer, STATS_INTERVAL);
+#endif /* TSCH_ADAPTIVE_GUARD_TIME || TSCH_WITH_SIXTOP */
+    while(1) {
+      PROCESS_YIELD();
+      if(ev == tcpip_event) {
+        tcpip_handler();
+      }
+#if TSCH_ADAPTIVE_GUARD_TIME || TSCH_WITH_SIXTOP
+      if(etimer_expired(&stats_timer)) {
+#if TSCH_ADAPTIVE_GUARD_TIME
+        add_dedicated_links();
+        print_guard_time();
+#endif /* TSCH_ADAPTIVE_GUARD_TIME */
+#if TSCH_WITH_SIXTOP
+        sixtop_update();
+#endif /* TSCH_WITH_SIXTOP */
+        etimer_reset(&stats_timer);
+      }
+#endif /* TSCH_ADAPTIVE_GUARD_TIME || TSCH_WITH_SIXTOP */
+    }
+  }
+
+  etimer_set(&send_timer, START_DELAY);
+  etimer_set(&stats_timer, STATS_INTERVAL);
+  while(1) {
+    PROCESS_YIELD();
+    if(etimer_expired(&send_timer)) {
+      send_all();
+      etimer_set(&send_timer, SEND_INTERVAL);
+    }
+    if(etimer_expired(&stats_timer)) {
+#if TSCH_ADAPTIVE_GUARD_TIME
+      add_dedicated_links();
+#endif /* TSCH_ADAPTIVE_GUARD_TIME */
+#if TSCH_WITH_SIXTOP
+      sixtop_update();
+#endif /* TSCH_WITH_SIXTOP */
+      print_stats();
+      etimer_reset(&stats_timer);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *	Regression test for the Antelope query planner and the memhash
+ *	index. Equality queries over an attribute with duplicate keys
+ *	must return the same tuples whether the planner uses the index or
+ *	falls back to a scan, also when the hash table overflows. Range
+ *	queries over a time-series index must also work when the range
+ *	holds no tuple.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+
+#include "antelope.h"
+#include "index.h"
+#include "relation.h"
+
+PROCESS(test_index_process, "Antelope index test");
+AUTOSTART_PROCESSES(&test_index_process);
+
+static unsigned failures;
+
+static db_result_t
+create_relation(const char *name, unsigned tuples, int index_first)
+{
+  unsigned i;
+
+  db_query(NULL, "REMOVE RELATION %s;", name);
+  if(DB_ERROR(db_query(NULL, "CREATE RELATION %s;", name)) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE a DOMAIN INT IN %s;", name)) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE b DOMAIN INT IN %s;", name))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  if(index_first &&
+     DB_ERROR(db_query(NULL, "CREATE INDEX %s.a TYPE MEMHASH;", name))) {
+    return DB_INDEX_ERROR;
+  }
+
+  for(i = 0; i < tuples; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%u, %u) INTO %s;", i % 5, i, name))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  if(!index_first &&
+     DB_ERROR(db_query(NULL, "CREATE INDEX %s.a TYPE MEMHASH;", name))) {
+    return DB_INDEX_ERROR;
+  }
+
+  return db_flush();
+}
+
+static db_result_t
+create_series(const char *name, unsigned tuples)
+{
+  unsigned i;
+
+  db_query(NULL, "REMOVE RELATION %s;", name);
+  if(DB_ERROR(db_query(NULL, "CREATE RELATION %s;", name)) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE t DOMAIN INT IN %s;", name)) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE v DOMAIN INT IN %s;", name))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  if(DB_ERROR(db_query(NULL, "CREATE INDEX %s.t TYPE TIMESERIES;", name))) {
+    return DB_INDEX_ERROR;
+  }
+
+  /* Keys 0, 10, 20, ... */
+  for(i = 0; i < tuples; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%u, %u) INTO %s;",
+                         i * 10, i, name))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  return db_flush();
+}
+
+/* Run a query and check the number of rows and the access method. */
+static void
+check_query(const char *query, unsigned expected_rows,
+            db_plan_method_t expected_method)
+{
+  static db_handle_t handle;
+  db_plan_method_t method;
+  db_result_t result;
+  unsigned rows;
+
+  result = db_query(&handle, query);
+  if(DB_ERROR(result)) {
+    printf("FAILED: \"%s\": %s\n", query, db_get_result_message(result));
+    failures++;
+    return;
+  }
+
+  method = handle.plan.method;
+  rows = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      rows++;
+    } else if(result == DB_FINISHED) {
+      break;
+    } else if(DB_ERROR(result)) {
+      printf("FAILED: \"%s\": %s\n", query, db_get_result_message(result));
+      failures++;
+      db_free(&handle);
+      return;
+    }
+  }
+  db_free(&handle);
+
+  if(rows != expected_rows || method != expected_method) {
+    printf("FAILED: \"%s\": %u rows, plan %d (expected %u rows, plan %d)\n",
+           query, rows, (int)method, expected_rows, (int)expected_method);
+    failures++;
+  } else {
+    printf("OK: \"%s\": %u rows\n", query, rows);
+  }
+}
+
+PROCESS_THREAD(test_index_process, ev, data)
+{
+  static relation_t *rel;
+  static attribute_t *attr;
+
+  PROCESS_BEGIN();
+
+  db_init();
+
+  /* Fewer tuples than hash table slots, but each key is repeated. */
+  if(DB_ERROR(create_relation("dup", 40, 1))) {
+    printf("FAILED: could not create relation dup\n");
+    failures++;
+  } else {
+    check_query("SELECT a, b FROM dup WHERE a = 3 AND b < 30;",
+                6, DB_PLAN_INDEX);
+    check_query("SELECT a, b FROM dup WHERE a = 3;", 8, DB_PLAN_INDEX);
+    check_query("SELECT a, b FROM dup WHERE a = 7;", 0, DB_PLAN_INDEX);
+    check_query("SELECT a, b FROM dup WHERE b < 30;", 30, DB_PLAN_SCAN);
+  }
+  /* Removing the relation releases its index, so that the next relation
+     can get one of the DB_MEMHASH_INDEX_LIMIT hash tables. */
+  db_query(NULL, "REMOVE RELATION dup;");
+
+  /* An index created over existing tuples is loaded in the background. */
+  if(DB_ERROR(create_relation("late", 40, 0))) {
+    printf("FAILED: could not create relation late\n");
+    failures++;
+  } else {
+    rel = relation_load("late");
+    attr = rel == NULL ? NULL : relation_attribute_get(rel, "a");
+    while(attr != NULL && attr->index != NULL && !index_exists(attr)) {
+      PROCESS_PAUSE();
+    }
+    check_query("SELECT a, b FROM late WHERE a = 3 AND b < 30;",
+                6, DB_PLAN_INDEX);
+    if(rel != NULL) {
+      relation_release(rel);
+    }
+  }
+  db_query(NULL, "REMOVE RELATION late;");
+
+  /* More tuples than hash table slots: the index cannot hold all of
+     them, so the planner must not use it. */
+  if(DB_ERROR(create_relation("full", 200, 1))) {
+    printf("FAILED: could not create relation full\n");
+    failures++;
+  } else {
+    check_query("SELECT a, b FROM full WHERE a = 3 AND b < 30;",
+                6, DB_PLAN_SCAN);
+    check_query("SELECT a, b FROM full WHERE a = 3;", 40, DB_PLAN_SCAN);
+  }
+
+  db_query(NULL, "REMOVE RELATION full;");
+
+  /* Ranges that fall between two keys or after the last one are empty,
+     which is not an index error. */
+  if(DB_ERROR(create_series("series", 80))) {
+    printf("FAILED: could not create relation series\n");
+    failures++;
+  } else {
+    check_query("SELECT t, v FROM series WHERE t > 95 AND t < 205;",
+                11, DB_PLAN_INDEX);
+    check_query("SELECT t, v FROM series WHERE t > 101 AND t < 109;",
+                0, DB_PLAN_INDEX);
+    check_query("SELECT t, v FROM series WHERE t > 5000 AND t < 6000;",
+                0, DB_PLAN_INDEX);
+  }
+  db_query(NULL, "REMOVE RELATION series;");
+
+  printf("Antelope index test finished with %u failures\n", failures);
+
+  PROCESS_END();
+}
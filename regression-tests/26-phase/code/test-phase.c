@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *	Regression test for the saved ContikiMAC phases. phase_wait() runs
+ *	with ContikiMAC's cycle time, and a stub RDC stands in for
+ *	ContikiMAC when a transmission is deferred. The first boot learns
+ *	the phases of a few neighbors, checks that they are waited for,
+ *	lets the periodic snapshot save them and reboots. The rtimer of
+ *	the Sky restarts at boot, so the second boot checks that restored
+ *	phases only start a full-length strobe until an ACK confirms them.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "dev/watchdog.h"
+#include "net/mac/mac.h"
+#include "net/mac/phase.h"
+
+#define NEIGHBORS       3
+#define MARKER_FILENAME "phase-test"
+
+/* ContikiMAC's cycle time, and about its guard time */
+#define TEST_CYCLE_TIME (RTIMER_ARCH_SECOND / NETSTACK_RDC_CHANNEL_CHECK_RATE)
+#define TEST_GUARD_TIME (RTIMER_ARCH_SECOND / 160)
+
+PROCESS(test_phase_process, "Phase persistence test");
+AUTOSTART_PROCESSES(&test_phase_process);
+
+static unsigned failures;
+
+/* The neighbor being sent to, and the outcome of a deferred send */
+static linkaddr_t pending;
+static struct rdc_buf_list pending_list;
+static phase_status_t deferred_status;
+/* When phase_wait() last returned */
+static rtimer_clock_t sent_at;
+/*---------------------------------------------------------------------------*/
+static void
+check(int ok, const char *what)
+{
+  if(!ok) {
+    failures++;
+  }
+  printf("%s: %s\n", ok ? "OK" : "FAILED", what);
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor(linkaddr_t *addr, int i)
+{
+  linkaddr_copy(addr, &linkaddr_null);
+  addr->u8[0] = 100 + i;
+}
+/*---------------------------------------------------------------------------*/
+static phase_status_t
+wait_for_phase(void)
+{
+  phase_status_t status;
+
+  status = phase_wait(&pending, TEST_CYCLE_TIME, TEST_GUARD_TIME,
+                      NULL, NULL, &pending_list);
+  sent_at = RTIMER_NOW();
+  return status;
+}
+/*---------------------------------------------------------------------------*/
+/* Whether sent_at is within the guard time before a wake-up of the
+   neighbor. The phase must be in the past. */
+static int
+is_before_phase(rtimer_clock_t phase)
+{
+  return (rtimer_clock_t)(sent_at - phase) % TEST_CYCLE_TIME >=
+    TEST_CYCLE_TIME - TEST_GUARD_TIME;
+}
+/*---------------------------------------------------------------------------*/
+/* The stub RDC: like ContikiMAC, it asks phase_wait() again when the
+   deferred list is sent */
+static void
+stub_init(void)
+{
+  phase_init();
+}
+static void
+stub_send(mac_callback_t sent, void *ptr)
+{
+  mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
+}
+static void
+stub_send_list(mac_callback_t sent, void *ptr, struct rdc_buf_list *list)
+{
+  phase_status_t status;
+
+  status = wait_for_phase();
+  if(status != PHASE_DEFERRED) {
+    deferred_status = status;
+    process_poll(&test_phase_process);
+  }
+}
+static void
+stub_input(void)
+{
+}
+static int
+stub_on(void)
+{
+  return 1;
+}
+static int
+stub_off(int keep_radio_on)
+{
+  return 1;
+}
+static unsigned short
+stub_channel_check_interval(void)
+{
+  return CLOCK_SECOND / NETSTACK_RDC_CHANNEL_CHECK_RATE;
+}
+const struct rdc_driver phase_test_rdc_driver = {
+  "phase-test",
+  stub_init,
+  stub_send,
+  stub_send_list,
+  stub_input,
+  stub_on,
+  stub_off,
+  stub_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+/* Calls phase_wait() for addr and waits for the deferred send, if any */
+#define WAIT_FOR(addr, status) do {                             \
+    linkaddr_copy(&pending, (addr));                            \
+    (status) = wait_for_phase();                                \
+    if((status) == PHASE_DEFERRED) {                            \
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);       \
+      (status) = deferred_status;                               \
+    }                                                           \
+  } while(0)
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_phase_process, ev, data)
+{
+  static struct etimer et;
+  static rtimer_clock_t phases[NEIGHBORS];
+  static phase_status_t status;
+  static linkaddr_t addr;
+  static int i;
+  int fd;
+
+  PROCESS_BEGIN();
+
+  etimer_set(&et, CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  fd = cfs_open(MARKER_FILENAME, CFS_READ);
+  if(fd < 0) {
+    for(i = 0; i < NEIGHBORS; i++) {
+      neighbor(&addr, i);
+      phases[i] = RTIMER_NOW() - i * (TEST_CYCLE_TIME / NEIGHBORS);
+      phase_update(&addr, phases[i], MAC_TX_OK);
+    }
+    for(i = 0; i < NEIGHBORS; i++) {
+      neighbor(&addr, i);
+      WAIT_FOR(&addr, status);
+      check(status == PHASE_SEND_NOW, "learned phase");
+      check(is_before_phase(phases[i]), "learned phase waited for");
+    }
+    neighbor(&addr, NEIGHBORS);
+    WAIT_FOR(&addr, status);
+    check(status == PHASE_UNKNOWN, "unknown neighbor");
+
+    fd = cfs_open(MARKER_FILENAME, CFS_WRITE);
+    check(fd >= 0, "marker written");
+    cfs_close(fd);
+
+    /* Let the periodic snapshot save the phases */
+    etimer_set(&et, PHASE_SNAPSHOT_INTERVAL + CLOCK_SECOND);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+    printf("Rebooting with %u failures\n", failures);
+    watchdog_reboot();
+  }
+  cfs_close(fd);
+  cfs_remove(MARKER_FILENAME);
+
+  for(i = 0; i < NEIGHBORS; i++) {
+    neighbor(&addr, i);
+    WAIT_FOR(&addr, status);
+    check(status == PHASE_UNKNOWN, "restored phase strobed for a full cycle");
+  }
+  neighbor(&addr, NEIGHBORS);
+  WAIT_FOR(&addr, status);
+  check(status == PHASE_UNKNOWN, "unknown neighbor after reboot");
+
+  neighbor(&addr, 0);
+  phases[0] = RTIMER_NOW();
+  phase_update(&addr, phases[0], MAC_TX_OK);
+  WAIT_FOR(&addr, status);
+  check(status == PHASE_SEND_NOW, "confirmed phase");
+  check(is_before_phase(phases[0]), "confirmed phase waited for");
+
+  printf("Phase test finished with %u failures\n", failures);
+
+  PROCESS_END();
+}
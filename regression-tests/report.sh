@@ -0,0 +1,9 @@
+#!/bin/bash
+# Print the REPORT lines logged by the test scripts of the given
+# simulations, without the prefix, so that the scenarios of a test
+# directory can be compared side by side. Missing logs are skipped.
+#
+# Usage: report.sh TESTLOG...
+
+grep -h -s '^REPORT' "$@" | sed -e 's/^REPORT //'
+exit 0
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Host-side decoder for binary TSCH logs (TSCH_LOG_CONF_BINARY).
+ *         Reads a serial capture on stdin or from a file, prints the text
+ *         between frames unchanged and turns every binary record back into
+ *         the usual "TSCH: {asn-...}" line, or into CSV with -c. Gaps in
+ *         the sequence numbers are reported as dropped logs.
+ *
+ *         Example: serialdump-linux -b115200 /dev/ttyUSB0 | tsch-log-decode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define SLIP_END     0300
+#define SLIP_ESC     0333
+#define SLIP_ESC_END 0334
+#define SLIP_ESC_ESC 0335
+
+/* Must match core/net/mac/tsch/tsch-log.h */
+#define TSCH_LOG_BINARY_MAGIC 0xa5
+#define TSCH_LOG_BINARY_HEADER_LEN 17
+#define LOG_TX      0
+#define LOG_RX      1
+#define LOG_MESSAGE 2
+#define LOG_TX_LEN  (TSCH_LOG_BINARY_HEADER_LEN + 10)
+#define LOG_RX_LEN  (TSCH_LOG_BINARY_HEADER_LEN + 11)
+#define LOG_MESSAGE_MAX_LEN (TSCH_LOG_BINARY_HEADER_LEN + 48)
+
+static int csv;
+static int have_seqno;
+static uint16_t next_seqno;
+static unsigned long records, dropped, bad;
+
+/*---------------------------------------------------------------------------*/
+static unsigned
+get16(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8);
+}
+/*---------------------------------------------------------------------------*/
+static int
+sget16(const uint8_t *p)
+{
+  return (int16_t)get16(p);
+}
+/*---------------------------------------------------------------------------*/
+/* Decode one unescaped frame. Returns 0 if it is not a TSCH log record. */
+static int
+decode(const uint8_t *buf, int len)
+{
+  const uint8_t *b = buf + TSCH_LOG_BINARY_HEADER_LEN;
+  unsigned seqno;
+  unsigned long ls4b;
+
+  if(len < TSCH_LOG_BINARY_HEADER_LEN || buf[0] != TSCH_LOG_BINARY_MAGIC) {
+    return 0;
+  }
+  if((buf[1] == LOG_TX && len != LOG_TX_LEN)
+     || (buf[1] == LOG_RX && len != LOG_RX_LEN)
+     || (buf[1] == LOG_MESSAGE && len > LOG_MESSAGE_MAX_LEN)
+     || buf[1] > LOG_MESSAGE) {
+    return 0;
+  }
+
+  seqno = get16(&buf[2]);
+  if(have_seqno && seqno != next_seqno) {
+    unsigned gap = (uint16_t)(seqno - next_seqno);
+    dropped += gap;
+    if(csv) {
+      fprintf(stderr, "logs dropped %u before seqno %u\n", gap, seqno);
+    } else {
+      printf("TSCH:! logs dropped %u\n", gap);
+    }
+  }
+  have_seqno = 1;
+  next_seqno = seqno + 1;
+  records++;
+
+  ls4b = get16(&buf[4]) | ((unsigned long)get16(&buf[6]) << 16);
+
+  if(csv) {
+    printf("%u,%u,%u,%lu,%u,%u,%u,%u,%u,", seqno, buf[1], buf[8], ls4b,
+           buf[9], get16(&buf[10]), get16(&buf[12]), get16(&buf[14]), buf[16]);
+    switch(buf[1]) {
+    case LOG_TX:
+      printf("%u,%u,%u,%d,%u,%u,%u,%u,%u,,\n", b[0], get16(&b[1]),
+             get16(&b[1]) != 0, sget16(&b[3]), b[5], b[6], b[7], b[8], b[9]);
+      break;
+    case LOG_RX:
+      printf(",%u,%u,%d,,%u,%u,%u,%u,%d,\n", get16(&b[0]), b[7],
+             sget16(&b[2]), b[6], b[8], b[9], b[10], sget16(&b[4]));
+      break;
+    case LOG_MESSAGE:
+      printf(",,,,,,,,,,\"%.*s\"\n", len - TSCH_LOG_BINARY_HEADER_LEN, (const char *)b);
+      break;
+    }
+    return 1;
+  }
+
+  printf("TSCH: {asn-%x.%lx link-%u-%u-%u-%u ch-%u} ",
+         buf[8], ls4b, buf[9], get16(&buf[10]), get16(&buf[12]),
+         get16(&buf[14]), buf[16]);
+  switch(buf[1]) {
+  case LOG_TX:
+    printf("%s-%u-%u %u tx %u, st %u-%u",
+           get16(&b[1]) == 0 ? "bc" : "uc", b[7], b[8], b[6],
+           get16(&b[1]), b[0], b[5]);
+    if(b[9]) {
+      printf(", dr %d", sget16(&b[3]));
+    }
+    printf("\n");
+    break;
+  case LOG_RX:
+    printf("%s-%u-%u %u rx %u",
+           b[7] == 0 ? "bc" : "uc", b[8], b[9], b[6], get16(&b[0]));
+    if(b[10]) {
+      printf(", dr %d", sget16(&b[2]));
+    }
+    printf(", edr %d\n", sget16(&b[4]));
+    break;
+  case LOG_MESSAGE:
+    printf("%.*s\n", len - TSCH_LOG_BINARY_HEADER_LEN, (const char *)b);
+    break;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+  FILE *in = stdin;
+  uint8_t buf[LOG_MESSAGE_MAX_LEN];
+  int len = 0;
+  int in_frame = 0;
+  int esc = 0;
+  int c;
+
+  while((c = getopt(argc, argv, "ch")) != -1) {
+    switch(c) {
+    case 'c':
+      csv = 1;
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-c] [capture-file]\n", argv[0]);
+      fprintf(stderr, "  -c  print records as CSV instead of tsch-log text\n");
+      exit(c == 'h' ? 0 : 1);
+    }
+  }
+  if(optind < argc) {
+    in = fopen(argv[optind], "rb");
+    if(in == NULL) {
+      perror(argv[optind]);
+      exit(1);
+    }
+  }
+  if(csv) {
+    printf("seqno,type,asn_ms1b,asn_ls4b,sf_handle,sf_size,timeslot,"
+           "channel_offset,channel,status,addr,unicast,drift,num_tx,datalen,"
+           "is_data,sec_level,drift_used,edr,message\n");
+  }
+
+  while((c = getc(in)) != EOF) {
+    if(c == SLIP_END) {
+      if(in_frame && len > 0) {
+        if(decode(buf, len)) {
+          in_frame = 0;
+        } else {
+          /* Not a record: we started in the middle of a frame, or this
+             was text. Pass it on and take this END as a frame start. */
+          bad++;
+          if(!csv) {
+            fwrite(buf, 1, len, stdout);
+          }
+        }
+      } else {
+        in_frame = 1;
+      }
+      len = 0;
+      esc = 0;
+    } else if(!in_frame) {
+      if(!csv) {
+        putchar(c);
+      }
+    } else if(len == sizeof(buf)) {
+      /* Too long for a record; flush as text and resynchronize */
+      bad++;
+      if(!csv) {
+        fwrite(buf, 1, len, stdout);
+      }
+      in_frame = 0;
+      len = 0;
+    } else if(esc) {
+      buf[len++] = c == SLIP_ESC_END ? SLIP_END : (c == SLIP_ESC_ESC ? SLIP_ESC : c);
+      esc = 0;
+    } else if(c == SLIP_ESC) {
+      esc = 1;
+    } else {
+      buf[len++] = c;
+    }
+    if(!in_frame) {
+      fflush(stdout);
+    }
+  }
+
+  fprintf(stderr, "%lu records, %lu dropped, %lu bad frames\n",
+          records, dropped, bad);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/